@@ -0,0 +1,209 @@
+// BinaryRoadMapFormat.hpp
+//
+// ICS 46 Spring 2016
+// Project #4: Rock and Roll Stops the Traffic
+//
+// This header describes the binary road map format written by a
+// BinaryRoadMapWriter and read by a BinaryRoadMapReader.  It lays out a
+// CompactRoadMap exactly the way CompactDigraph keeps it in memory, so a
+// reader can map the file into memory and use most of it in place.
+//
+// A file begins with a BinaryRoadMapHeader, which is followed by the
+// sections it lists.  Each section is a flat array of fixed-size values,
+// in the byte order of the machine that wrote the file, starting at an
+// offset that's a multiple of BinaryRoadMapAlignment.  Along with the
+// counts of vertices and edges, the header holds the detour factor and
+// highest speed that scale a RoadNetwork's GoalBounds, so that, with the
+// weights and GeoPoints saved in the sections, a RoadNetwork can be loaded
+// without recomputing anything (see RoadNetworkArrays in RoadNetwork.hpp).
+// It also holds the scales of each TripMetric's landmark bounds, which are
+// below 1 if an edge was made lighter since the landmark tables were built
+// (see RoadNetwork::updateSegment()).
+//
+// The sections come in this order, the order BinaryRoadMapSection numbers
+// them.  First is the road map itself:
+//
+// * VertexNumbers: one int32 per vertex, giving its vertex number
+// * NameOffsets: one uint64 per vertex plus one more, where the name of
+//   the vertex with index i occupies bytes NameOffsets[i] through
+//   NameOffsets[i + 1] - 1 of NameBytes
+// * NameBytes: the vertex names, back to back, with no terminators
+// * Coordinates: two doubles per vertex, its latitude and longitude, both
+//   NaN if the vertex has no coordinates
+// * EdgeOffsets: one int32 per vertex plus one more (see CompactDigraph)
+// * EdgeTargets: one int32 per edge, giving the index of its "to" vertex
+// * RoadSegments: one RoadSegment (two doubles) per edge
+//
+// Next is what a RoadNetwork computes from the road map:
+//
+// * DistanceWeights and TimeWeights: one double per edge, giving its
+//   weight for that TripMetric
+// * InEdgeOffsets: one int32 per vertex plus one more, and InEdgeSources
+//   and InEdgePositions: one int32 per edge each, which together are the
+//   reversed layout of the incoming edges (see CompactDigraph)
+// * GeoPoints: one GeoPoint (three doubles) per vertex, or none at all if
+//   any vertex has no coordinates
+//
+// Next are five sections for each TripMetric's contraction hierarchy (see
+// ContractionHierarchy.hpp), first for Distance and then for Time:
+//
+// * Ranks: one int32 per vertex, giving its rank
+// * ForwardOffsets: one int32 per vertex plus one more, laid out like
+//   EdgeOffsets, into ForwardArcs
+// * ForwardArcs: one HierarchyArc (two int32s and a double) per arc
+// * BackwardOffsets and BackwardArcs: the same, for the backward arcs
+//
+// Next are three sections for each TripMetric's landmark table (see
+// LandmarkTable.hpp), again first for Distance and then for Time:
+//
+// * Landmarks: one int32 per landmark, giving its index
+// * FromLandmarks: one double per landmark per vertex, giving the distance
+//   from each landmark to the vertex, in one row per vertex
+// * ToLandmarks: the same, giving the distance from the vertex to each
+//   landmark
+//
+// Finally, there are eight sections for each TripMetric's hub labels (see
+// HubLabels.hpp), again first for Distance and then for Time:
+//
+// * ForwardLabelOffsets: one uint64 per vertex plus one more, where the
+//   forward label of the vertex with index i has the entries
+//   ForwardLabelOffsets[i] through ForwardLabelOffsets[i + 1] - 1 of
+//   ForwardDistances
+// * ForwardHubOffsets: one uint64 per vertex plus one more, laid out the
+//   same way, into ForwardHubBytes
+// * ForwardHubBytes: the labels' hubs, encoded as HubLabels encodes them
+// * ForwardDistances: one double per entry
+// * BackwardLabelOffsets, BackwardHubOffsets, BackwardHubBytes and
+//   BackwardDistances: the same, for the backward labels
+//
+// The hierarchy, landmark table and hub label sections are all empty if
+// the file has no hierarchies, landmark tables or hub labels respectively.
+//
+// The version is increased whenever the layout changes; a reader rejects
+// any version other than the one it was built for, rather than guessing.
+
+#ifndef BINARYROADMAPFORMAT_HPP
+#define BINARYROADMAPFORMAT_HPP
+
+#include <cstdint>
+#include <type_traits>
+#include "ContractionHierarchy.hpp"
+#include "Location.hpp"
+#include "RoadSegment.hpp"
+
+
+
+static_assert(
+    std::is_trivially_copyable<RoadSegment>::value && sizeof(RoadSegment) == 16,
+    "RoadSegments are stored in binary road maps as two packed doubles");
+
+static_assert(
+    std::is_trivially_copyable<HierarchyArc>::value && sizeof(HierarchyArc) == 16,
+    "HierarchyArcs are stored in binary road maps as two int32s and a double");
+
+static_assert(
+    std::is_trivially_copyable<GeoPoint>::value && sizeof(GeoPoint) == 24,
+    "GeoPoints are stored in binary road maps as three packed doubles");
+
+static_assert(
+    sizeof(int) == 4,
+    "vertex numbers and indexes are stored in binary road maps as int32s");
+
+
+
+enum class BinaryRoadMapSection : int
+{
+    VertexNumbers,
+    NameOffsets,
+    NameBytes,
+    Coordinates,
+    EdgeOffsets,
+    EdgeTargets,
+    RoadSegments,
+    DistanceWeights,
+    TimeWeights,
+    InEdgeOffsets,
+    InEdgeSources,
+    InEdgePositions,
+    GeoPoints,
+    DistanceRanks,
+    DistanceForwardOffsets,
+    DistanceForwardArcs,
+    DistanceBackwardOffsets,
+    DistanceBackwardArcs,
+    TimeRanks,
+    TimeForwardOffsets,
+    TimeForwardArcs,
+    TimeBackwardOffsets,
+    TimeBackwardArcs,
+    DistanceLandmarks,
+    DistanceFromLandmarks,
+    DistanceToLandmarks,
+    TimeLandmarks,
+    TimeFromLandmarks,
+    TimeToLandmarks,
+    DistanceForwardLabelOffsets,
+    DistanceForwardHubOffsets,
+    DistanceForwardHubBytes,
+    DistanceForwardDistances,
+    DistanceBackwardLabelOffsets,
+    DistanceBackwardHubOffsets,
+    DistanceBackwardHubBytes,
+    DistanceBackwardDistances,
+    TimeForwardLabelOffsets,
+    TimeForwardHubOffsets,
+    TimeForwardHubBytes,
+    TimeForwardDistances,
+    TimeBackwardLabelOffsets,
+    TimeBackwardHubOffsets,
+    TimeBackwardHubBytes,
+    TimeBackwardDistances,
+    Count
+};
+
+
+struct BinaryRoadMapSectionEntry
+{
+    std::uint64_t offset;
+    std::uint64_t size;
+};
+
+
+struct BinaryRoadMapHeader
+{
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byteOrderMark;
+    std::uint64_t vertexCount;
+    std::uint64_t edgeCount;
+    double detourFactor;
+    double maxMilesPerHour;
+    double distanceLandmarkScale;
+    double timeLandmarkScale;
+    BinaryRoadMapSectionEntry sections[static_cast<int>(BinaryRoadMapSection::Count)];
+};
+
+
+
+// The magic bytes every binary road map begins with.
+constexpr char BinaryRoadMapMagic[8] = {'R', 'O', 'A', 'D', 'C', 'S', 'R', '\0'};
+
+// The current version of the format.  Version 1 had no Coordinates,
+// version 2 had no hierarchies, version 3 had no landmark tables,
+// version 4 had no hub labels, version 5 had no weights, incoming edges
+// or GeoPoints, and version 6 had no landmark scales.
+constexpr std::uint32_t BinaryRoadMapVersion = 7;
+
+// A value written in the writer's byte order, so a reader on a machine
+// with a different byte order can recognize the file as foreign.
+constexpr std::uint32_t BinaryRoadMapByteOrderMark = 0x01020304;
+
+// Every section begins at a multiple of this many bytes, which keeps the
+// arrays aligned for their element types and starts each on a new cache
+// line.
+constexpr std::uint64_t BinaryRoadMapAlignment = 64;
+
+
+
+#endif // BINARYROADMAPFORMAT_HPP
+
@@ -0,0 +1,400 @@
+// BinaryRoadMapReader.cpp
+//
+// ICS 46 Spring 2016
+// Project #4: Rock and Roll Stops the Traffic
+
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "BinaryRoadMapFormat.hpp"
+#include "BinaryRoadMapReader.hpp"
+#include "InputException.hpp"
+
+
+namespace
+{
+    InputException corrupt(const std::string& reason)
+    {
+        return InputException{"corrupt binary road map: " + reason};
+    }
+
+
+    // readHeader() checks that the given file is a binary road map of the
+    // current version, written in this machine's byte order, and returns
+    // its header, which is read in place since the mapping is page-aligned.
+    const BinaryRoadMapHeader& readHeader(const MappedFile& file)
+    {
+        if (!BinaryRoadMapReader::isBinaryRoadMap(file) || file.size() < sizeof(BinaryRoadMapHeader))
+        {
+            throw InputException{"not a binary road map"};
+        }
+
+        const BinaryRoadMapHeader& header =
+            *reinterpret_cast<const BinaryRoadMapHeader*>(file.begin());
+
+        if (header.byteOrderMark != BinaryRoadMapByteOrderMark)
+        {
+            throw InputException{"binary road map was written with a different byte order"};
+        }
+
+        if (header.version != BinaryRoadMapVersion)
+        {
+            throw InputException{
+                "binary road map has version " + std::to_string(header.version)
+                + ", but only version " + std::to_string(BinaryRoadMapVersion)
+                + " is supported"};
+        }
+
+        if (header.vertexCount >= INT_MAX || header.edgeCount >= INT_MAX)
+        {
+            throw corrupt("too many vertices or edges");
+        }
+
+        return header;
+    }
+
+
+    // borrowSection() checks that the given section lies within the file
+    // and holds exactly count elements of type T, then returns a
+    // SharedArray borrowing them from the file.
+    template <typename T>
+    SharedArray<T> borrowSection(
+        const std::shared_ptr<const MappedFile>& file,
+        const BinaryRoadMapHeader& header, BinaryRoadMapSection section,
+        std::uint64_t count)
+    {
+        const BinaryRoadMapSectionEntry& entry = header.sections[static_cast<int>(section)];
+
+        if (entry.offset % BinaryRoadMapAlignment != 0
+            || entry.offset > file->size()
+            || entry.size > file->size() - entry.offset)
+        {
+            throw corrupt("section out of bounds");
+        }
+
+        if (entry.size != count * sizeof(T))
+        {
+            throw corrupt("section has the wrong size");
+        }
+
+        return SharedArray<T>{
+            reinterpret_cast<const T*>(file->begin() + entry.offset),
+            static_cast<std::size_t>(count), file};
+    }
+
+
+    // readGraph() returns the CompactRoadMap in the given file, borrowing
+    // all but its Locations, which are given their names only if withNames
+    // is true.
+    CompactRoadMap readGraph(
+        const std::shared_ptr<const MappedFile>& file,
+        const BinaryRoadMapHeader& header, bool withNames)
+    {
+        std::uint64_t vertexCount = header.vertexCount;
+        std::uint64_t edgeCount = header.edgeCount;
+
+        SharedArray<std::uint64_t> nameOffsets = borrowSection<std::uint64_t>(
+            file, header, BinaryRoadMapSection::NameOffsets, vertexCount + 1);
+
+        SharedArray<char> nameBytes = borrowSection<char>(
+            file, header, BinaryRoadMapSection::NameBytes, nameOffsets.back());
+
+        SharedArray<double> coordinates = borrowSection<double>(
+            file, header, BinaryRoadMapSection::Coordinates, vertexCount * 2);
+
+        std::vector<Location> locations;
+        locations.reserve(vertexCount);
+
+        for (std::uint64_t i = 0; i < vertexCount; ++i)
+        {
+            std::string name;
+
+            if (withNames)
+            {
+                if (nameOffsets[i + 1] < nameOffsets[i] || nameOffsets[i + 1] > nameBytes.size())
+                {
+                    throw corrupt("name offsets out of order");
+                }
+
+                name.assign(nameBytes.data() + nameOffsets[i], nameOffsets[i + 1] - nameOffsets[i]);
+            }
+
+            locations.push_back(Location{std::move(name), coordinates[i * 2], coordinates[i * 2 + 1]});
+        }
+
+        try
+        {
+            return CompactRoadMap{
+                borrowSection<int>(file, header, BinaryRoadMapSection::VertexNumbers, vertexCount),
+                std::move(locations),
+                borrowSection<int>(file, header, BinaryRoadMapSection::EdgeOffsets, vertexCount + 1),
+                borrowSection<int>(file, header, BinaryRoadMapSection::EdgeTargets, edgeCount),
+                borrowSection<RoadSegment>(file, header, BinaryRoadMapSection::RoadSegments, edgeCount)};
+        }
+        catch (DigraphException& e)
+        {
+            throw corrupt(e.reason());
+        }
+    }
+
+
+    // borrowNetwork() returns a RoadNetwork built from the graph in the
+    // given file and the arrays saved with it, all of which it borrows,
+    // along with its locations' names.
+    RoadNetwork borrowNetwork(
+        const std::shared_ptr<const MappedFile>& file, const BinaryRoadMapHeader& header)
+    {
+        std::uint64_t vertexCount = header.vertexCount;
+        std::uint64_t edgeCount = header.edgeCount;
+
+        CompactRoadMap graph = readGraph(file, header, false);
+
+        RoadNetworkArrays arrays;
+        arrays.distanceWeights = borrowSection<double>(
+            file, header, BinaryRoadMapSection::DistanceWeights, edgeCount);
+        arrays.timeWeights = borrowSection<double>(
+            file, header, BinaryRoadMapSection::TimeWeights, edgeCount);
+        arrays.detourFactor = header.detourFactor;
+        arrays.maxMilesPerHour = header.maxMilesPerHour;
+
+        if (header.sections[static_cast<int>(BinaryRoadMapSection::GeoPoints)].size != 0)
+        {
+            arrays.points = borrowSection<GeoPoint>(
+                file, header, BinaryRoadMapSection::GeoPoints, vertexCount);
+        }
+
+        arrays.nameOffsets = borrowSection<std::uint64_t>(
+            file, header, BinaryRoadMapSection::NameOffsets, vertexCount + 1);
+        arrays.nameBytes = borrowSection<char>(
+            file, header, BinaryRoadMapSection::NameBytes, arrays.nameOffsets.back());
+
+        // The incoming edges are checked against the edges they name,
+        // since a backward search follows them (see readRoadNetwork()).
+
+        try
+        {
+            graph.setIncomingEdges(
+                borrowSection<int>(file, header, BinaryRoadMapSection::InEdgeOffsets, vertexCount + 1),
+                borrowSection<int>(file, header, BinaryRoadMapSection::InEdgeSources, edgeCount),
+                borrowSection<int>(file, header, BinaryRoadMapSection::InEdgePositions, edgeCount));
+
+            return RoadNetwork{std::move(graph), std::move(arrays)};
+        }
+        catch (DigraphException& e)
+        {
+            throw corrupt(e.reason());
+        }
+    }
+
+
+    // borrowHierarchy() returns a ContractionHierarchy borrowing its arrays
+    // from the five sections starting with the given Ranks section.
+    ContractionHierarchy borrowHierarchy(
+        const std::shared_ptr<const MappedFile>& file,
+        const BinaryRoadMapHeader& header, BinaryRoadMapSection ranks)
+    {
+        auto next =
+            [&](int n)
+            {
+                return static_cast<BinaryRoadMapSection>(static_cast<int>(ranks) + n);
+            };
+
+        std::uint64_t vertexCount = header.vertexCount;
+
+        SharedArray<int> forwardOffsets =
+            borrowSection<int>(file, header, next(1), vertexCount + 1);
+
+        SharedArray<int> backwardOffsets =
+            borrowSection<int>(file, header, next(3), vertexCount + 1);
+
+        if (forwardOffsets.back() < 0 || backwardOffsets.back() < 0)
+        {
+            throw corrupt("arc offsets out of range");
+        }
+
+        // The hierarchy's ranks and arcs are verified, not just its arrays'
+        // sizes, since a query follows its arcs and unpacks its shortcuts
+        // without checking them again.
+
+        try
+        {
+            ContractionHierarchy hierarchy{
+                borrowSection<int>(file, header, ranks, vertexCount),
+                forwardOffsets,
+                borrowSection<HierarchyArc>(file, header, next(2), forwardOffsets.back()),
+                backwardOffsets,
+                borrowSection<HierarchyArc>(file, header, next(4), backwardOffsets.back())};
+
+            hierarchy.verify();
+            return hierarchy;
+        }
+        catch (DigraphException& e)
+        {
+            throw corrupt(e.reason());
+        }
+    }
+
+
+    // borrowLabelArrays() returns a HubLabelArrays borrowing its arrays
+    // from the four sections starting with the given LabelOffsets section.
+    HubLabelArrays borrowLabelArrays(
+        const std::shared_ptr<const MappedFile>& file,
+        const BinaryRoadMapHeader& header, BinaryRoadMapSection labelOffsets)
+    {
+        auto next =
+            [&](int n)
+            {
+                return static_cast<BinaryRoadMapSection>(static_cast<int>(labelOffsets) + n);
+            };
+
+        std::uint64_t vertexCount = header.vertexCount;
+
+        HubLabelArrays arrays;
+        arrays.labelOffsets = borrowSection<std::uint64_t>(file, header, labelOffsets, vertexCount + 1);
+        arrays.hubOffsets = borrowSection<std::uint64_t>(file, header, next(1), vertexCount + 1);
+
+        // The last offsets give the sizes of the sections they point into,
+        // which can't be larger than the file.
+        if (arrays.hubOffsets.back() > file->size()
+            || arrays.labelOffsets.back() > file->size() / sizeof(double))
+        {
+            throw corrupt("label offsets out of range");
+        }
+
+        arrays.hubBytes = borrowSection<unsigned char>(
+            file, header, next(2), arrays.hubOffsets.back());
+
+        arrays.distances = borrowSection<double>(
+            file, header, next(3), arrays.labelOffsets.back());
+
+        return arrays;
+    }
+
+
+    // borrowLabels() returns HubLabels borrowing their arrays from the
+    // eight sections starting with the given ForwardLabelOffsets section.
+    HubLabels borrowLabels(
+        const std::shared_ptr<const MappedFile>& file,
+        const BinaryRoadMapHeader& header, BinaryRoadMapSection forwardLabelOffsets)
+    {
+        BinaryRoadMapSection backwardLabelOffsets =
+            static_cast<BinaryRoadMapSection>(static_cast<int>(forwardLabelOffsets) + 4);
+
+        try
+        {
+            return HubLabels{
+                borrowLabelArrays(file, header, forwardLabelOffsets),
+                borrowLabelArrays(file, header, backwardLabelOffsets)};
+        }
+        catch (DigraphException& e)
+        {
+            throw corrupt(e.reason());
+        }
+    }
+
+
+    // borrowLandmarks() returns a LandmarkTable borrowing its arrays from
+    // the three sections starting with the given Landmarks section.
+    LandmarkTable borrowLandmarks(
+        const std::shared_ptr<const MappedFile>& file,
+        const BinaryRoadMapHeader& header, BinaryRoadMapSection landmarks)
+    {
+        auto next =
+            [&](int n)
+            {
+                return static_cast<BinaryRoadMapSection>(static_cast<int>(landmarks) + n);
+            };
+
+        std::uint64_t landmarkCount = header.sections[static_cast<int>(landmarks)].size / sizeof(int);
+
+        // A sane table has a few dozen landmarks at most; the limit keeps
+        // the sizes of the distance sections from overflowing.
+        if (landmarkCount > 65536)
+        {
+            throw corrupt("too many landmarks");
+        }
+
+        std::uint64_t cells = header.vertexCount * landmarkCount;
+
+        // The distances are trusted, like the other numbers a search only
+        // reads (see readRoadNetwork()): a scan could rule out negative
+        // and NaN ones, but not ones that are too large.
+
+        try
+        {
+            return LandmarkTable{
+                static_cast<int>(header.vertexCount),
+                borrowSection<int>(file, header, landmarks, landmarkCount),
+                borrowSection<double>(file, header, next(1), cells),
+                borrowSection<double>(file, header, next(2), cells)};
+        }
+        catch (DigraphException& e)
+        {
+            throw corrupt(e.reason());
+        }
+    }
+}
+
+
+bool BinaryRoadMapReader::isBinaryRoadMap(const MappedFile& file)
+{
+    return file.size() >= sizeof(BinaryRoadMapMagic)
+        && std::memcmp(file.begin(), BinaryRoadMapMagic, sizeof(BinaryRoadMapMagic)) == 0;
+}
+
+
+CompactRoadMap BinaryRoadMapReader::readRoadMap(std::shared_ptr<const MappedFile> file)
+{
+    return readGraph(file, readHeader(*file), true);
+}
+
+
+RoadNetwork BinaryRoadMapReader::readRoadNetwork(std::shared_ptr<const MappedFile> file)
+{
+    const BinaryRoadMapHeader& header = readHeader(*file);
+    RoadNetwork network = borrowNetwork(file, header);
+
+    auto isEmpty =
+        [&](BinaryRoadMapSection section)
+        {
+            return header.sections[static_cast<int>(section)].size == 0;
+        };
+
+    if (!isEmpty(BinaryRoadMapSection::DistanceRanks) || !isEmpty(BinaryRoadMapSection::TimeRanks))
+    {
+        network.setHierarchies(
+            borrowHierarchy(file, header, BinaryRoadMapSection::DistanceRanks),
+            borrowHierarchy(file, header, BinaryRoadMapSection::TimeRanks));
+    }
+
+    if (!isEmpty(BinaryRoadMapSection::DistanceLandmarks) || !isEmpty(BinaryRoadMapSection::TimeLandmarks))
+    {
+        // The scales carry over any lightening of edges since the tables
+        // were built, without which their bounds could be too high.
+
+        try
+        {
+            network.setLandmarks(
+                borrowLandmarks(file, header, BinaryRoadMapSection::DistanceLandmarks),
+                borrowLandmarks(file, header, BinaryRoadMapSection::TimeLandmarks),
+                header.distanceLandmarkScale, header.timeLandmarkScale);
+        }
+        catch (DigraphException& e)
+        {
+            throw corrupt(e.reason());
+        }
+    }
+
+    if (!isEmpty(BinaryRoadMapSection::DistanceForwardLabelOffsets)
+        || !isEmpty(BinaryRoadMapSection::TimeForwardLabelOffsets))
+    {
+        network.setHubLabels(
+            borrowLabels(file, header, BinaryRoadMapSection::DistanceForwardLabelOffsets),
+            borrowLabels(file, header, BinaryRoadMapSection::TimeForwardLabelOffsets));
+    }
+
+    return network;
+}
+
@@ -0,0 +1,70 @@
+// BinaryRoadMapReader.hpp
+//
+// ICS 46 Spring 2016
+// Project #4: Rock and Roll Stops the Traffic
+//
+// A BinaryRoadMapReader loads a road map written by a BinaryRoadMapWriter
+// (see BinaryRoadMapFormat.hpp) from a MappedFile.  The CompactRoadMap it
+// returns borrows its vertex numbers, edges and RoadSegments directly from
+// the mapped file instead of copying them, and keeps the file mapped for
+// as long as it needs them; only the vertex names and coordinates are
+// copied, since the graph keeps them together as Locations.
+//
+// A RoadNetwork is loaded the same way, but borrows even more: its weight
+// columns, incoming edges, GeoPoints and location names, along with any
+// contraction hierarchies, landmark tables and hub labels saved with the
+// road map.  Only the coordinates are copied into its graph's Locations,
+// so loading it costs little more than mapping the file.
+//
+// Every section is checked by one rule: what a search follows is checked
+// as it's loaded, and what a search only reads numbers from is trusted.
+// The graph's edges, its incoming edges (each slot against the edge it
+// names) and the hierarchies' ranks and arcs (down to the two halves of
+// every shortcut) decide which vertices a search visits and which path it
+// returns, so a file damaged in any of them is rejected with an
+// InputException, in time linear in the size of those sections, rather
+// than being routed on wrongly or failing partway through a query.  The
+// weight columns, the landmark tables' distances and the hub labels could
+// only be checked by computing them again, so only their sizes and the
+// landmarks' indexes are checked; a file whose numbers were damaged after
+// it was written gives wrong routes or distances without any error.  (A
+// hub label query still checks that the labels it reads lie within their
+// arrays, so a damaged label can make it throw a DigraphException, but
+// never read out of bounds.)
+
+#ifndef BINARYROADMAPREADER_HPP
+#define BINARYROADMAPREADER_HPP
+
+#include <memory>
+#include "MappedFile.hpp"
+#include "RoadMap.hpp"
+#include "RoadNetwork.hpp"
+
+
+
+class BinaryRoadMapReader
+{
+public:
+    // isBinaryRoadMap() returns true if the given file begins the way a
+    // binary road map does (though it may still turn out to be corrupt).
+    static bool isBinaryRoadMap(const MappedFile& file);
+
+    // readRoadMap() loads the road map in the given file.  If the file
+    // isn't a binary road map, was written by a different version of
+    // the format or on a machine with a different byte order, or is
+    // inconsistent, an InputException is thrown instead.
+    CompactRoadMap readRoadMap(std::shared_ptr<const MappedFile> file);
+
+    // readRoadNetwork() loads the road map in the given file into a
+    // RoadNetwork, along with its hierarchies, landmark tables and hub
+    // labels if the file has any, throwing an InputException in the same
+    // cases readRoadMap() does, or if its incoming edges or hierarchies
+    // are damaged; its weights, landmark distances and hub labels are
+    // trusted, as described above.
+    RoadNetwork readRoadNetwork(std::shared_ptr<const MappedFile> file);
+};
+
+
+
+#endif // BINARYROADMAPREADER_HPP
+
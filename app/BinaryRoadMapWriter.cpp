@@ -0,0 +1,253 @@
+// BinaryRoadMapWriter.cpp
+//
+// ICS 46 Spring 2016
+// Project #4: Rock and Roll Stops the Traffic
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "BinaryRoadMapFormat.hpp"
+#include "BinaryRoadMapWriter.hpp"
+
+
+namespace
+{
+    std::uint64_t align(std::uint64_t offset)
+    {
+        return (offset + BinaryRoadMapAlignment - 1) / BinaryRoadMapAlignment * BinaryRoadMapAlignment;
+    }
+
+
+    // A SectionData points to the bytes of one section.
+    struct SectionData
+    {
+        const void* data;
+        std::uint64_t size;
+    };
+
+
+    template <typename Array>
+    SectionData sectionData(const Array& elements)
+    {
+        return SectionData{elements.data(), elements.size() * sizeof(elements[0])};
+    }
+
+
+    void writeSection(
+        std::ostream& out, std::uint64_t& written,
+        const BinaryRoadMapSectionEntry& entry, const SectionData& section)
+    {
+        static const char padding[BinaryRoadMapAlignment] = {};
+
+        out.write(padding, entry.offset - written);
+        out.write(static_cast<const char*>(section.data), entry.size);
+        written = entry.offset + entry.size;
+    }
+
+
+    // writeFile() writes the given RoadNetwork, along with any
+    // hierarchies, landmark tables and hub labels it has.
+    void writeFile(std::ostream& out, const RoadNetwork& network)
+    {
+        const CompactRoadMap& roadMap = network.graph();
+        const RoadNetworkArrays& arrays = network.arrays();
+
+        int vertexCount = roadMap.vertexCount();
+        int edgeCount = roadMap.edgeCount();
+
+        std::vector<int> vertexNumbers;
+        std::vector<std::uint64_t> nameOffsets{0};
+        std::vector<char> nameBytes;
+        std::vector<double> coordinates;
+        std::vector<int> edgeOffsets;
+        std::vector<int> edgeTargets;
+        std::vector<RoadSegment> roadSegments;
+        std::vector<int> inEdgeOffsets;
+        std::vector<int> inEdgeSources;
+        std::vector<int> inEdgePositions;
+
+        vertexNumbers.reserve(vertexCount);
+        nameOffsets.reserve(vertexCount + 1);
+        coordinates.reserve(vertexCount * 2);
+        edgeOffsets.reserve(vertexCount + 1);
+        edgeTargets.reserve(edgeCount);
+        roadSegments.reserve(edgeCount);
+        inEdgeOffsets.reserve(vertexCount + 1);
+        inEdgeSources.reserve(edgeCount);
+        inEdgePositions.reserve(edgeCount);
+
+        for (int i = 0; i < vertexCount; ++i)
+        {
+            int vertex = roadMap.toVertexNumber(i);
+            const Location& location = roadMap.vertexInfo(vertex);
+            std::string_view name = network.locationName(vertex);
+
+            vertexNumbers.push_back(vertex);
+            nameBytes.insert(nameBytes.end(), name.begin(), name.end());
+            nameOffsets.push_back(nameBytes.size());
+            coordinates.push_back(location.latitude);
+            coordinates.push_back(location.longitude);
+            edgeOffsets.push_back(roadMap.edgeBegin(i));
+
+            for (int e = roadMap.edgeBegin(i); e < roadMap.edgeEnd(i); ++e)
+            {
+                edgeTargets.push_back(roadMap.edgeTarget(e));
+                roadSegments.push_back(roadMap.edgeInfoAt(e));
+            }
+
+            inEdgeOffsets.push_back(roadMap.inEdgeBegin(i));
+
+            for (int slot = roadMap.inEdgeBegin(i); slot < roadMap.inEdgeEnd(i); ++slot)
+            {
+                inEdgeSources.push_back(roadMap.inEdgeSource(slot));
+                inEdgePositions.push_back(roadMap.inEdgePosition(slot));
+            }
+        }
+
+        edgeOffsets.push_back(edgeCount);
+        inEdgeOffsets.push_back(edgeCount);
+
+        BinaryRoadMapHeader header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, BinaryRoadMapMagic, sizeof(header.magic));
+        header.version = BinaryRoadMapVersion;
+        header.byteOrderMark = BinaryRoadMapByteOrderMark;
+        header.vertexCount = vertexCount;
+        header.edgeCount = edgeCount;
+        header.detourFactor = arrays.detourFactor;
+        header.maxMilesPerHour = arrays.maxMilesPerHour;
+        header.distanceLandmarkScale = network.landmarkScale(TripMetric::Distance);
+        header.timeLandmarkScale = network.landmarkScale(TripMetric::Time);
+
+        // The sections are listed in the order BinaryRoadMapSection numbers
+        // them; the hierarchy, landmark and hub label sections stay empty
+        // if there are no hierarchies, landmark tables or hub labels.
+
+        std::vector<SectionData> sections
+        {
+            sectionData(vertexNumbers),
+            sectionData(nameOffsets),
+            sectionData(nameBytes),
+            sectionData(coordinates),
+            sectionData(edgeOffsets),
+            sectionData(edgeTargets),
+            sectionData(roadSegments),
+            sectionData(arrays.distanceWeights),
+            sectionData(arrays.timeWeights),
+            sectionData(inEdgeOffsets),
+            sectionData(inEdgeSources),
+            sectionData(inEdgePositions),
+            sectionData(arrays.points)
+        };
+
+        for (TripMetric metric : {TripMetric::Distance, TripMetric::Time})
+        {
+            if (network.hasHierarchies())
+            {
+                // What's saved is verified first, so that a file that
+                // fails to load was damaged after it was written.
+                const ContractionHierarchy& hierarchy = network.hierarchy(metric);
+                hierarchy.verify();
+
+                sections.push_back(sectionData(hierarchy.rankArray()));
+                sections.push_back(sectionData(hierarchy.forwardOffsetArray()));
+                sections.push_back(sectionData(hierarchy.forwardArcArray()));
+                sections.push_back(sectionData(hierarchy.backwardOffsetArray()));
+                sections.push_back(sectionData(hierarchy.backwardArcArray()));
+            }
+            else
+            {
+                sections.insert(sections.end(), 5, SectionData{nullptr, 0});
+            }
+        }
+
+        for (TripMetric metric : {TripMetric::Distance, TripMetric::Time})
+        {
+            if (network.hasLandmarks())
+            {
+                const LandmarkTable& landmarks = network.landmarks(metric);
+                landmarks.verify();
+
+                // The same range a reader accepts (see setLandmarks()).
+                double scale = network.landmarkScale(metric);
+
+                if (!(scale > 0.0 && scale <= 1.0))
+                {
+                    throw DigraphException{"landmark scale out of range"};
+                }
+
+                sections.push_back(sectionData(landmarks.landmarkArray()));
+                sections.push_back(sectionData(landmarks.fromLandmarkArray()));
+                sections.push_back(sectionData(landmarks.toLandmarkArray()));
+            }
+            else
+            {
+                sections.insert(sections.end(), 3, SectionData{nullptr, 0});
+            }
+        }
+
+        for (TripMetric metric : {TripMetric::Distance, TripMetric::Time})
+        {
+            if (network.hasHubLabels())
+            {
+                // A reader checks only the sizes of the labels' arrays, so
+                // their contents are verified once here, before they're saved.
+                const HubLabels& labels = network.hubLabels(metric);
+                labels.verify();
+
+                for (const HubLabelArrays* arrays : {&labels.forwardArrays(), &labels.backwardArrays()})
+                {
+                    sections.push_back(sectionData(arrays->labelOffsets));
+                    sections.push_back(sectionData(arrays->hubOffsets));
+                    sections.push_back(sectionData(arrays->hubBytes));
+                    sections.push_back(sectionData(arrays->distances));
+                }
+            }
+            else
+            {
+                sections.insert(sections.end(), 8, SectionData{nullptr, 0});
+            }
+        }
+
+        std::uint64_t offset = sizeof(header);
+
+        for (int s = 0; s < static_cast<int>(BinaryRoadMapSection::Count); ++s)
+        {
+            offset = align(offset);
+            header.sections[s] = BinaryRoadMapSectionEntry{offset, sections[s].size};
+            offset += sections[s].size;
+        }
+
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+        std::uint64_t written = sizeof(header);
+
+        for (int s = 0; s < static_cast<int>(BinaryRoadMapSection::Count); ++s)
+        {
+            writeSection(out, written, header.sections[s], sections[s]);
+        }
+
+        out.flush();
+    }
+}
+
+
+void BinaryRoadMapWriter::writeRoadMap(std::ostream& out, const CompactRoadMap& roadMap)
+{
+    writeFile(out, RoadNetwork{roadMap});
+}
+
+
+void BinaryRoadMapWriter::writeRoadMap(std::ostream& out, const RoadMap& roadMap)
+{
+    writeRoadMap(out, roadMap.freeze());
+}
+
+
+void BinaryRoadMapWriter::writeRoadMap(std::ostream& out, const RoadNetwork& network)
+{
+    writeFile(out, network);
+}
+
@@ -0,0 +1,44 @@
+// BinaryRoadMapWriter.hpp
+//
+// ICS 46 Spring 2016
+// Project #4: Rock and Roll Stops the Traffic
+//
+// A BinaryRoadMapWriter writes a RoadMap in the binary format described in
+// BinaryRoadMapFormat.hpp, which a BinaryRoadMapReader can load by mapping
+// it into memory instead of parsing it.  Writing a RoadNetwork writes its
+// contraction hierarchies, landmark tables and hub labels, too, if it has
+// any, so that they're built once and then loaded along with the road map.
+
+#ifndef BINARYROADMAPWRITER_HPP
+#define BINARYROADMAPWRITER_HPP
+
+#include <ostream>
+#include "RoadMap.hpp"
+#include "RoadNetwork.hpp"
+
+
+
+class BinaryRoadMapWriter
+{
+public:
+    // writeRoadMap() writes the given CompactRoadMap to the given output
+    // stream, which should have been opened in binary mode, along with
+    // the weights and incoming edges a RoadNetwork built from it needs.
+    void writeRoadMap(std::ostream& out, const CompactRoadMap& roadMap);
+
+    // This overload of writeRoadMap() freezes the given RoadMap and then
+    // writes it.
+    void writeRoadMap(std::ostream& out, const RoadMap& roadMap);
+
+    // This overload of writeRoadMap() writes the given RoadNetwork's
+    // road map, along with its hierarchies, landmark tables and hub
+    // labels, if it has any.  If any of those fails to verify, or a
+    // landmark table's scale (see RoadNetwork::landmarkScale()) isn't in
+    // (0, 1], a DigraphException is thrown before anything is written.
+    void writeRoadMap(std::ostream& out, const RoadNetwork& network);
+};
+
+
+
+#endif // BINARYROADMAPWRITER_HPP
+
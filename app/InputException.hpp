@@ -0,0 +1,31 @@
+// InputException.hpp
+//
+// ICS 46 Spring 2016
+// Project #4: Rock and Roll Stops the Traffic
+//
+// InputExceptions are thrown when the program's input can't be read, such
+// as when an input file can't be opened, or when it ends before all of the
+// input the format calls for has been read.
+
+#ifndef INPUTEXCEPTION_HPP
+#define INPUTEXCEPTION_HPP
+
+#include <string>
+
+
+
+class InputException
+{
+public:
+    InputException(const std::string& reason): reason_{reason} { }
+
+    std::string reason() const { return reason_; }
+
+private:
+    std::string reason_;
+};
+
+
+
+#endif // INPUTEXCEPTION_HPP
+
@@ -0,0 +1,99 @@
+// Location.cpp
+//
+// ICS 46 Spring 2016
+// Project #4: Rock and Roll Stops the Traffic
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "InputException.hpp"
+#include "Location.hpp"
+#include "MappedInputReader.hpp"
+
+
+namespace
+{
+    const double pi = 3.14159265358979323846;
+
+    // The mean radius of the earth, in miles.
+    const double earthRadiusMiles = 3958.8;
+
+
+    double toRadians(double degrees)
+    {
+        return degrees * pi / 180.0;
+    }
+
+
+    std::string_view trimTrailingSpaces(std::string_view s)
+    {
+        while (!s.empty() && (s.back() == ' ' || s.back() == '\t'))
+        {
+            s.remove_suffix(1);
+        }
+
+        return s;
+    }
+}
+
+
+bool Location::hasCoordinates() const
+{
+    return !std::isnan(latitude) && !std::isnan(longitude);
+}
+
+
+Location parseLocation(std::string_view line)
+{
+    const double none = std::numeric_limits<double>::quiet_NaN();
+
+    std::size_t bar = line.rfind('|');
+
+    if (bar == std::string_view::npos)
+    {
+        return Location{std::string{line}, none, none};
+    }
+
+    LineFields coordinates{line.substr(bar + 1)};
+    double latitude = coordinates.readDouble();
+    double longitude = coordinates.readDouble();
+
+    if (!(latitude >= -90.0 && latitude <= 90.0)
+        || !(longitude >= -180.0 && longitude <= 180.0))
+    {
+        throw InputException{
+            "coordinates out of range in \"" + std::string{line} + "\""};
+    }
+
+    return Location{
+        std::string{trimTrailingSpaces(line.substr(0, bar))}, latitude, longitude};
+}
+
+
+GeoPoint toGeoPoint(const Location& location)
+{
+    double latitude = toRadians(location.latitude);
+    return GeoPoint{latitude, toRadians(location.longitude), std::cos(latitude)};
+}
+
+
+double greatCircleMiles(const GeoPoint& a, const GeoPoint& b)
+{
+    // This is the haversine formula, which stays accurate for the short
+    // distances between neighboring intersections.
+
+    double sinHalfLatitude = std::sin((b.latitude - a.latitude) / 2.0);
+    double sinHalfLongitude = std::sin((b.longitude - a.longitude) / 2.0);
+
+    double h = sinHalfLatitude * sinHalfLatitude
+        + a.cosLatitude * b.cosLatitude * sinHalfLongitude * sinHalfLongitude;
+
+    return 2.0 * earthRadiusMiles * std::asin(std::sqrt(std::min(1.0, h)));
+}
+
+
+std::ostream& operator<<(std::ostream& out, const Location& location)
+{
+    return out << location.name;
+}
+
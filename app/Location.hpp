@@ -0,0 +1,77 @@
+// Location.hpp
+//
+// ICS 46 Spring 2016
+// Project #4: Rock and Roll Stops the Traffic
+//
+// A Location structure describes a vertex in a RoadMap: the name of the
+// place, and optionally its geographic coordinates (latitude and longitude,
+// in degrees).  A location without coordinates has NaN for both.
+//
+// In the LOCATIONS section of the input, a location's line is its name,
+// optionally followed by a vertical bar and its latitude and longitude:
+//
+//     Freeway North @ 101st Ave | 33.6846 -117.8265
+//
+// The vertical bar keeps the coordinates from being mistaken for part of
+// a name, since names often end in numbers of their own.  Coordinates make
+// goal-directed (A*) routing possible, since the great-circle distance
+// between two locations is a lower bound on the length of any road between
+// them.
+//
+// Writing a Location to an output stream writes only its name, so the
+// program's reports read the same whether or not coordinates were given.
+
+#ifndef LOCATION_HPP
+#define LOCATION_HPP
+
+#include <ostream>
+#include <string>
+#include <string_view>
+
+
+
+struct Location
+{
+    std::string name;
+    double latitude;
+    double longitude;
+
+    // hasCoordinates() returns true if this location's coordinates are
+    // known.
+    bool hasCoordinates() const;
+};
+
+
+// A GeoPoint is a location's coordinates in the form the great-circle
+// distance formula uses: latitude and longitude in radians, along with
+// the cosine of the latitude, which would otherwise be recomputed every
+// time a distance is measured from the same point.
+
+struct GeoPoint
+{
+    double latitude;
+    double longitude;
+    double cosLatitude;
+};
+
+
+
+// parseLocation() parses one line of the LOCATIONS section.  If the line
+// has a vertical bar, but what follows it isn't a valid latitude and
+// longitude, an InputException is thrown.
+Location parseLocation(std::string_view line);
+
+// toGeoPoint() converts the coordinates of the given location, which must
+// have them, into a GeoPoint.
+GeoPoint toGeoPoint(const Location& location);
+
+// greatCircleMiles() returns the distance in miles between the given
+// points along the surface of the earth.
+double greatCircleMiles(const GeoPoint& a, const GeoPoint& b);
+
+std::ostream& operator<<(std::ostream& out, const Location& location);
+
+
+
+#endif // LOCATION_HPP
+
@@ -0,0 +1,92 @@
+// MappedFile.cpp
+//
+// ICS 46 Spring 2016
+// Project #4: Rock and Roll Stops the Traffic
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "InputException.hpp"
+#include "MappedFile.hpp"
+
+
+namespace
+{
+    InputException failure(const std::string& what, const std::string& path)
+    {
+        return InputException{"cannot " + what + " " + path + ": " + std::strerror(errno)};
+    }
+}
+
+
+MappedFile::MappedFile(const std::string& path, Access access)
+    : data_{nullptr}, size_{0}
+{
+    int fd = ::open(path.c_str(), O_RDONLY);
+
+    if (fd < 0)
+    {
+        throw failure("open", path);
+    }
+
+    struct stat status;
+
+    if (::fstat(fd, &status) < 0)
+    {
+        InputException e = failure("examine", path);
+        ::close(fd);
+        throw e;
+    }
+
+    size_ = static_cast<std::size_t>(status.st_size);
+
+    // An empty file can't be mapped, but there's nothing to map anyway.
+
+    if (size_ > 0)
+    {
+        data_ = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if (data_ == MAP_FAILED)
+        {
+            InputException e = failure("map", path);
+            ::close(fd);
+            throw e;
+        }
+
+        ::madvise(data_, size_, access == Access::Sequential ? MADV_SEQUENTIAL : MADV_RANDOM);
+    }
+
+    // The mapping stays valid after the file is closed.
+    ::close(fd);
+}
+
+
+MappedFile::~MappedFile()
+{
+    if (data_ != nullptr)
+    {
+        ::munmap(data_, size_);
+    }
+}
+
+
+const char* MappedFile::begin() const
+{
+    return static_cast<const char*>(data_);
+}
+
+
+const char* MappedFile::end() const
+{
+    return begin() + size_;
+}
+
+
+std::size_t MappedFile::size() const
+{
+    return size_;
+}
+
@@ -0,0 +1,65 @@
+// MappedFile.hpp
+//
+// ICS 46 Spring 2016
+// Project #4: Rock and Roll Stops the Traffic
+//
+// A MappedFile maps the contents of a file into memory, read-only, for as
+// long as the MappedFile exists.  Reading the file then involves no copying
+// at all: the operating system pages the file in as its contents are
+// touched, and the contents can be scanned in place.
+//
+// How the file will be read is given when it's mapped, so the operating
+// system can page it in accordingly: a text file that's parsed from front
+// to back can be read ahead aggressively and dropped behind the parser,
+// while a binary road map is read wherever searches happen to go, for as
+// long as the program runs.
+
+#ifndef MAPPEDFILE_HPP
+#define MAPPEDFILE_HPP
+
+#include <cstddef>
+#include <string>
+
+
+
+class MappedFile
+{
+public:
+    // An Access describes how the contents of a file will be read:
+    // from front to back, once, or in no particular order.
+    enum class Access
+    {
+        Sequential,
+        Random
+    };
+
+public:
+    // Maps the file with the given path into memory, to be read as the
+    // given Access describes.  If the file can't be opened or mapped, an
+    // InputException is thrown instead.
+    MappedFile(const std::string& path, Access access);
+
+    // The destructor unmaps the file.
+    ~MappedFile();
+
+    // A MappedFile can't be copied, since it owns the mapping.
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // begin() and end() return pointers to the first character of the
+    // file's contents and just past the last one.
+    const char* begin() const;
+    const char* end() const;
+
+    // size() returns the number of bytes in the file.
+    std::size_t size() const;
+
+private:
+    void* data_;
+    std::size_t size_;
+};
+
+
+
+#endif // MAPPEDFILE_HPP
+
@@ -0,0 +1,220 @@
+// MappedInputReader.cpp
+//
+// ICS 46 Spring 2016
+// Project #4: Rock and Roll Stops the Traffic
+
+#include <cctype>
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#if __has_include(<version>)
+#include <version>
+#endif
+
+#include "InputException.hpp"
+#include "MappedInputReader.hpp"
+
+
+namespace
+{
+    bool isSpace(char c)
+    {
+        return std::isspace(static_cast<unsigned char>(c));
+    }
+
+
+    // std::from_chars doesn't accept a leading '+', though the streams
+    // the original readers used do, so one is skipped here.
+    const char* skipPlus(const char* first, const char* last)
+    {
+        return first != last && *first == '+' ? first + 1 : first;
+    }
+
+
+    InputException badField(std::string_view field, const char* kind)
+    {
+        return InputException{"\"" + std::string{field} + "\" is not " + kind};
+    }
+
+
+    int parseInt(std::string_view field)
+    {
+        const char* first = skipPlus(field.data(), field.data() + field.size());
+        const char* last = field.data() + field.size();
+
+        int value = 0;
+        std::from_chars_result result = std::from_chars(first, last, value);
+
+        if (result.ec != std::errc{} || result.ptr != last)
+        {
+            throw badField(field, "an integer");
+        }
+
+        return value;
+    }
+
+
+    double parseDouble(std::string_view field)
+    {
+        const char* first = skipPlus(field.data(), field.data() + field.size());
+        const char* last = field.data() + field.size();
+
+        double value = 0.0;
+
+#if defined(__cpp_lib_to_chars)
+        std::from_chars_result result = std::from_chars(first, last, value);
+
+        if (result.ec != std::errc{} || result.ptr != last)
+        {
+            throw badField(field, "a number");
+        }
+#else
+        // Standard libraries that don't yet implement std::from_chars for
+        // floating-point types get std::strtod instead, which needs its
+        // input null-terminated, so the field is copied into a buffer on
+        // the stack (which is more than large enough for any sensible
+        // number) rather than into a string.
+        char buffer[64];
+        std::size_t length = last - first;
+
+        if (length == 0 || length >= sizeof(buffer))
+        {
+            throw badField(field, "a number");
+        }
+
+        std::memcpy(buffer, first, length);
+        buffer[length] = '\0';
+
+        char* parsedEnd;
+        value = std::strtod(buffer, &parsedEnd);
+
+        if (parsedEnd != buffer + length)
+        {
+            throw badField(field, "a number");
+        }
+#endif
+
+        return value;
+    }
+}
+
+
+MappedInputReader::MappedInputReader(const char* begin, const char* end)
+    : next_{begin}, end_{end}
+{
+}
+
+
+std::string_view MappedInputReader::readLine()
+{
+    std::string_view line;
+
+    if (!tryReadLine(line))
+    {
+        throw InputException{"unexpected end of input"};
+    }
+
+    return line;
+}
+
+
+bool MappedInputReader::tryReadLine(std::string_view& line)
+{
+    while (next_ < end_)
+    {
+        const char* lineBegin = next_;
+        const char* lineEnd = static_cast<const char*>(
+            std::memchr(next_, '\n', end_ - next_));
+
+        if (lineEnd == nullptr)
+        {
+            lineEnd = end_;
+            next_ = end_;
+        }
+        else
+        {
+            next_ = lineEnd + 1;
+        }
+
+        while (lineEnd > lineBegin && isSpace(lineEnd[-1]))
+        {
+            --lineEnd;
+        }
+
+        if (lineEnd > lineBegin && *lineBegin != '#')
+        {
+            line = std::string_view(lineBegin, lineEnd - lineBegin);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+int MappedInputReader::readIntLine()
+{
+    return LineFields{readLine()}.readInt();
+}
+
+
+const char* MappedInputReader::position() const
+{
+    return next_;
+}
+
+
+void MappedInputReader::setPosition(const char* position)
+{
+    next_ = position;
+}
+
+
+const char* MappedInputReader::end() const
+{
+    return end_;
+}
+
+
+LineFields::LineFields(std::string_view line)
+    : line_{line}, position_{0}
+{
+}
+
+
+std::string_view LineFields::readWord()
+{
+    while (position_ < line_.size() && isSpace(line_[position_]))
+    {
+        ++position_;
+    }
+
+    std::size_t begin = position_;
+
+    while (position_ < line_.size() && !isSpace(line_[position_]))
+    {
+        ++position_;
+    }
+
+    if (begin == position_)
+    {
+        throw InputException{"missing field in \"" + std::string{line_} + "\""};
+    }
+
+    return line_.substr(begin, position_ - begin);
+}
+
+
+int LineFields::readInt()
+{
+    return parseInt(readWord());
+}
+
+
+double LineFields::readDouble()
+{
+    return parseDouble(readWord());
+}
+
@@ -0,0 +1,85 @@
+// MappedInputReader.hpp
+//
+// ICS 46 Spring 2016
+// Project #4: Rock and Roll Stops the Traffic
+//
+// A MappedInputReader reads lines of text from a range of characters that
+// is already in memory (such as a MappedFile), skipping the same lines an
+// InputReader does: blank lines, lines containing only spaces, and lines
+// that begin with a '#' character.  Unlike an InputReader, it never copies
+// a line; each line it returns is a std::string_view into the original
+// characters, which must outlive it.
+//
+// A LineFields splits one such line into whitespace-separated fields and
+// converts them to numbers with std::from_chars, again without copying.
+
+#ifndef MAPPEDINPUTREADER_HPP
+#define MAPPEDINPUTREADER_HPP
+
+#include <string_view>
+
+
+
+class MappedInputReader
+{
+public:
+    // Initializes a MappedInputReader that reads the characters from
+    // begin up to (but not including) end.
+    MappedInputReader(const char* begin, const char* end);
+
+    // readLine() returns the next meaningful line, without its line
+    // terminator or any trailing whitespace.  If there are no more
+    // meaningful lines, an InputException is thrown instead.
+    std::string_view readLine();
+
+    // tryReadLine() is like readLine(), except that if there are no more
+    // meaningful lines, it returns false instead of throwing.
+    bool tryReadLine(std::string_view& line);
+
+    // readIntLine() reads the next meaningful line, assuming that it
+    // contains an integer value (e.g., "7").  If it doesn't, an
+    // InputException is thrown instead.
+    int readIntLine();
+
+    // position() returns a pointer to the first character that hasn't
+    // been read yet, which is always the beginning of a line (or the end
+    // of the input).  setPosition() continues reading from the given
+    // position, which must also be the beginning of a line.
+    const char* position() const;
+    void setPosition(const char* position);
+
+    // end() returns a pointer just past the last character of the input.
+    const char* end() const;
+
+private:
+    const char* next_;
+    const char* end_;
+};
+
+
+
+class LineFields
+{
+public:
+    // Initializes a LineFields that reads fields from the given line.
+    explicit LineFields(std::string_view line);
+
+    // readWord() returns the next field as it appears in the line.  If
+    // there are no more fields, an InputException is thrown instead.
+    std::string_view readWord();
+
+    // readInt() and readDouble() read the next field as a number.  If
+    // there are no more fields, or the next one isn't a number of the
+    // right kind, an InputException is thrown instead.
+    int readInt();
+    double readDouble();
+
+private:
+    std::string_view line_;
+    std::size_t position_;
+};
+
+
+
+#endif // MAPPEDINPUTREADER_HPP
+
@@ -0,0 +1,278 @@
+// ParallelRoadMapReader.cpp
+//
+// ICS 46 Spring 2016
+// Project #4: Rock and Roll Stops the Traffic
+
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <string>
+#include <thread>
+#include <vector>
+#include "InputException.hpp"
+#include "ParallelRoadMapReader.hpp"
+
+
+namespace
+{
+    // Chunks smaller than this aren't worth a thread of their own.
+    const std::size_t minimumChunkSize = 1 << 20;
+
+
+    struct ParsedSegment
+    {
+        int fromLocation;
+        int toLocation;
+        RoadSegment segment;
+    };
+
+
+    struct Chunk
+    {
+        const char* begin;
+        const char* end;
+        int lineCount;
+        int segmentCount;
+        const char* segmentsEnd;
+        std::vector<ParsedSegment> segments;
+    };
+
+
+    // runOnThreads() calls work(i) for each chunk index i, each on its own
+    // thread, and rethrows the first exception any of them threw.
+    template <typename Work>
+    void runOnThreads(int chunkCount, Work work)
+    {
+        std::vector<std::exception_ptr> failures(chunkCount);
+        std::vector<std::thread> threads;
+
+        auto guarded =
+            [&](int i)
+            {
+                try
+                {
+                    work(i);
+                }
+                catch (...)
+                {
+                    failures[i] = std::current_exception();
+                }
+            };
+
+        for (int i = 1; i < chunkCount; ++i)
+        {
+            threads.emplace_back(guarded, i);
+        }
+
+        guarded(0);
+
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+
+        for (std::exception_ptr& failure : failures)
+        {
+            if (failure)
+            {
+                std::rethrow_exception(failure);
+            }
+        }
+    }
+
+
+    // splitIntoChunks() divides the characters from begin to end into at
+    // most chunkCount chunks of about the same size, each ending just
+    // after a newline (except possibly the last).
+    std::vector<Chunk> splitIntoChunks(const char* begin, const char* end, int chunkCount)
+    {
+        std::vector<Chunk> chunks;
+        std::size_t chunkSize = (end - begin) / chunkCount + 1;
+        const char* chunkBegin = begin;
+
+        while (chunkBegin < end)
+        {
+            const char* chunkEnd = end;
+
+            if (static_cast<std::size_t>(end - chunkBegin) > chunkSize)
+            {
+                const char* newline = static_cast<const char*>(
+                    std::memchr(chunkBegin + chunkSize, '\n', end - chunkBegin - chunkSize));
+
+                if (newline != nullptr)
+                {
+                    chunkEnd = newline + 1;
+                }
+            }
+
+            chunks.push_back(Chunk{chunkBegin, chunkEnd, 0, 0, chunkBegin, {}});
+            chunkBegin = chunkEnd;
+        }
+
+        return chunks;
+    }
+}
+
+
+ParallelRoadMapReader::ParallelRoadMapReader(int threadCount)
+    : threadCount_{threadCount}
+{
+    if (threadCount_ <= 0)
+    {
+        threadCount_ = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+}
+
+
+CompactRoadMap ParallelRoadMapReader::readRoadMap(MappedInputReader& in)
+{
+    int numberOfLocations = in.readIntLine();
+
+    if (numberOfLocations < 0)
+    {
+        throw InputException{"negative number of locations"};
+    }
+
+    std::vector<int> vertexNumbers(numberOfLocations);
+    std::vector<Location> locations;
+    locations.reserve(numberOfLocations);
+
+    for (int i = 0; i < numberOfLocations; ++i)
+    {
+        vertexNumbers[i] = i;
+        locations.push_back(parseLocation(in.readLine()));
+    }
+
+    int numberOfRoadSegments = in.readIntLine();
+
+    if (numberOfRoadSegments < 0)
+    {
+        throw InputException{"negative number of road segments"};
+    }
+
+    std::size_t remaining = in.end() - in.position();
+    int chunkCount = static_cast<int>(std::min<std::size_t>(
+        threadCount_, std::max<std::size_t>(1, remaining / minimumChunkSize)));
+
+    std::vector<Chunk> chunks = splitIntoChunks(in.position(), in.end(), chunkCount);
+    chunkCount = static_cast<int>(chunks.size());
+
+    // The first pass counts meaningful lines, so each chunk can learn how
+    // many of the road segments it holds; whatever follows them (i.e.,
+    // the trips) is left alone.
+
+    runOnThreads(
+        chunkCount,
+        [&](int i)
+        {
+            MappedInputReader chunkReader{chunks[i].begin, chunks[i].end};
+            std::string_view line;
+
+            while (chunkReader.tryReadLine(line))
+            {
+                ++chunks[i].lineCount;
+            }
+        });
+
+    int segmentsLeft = numberOfRoadSegments;
+
+    for (Chunk& chunk : chunks)
+    {
+        chunk.segmentCount = std::min(chunk.lineCount, segmentsLeft);
+        segmentsLeft -= chunk.segmentCount;
+    }
+
+    if (segmentsLeft > 0)
+    {
+        throw InputException{"unexpected end of input"};
+    }
+
+    runOnThreads(
+        chunkCount,
+        [&](int i)
+        {
+            Chunk& chunk = chunks[i];
+            MappedInputReader chunkReader{chunk.begin, chunk.end};
+
+            chunk.segments.reserve(chunk.segmentCount);
+
+            for (int s = 0; s < chunk.segmentCount; ++s)
+            {
+                LineFields roadSegmentLine{chunkReader.readLine()};
+
+                int fromLocation = roadSegmentLine.readInt();
+                int toLocation = roadSegmentLine.readInt();
+                double miles = roadSegmentLine.readDouble();
+                double milesPerHour = roadSegmentLine.readDouble();
+
+                chunk.segments.push_back(
+                    ParsedSegment{fromLocation, toLocation, RoadSegment{miles, milesPerHour}});
+            }
+
+            chunk.segmentsEnd = chunkReader.position();
+        });
+
+    for (const Chunk& chunk : chunks)
+    {
+        if (chunk.segmentCount > 0)
+        {
+            in.setPosition(chunk.segmentsEnd);
+        }
+    }
+
+    // Merging is a counting sort on each edge's "from" location, which
+    // keeps each location's edges in input order, as a RoadMap would.
+
+    std::vector<int> offsets(numberOfLocations + 1, 0);
+
+    for (const Chunk& chunk : chunks)
+    {
+        for (const ParsedSegment& parsed : chunk.segments)
+        {
+            if (parsed.fromLocation < 0 || parsed.fromLocation >= numberOfLocations
+                || parsed.toLocation < 0 || parsed.toLocation >= numberOfLocations)
+            {
+                throw DigraphException{"vertex does not exist"};
+            }
+
+            ++offsets[parsed.fromLocation + 1];
+        }
+    }
+
+    for (int i = 0; i < numberOfLocations; ++i)
+    {
+        offsets[i + 1] += offsets[i];
+    }
+
+    std::vector<int> next(offsets.begin(), offsets.end() - 1);
+    std::vector<int> targets(numberOfRoadSegments);
+    std::vector<RoadSegment> segments(numberOfRoadSegments);
+
+    for (const Chunk& chunk : chunks)
+    {
+        for (const ParsedSegment& parsed : chunk.segments)
+        {
+            int position = next[parsed.fromLocation]++;
+            targets[position] = parsed.toLocation;
+            segments[position] = parsed.segment;
+        }
+    }
+
+    std::vector<int> sortedTargets;
+
+    for (int i = 0; i < numberOfLocations; ++i)
+    {
+        sortedTargets.assign(targets.begin() + offsets[i], targets.begin() + offsets[i + 1]);
+        std::sort(sortedTargets.begin(), sortedTargets.end());
+
+        if (std::adjacent_find(sortedTargets.begin(), sortedTargets.end()) != sortedTargets.end())
+        {
+            throw DigraphException{"edge already exists"};
+        }
+    }
+
+    return CompactRoadMap{
+        std::move(vertexNumbers), std::move(locations), std::move(offsets),
+        std::move(targets), std::move(segments)};
+}
+
@@ -0,0 +1,55 @@
+// ParallelRoadMapReader.hpp
+//
+// ICS 46 Spring 2016
+// Project #4: Rock and Roll Stops the Traffic
+//
+// A ParallelRoadMapReader reads a road map in the same format as a
+// RoadMapReader, from a MappedInputReader, but parses the ROAD SEGMENTS
+// section on several threads, and builds a CompactRoadMap directly rather
+// than adding one edge at a time to a RoadMap.
+//
+// The input following the locations is split into chunks of roughly equal
+// size, each beginning at the start of a line.  First, each thread counts
+// the meaningful lines in its chunk, so that it's known which chunks hold
+// road segments and how many; then each thread parses the road segments in
+// its chunk into a buffer of its own.  Finally, the buffers are merged, in
+// input order, into the CompactRoadMap's arrays, checking for duplicate
+// edges by sorting each vertex's targets.
+//
+// The result is exactly what freezing the RoadMap built by a RoadMapReader
+// would give, including the order of each vertex's edges.
+
+#ifndef PARALLELROADMAPREADER_HPP
+#define PARALLELROADMAPREADER_HPP
+
+#include "MappedInputReader.hpp"
+#include "RoadMap.hpp"
+
+
+
+class ParallelRoadMapReader
+{
+public:
+    // Initializes a ParallelRoadMapReader that parses on the given number
+    // of threads.  A thread count of zero (the default) means one thread
+    // per hardware thread.  Small inputs use fewer threads, since they
+    // aren't worth splitting up.
+    explicit ParallelRoadMapReader(int threadCount = 0);
+
+    // readRoadMap() reads a road map from the given MappedInputReader,
+    // leaving it positioned just after the last road segment.  If the
+    // input ends too soon, a number is malformed or the number of
+    // locations or road segments is negative, an InputException is
+    // thrown; if a road segment refers to a location that doesn't exist,
+    // or the same road segment appears twice, a DigraphException is
+    // thrown, just as the RoadMap would have.
+    CompactRoadMap readRoadMap(MappedInputReader& in);
+
+private:
+    int threadCount_;
+};
+
+
+
+#endif // PARALLELROADMAPREADER_HPP
+
@@ -0,0 +1,141 @@
+// ParallelTripRunner.cpp
+//
+// ICS 46 Spring 2016
+// Project #4: Rock and Roll Stops the Traffic
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <thread>
+#include "ParallelTripRunner.hpp"
+#include "TripBatchRunner.hpp"
+#include "TripGroupRouter.hpp"
+#include "WorkStealingQueue.hpp"
+
+
+ParallelTripRunner::ParallelTripRunner(
+    const RoadNetwork& network, int threadCount, RoutingEngine engine)
+    : network_{network}, threadCount_{threadCount}, engine_{engine}
+{
+    if (threadCount_ <= 0)
+    {
+        threadCount_ = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+}
+
+
+int ParallelTripRunner::threadCount() const
+{
+    return threadCount_;
+}
+
+
+std::vector<ShortestPath<RoadSegment>> ParallelTripRunner::run(const std::vector<Trip>& trips)
+{
+    if (threadCount_ <= 1 || trips.size() <= 1)
+    {
+        return TripBatchRunner{network_, engine_}.run(trips);
+    }
+
+    std::vector<TripGroup> groups = TripGroupRouter::groupTrips(network_, trips);
+    std::vector<ShortestPath<RoadSegment>> routes(trips.size());
+
+    int workerCount = std::min(threadCount_, static_cast<int>(groups.size()));
+
+    // Each task is the position of a group in groups.  No task creates
+    // more tasks, so once a worker finds every queue empty, there is
+    // nothing left for it to do.  Every group writes only to the routes
+    // of its own trips, so the workers never write to the same route.
+
+    std::vector<std::unique_ptr<WorkStealingQueue<int>>> queues;
+
+    for (int w = 0; w < workerCount; ++w)
+    {
+        queues.push_back(std::make_unique<WorkStealingQueue<int>>());
+    }
+
+    for (int g = 0; g < static_cast<int>(groups.size()); ++g)
+    {
+        queues[g % workerCount]->push(g);
+    }
+
+    // The first worker to fail is the one that sets stopped, which tells
+    // the others to stop taking groups, so only its exception is kept;
+    // once every thread has been joined, it's rethrown.
+
+    std::exception_ptr failure;
+    std::atomic<bool> stopped{false};
+
+    auto work =
+        [&](int self)
+        {
+            try
+            {
+                TripGroupRouter router{network_, engine_};
+                int g;
+
+                while (!stopped.load(std::memory_order_relaxed))
+                {
+                    bool found = queues[self]->pop(g);
+
+                    for (int i = 1; !found && i < workerCount; ++i)
+                    {
+                        found = queues[(self + i) % workerCount]->steal(g);
+                    }
+
+                    if (!found)
+                    {
+                        break;
+                    }
+
+                    router.route(groups[g], routes);
+                }
+            }
+            catch (...)
+            {
+                bool expected = false;
+
+                if (stopped.compare_exchange_strong(expected, true))
+                {
+                    failure = std::current_exception();
+                }
+            }
+        };
+
+    std::vector<std::thread> threads;
+
+    try
+    {
+        for (int w = 1; w < workerCount; ++w)
+        {
+            threads.emplace_back(work, w);
+        }
+    }
+    catch (...)
+    {
+        stopped.store(true, std::memory_order_relaxed);
+
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+
+        throw;
+    }
+
+    work(0);
+
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    if (failure)
+    {
+        std::rethrow_exception(failure);
+    }
+
+    return routes;
+}
+
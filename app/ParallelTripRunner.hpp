@@ -0,0 +1,62 @@
+// ParallelTripRunner.hpp
+//
+// ICS 46 Spring 2016
+// Project #4: Rock and Roll Stops the Traffic
+//
+// A ParallelTripRunner finds the shortest routes for a whole sequence of
+// trips the way a TripBatchRunner does, grouping trips that share a start
+// vertex and a TripMetric, except that the groups are routed by a pool of
+// threads.  The RoadNetwork is shared by all of the threads, since none of
+// them changes it, while each thread routes with its own TripGroupRouter,
+// so no two threads ever touch the same search memory.
+//
+// The groups are dealt out evenly to the threads up front, and a thread
+// that finishes its own groups steals from the others, so that a few
+// expensive groups don't leave the rest of the threads idle.  Each route
+// is stored at its trip's position, so the results come back in the same
+// order as the trips no matter which thread found them or when.  With only
+// one thread (or one trip), the trips are simply handed to a
+// TripBatchRunner.
+
+#ifndef PARALLELTRIPRUNNER_HPP
+#define PARALLELTRIPRUNNER_HPP
+
+#include <vector>
+#include "RoadNetwork.hpp"
+#include "RoutingEngine.hpp"
+#include "Trip.hpp"
+
+
+
+class ParallelTripRunner
+{
+public:
+    // Initializes a ParallelTripRunner that routes trips on the given
+    // RoadNetwork, which must outlive it, using the given number of
+    // threads and the given engine.  A thread count of zero (the default)
+    // means one thread per hardware thread.
+    explicit ParallelTripRunner(
+        const RoadNetwork& network, int threadCount = 0,
+        RoutingEngine engine = RoutingEngine::Dijkstra);
+
+    // threadCount() returns the number of threads run() will use at most.
+    int threadCount() const;
+
+    // run() finds the shortest route for each of the given trips,
+    // returning them in the same order.  If any trip's start or end
+    // vertex does not exist, a DigraphException is thrown before any
+    // searching is done.  If routing a trip throws an exception, the
+    // other threads stop taking groups, and once all of them have
+    // finished, the first exception thrown is rethrown.
+    std::vector<ShortestPath<RoadSegment>> run(const std::vector<Trip>& trips);
+
+private:
+    const RoadNetwork& network_;
+    int threadCount_;
+    RoutingEngine engine_;
+};
+
+
+
+#endif // PARALLELTRIPRUNNER_HPP
+
@@ -4,19 +4,23 @@
 // Project #4: Rock and Roll Stops the Traffic
 //
 // This header defines a type RoadMap, which is simply a typedef to a particular
-// instantiation of the Digraph template, where each vertex has a string for its
-// information and each edge has a RoadSegment for its information.
+// instantiation of the Digraph template, where each vertex has a Location for
+// its information and each edge has a RoadSegment for its information.  It also
+// defines CompactRoadMap, the matching instantiation of CompactDigraph, which
+// is what a RoadMap becomes when it's frozen.
 
 #ifndef ROADMAP_HPP
 #define ROADMAP_HPP
 
-#include <string>
+#include "CompactDigraph.hpp"
 #include "Digraph.hpp"
+#include "Location.hpp"
 #include "RoadSegment.hpp"
 
 
 
-typedef Digraph<std::string, RoadSegment> RoadMap;
+typedef Digraph<Location, RoadSegment> RoadMap;
+typedef CompactDigraph<Location, RoadSegment> CompactRoadMap;
 
 
 
@@ -5,6 +5,11 @@
 
 #include <algorithm>
 #include <sstream>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include "InputException.hpp"
 #include "RoadMapReader.hpp"
 
 
@@ -14,13 +19,32 @@ RoadMap RoadMapReader::readRoadMap(InputReader& in)
 
     int numberOfLocations = in.readIntLine();
 
+    if (numberOfLocations < 0)
+    {
+        throw InputException{"negative number of locations"};
+    }
+
+    std::vector<std::pair<int, Location>> locations;
+    locations.reserve(numberOfLocations);
+
     for (int i = 0; i < numberOfLocations; ++i)
     {
-        roadMap.addVertex(i, in.readLine());
+        locations.emplace_back(i, parseLocation(in.readLine()));
     }
 
+    roadMap.reserve(numberOfLocations);
+    roadMap.addVertices(std::move(locations));
+
     int numberOfRoadSegments = in.readIntLine();
 
+    if (numberOfRoadSegments < 0)
+    {
+        throw InputException{"negative number of road segments"};
+    }
+
+    std::vector<std::tuple<int, int, RoadSegment>> roadSegments;
+    roadSegments.reserve(numberOfRoadSegments);
+
     for (int i = 0; i < numberOfRoadSegments; ++i)
     {
         std::istringstream roadSegmentLine{in.readLine()};
@@ -32,9 +56,11 @@ RoadMap RoadMapReader::readRoadMap(InputReader& in)
 
         roadSegmentLine >> fromLocation >> toLocation >> miles >> milesPerHour;
 
-        roadMap.addEdge(fromLocation, toLocation, RoadSegment{miles, milesPerHour});
+        roadSegments.emplace_back(fromLocation, toLocation, RoadSegment{miles, milesPerHour});
     }
 
+    roadMap.addEdges(std::move(roadSegments));
+
     return roadMap;
 }
 
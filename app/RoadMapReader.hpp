@@ -5,7 +5,8 @@
 //
 // The RoadMapReader class provides an object that knows how to read a
 // RoadMap from the standard input, using the format given in the
-// project write-up.
+// project write-up, where each location may also be given coordinates
+// (see Location.hpp).
 
 #ifndef ROADMAPREADER_HPP
 #define ROADMAPREADER_HPP
@@ -20,7 +21,8 @@ class RoadMapReader
 public:
     // readRoadMap() reads a RoadMap from the given InputReader.  The
     // RoadMap is expected to be described in the format given in the
-    // project write-up.
+    // project write-up.  If the number of locations or road segments
+    // is negative, an InputException is thrown.
     RoadMap readRoadMap(InputReader& in);
 };
 
@@ -12,17 +12,25 @@ void RoadMapWriter::writeRoadMap(std::ostream& out, const RoadMap& roadMap)
 
     for (int vertex : roadMap.vertices())
     {
-        out << "    " << vertex << ": " << roadMap.vertexInfo(vertex) << std::endl;
+        const Location& location = roadMap.vertexInfo(vertex);
+        out << "    " << vertex << ": " << location;
+
+        if (location.hasCoordinates())
+        {
+            out << " (" << location.latitude << ", " << location.longitude << ")";
+        }
+
+        out << std::endl;
     }
 
     out << std::endl;
     out << "ROAD SEGMENTS" << std::endl;
 
-    for (std::pair<int, int> edge : roadMap.edges())
+    for (const DigraphEdge<RoadSegment>& edge : roadMap.allEdges())
     {
-        out << "    " << edge.first << "," << edge.second << ": ";
+        out << "    " << edge.fromVertex << "," << edge.toVertex << ": ";
 
-        RoadSegment segment = roadMap.edgeInfo(edge.first, edge.second);
+        const RoadSegment& segment = edge.einfo;
         out << segment.miles << "miles; " << segment.milesPerHour << "mph";
 
         out << std::endl;
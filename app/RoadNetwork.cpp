@@ -0,0 +1,518 @@
+// RoadNetwork.cpp
+//
+// ICS 46 Spring 2016
+// Project #4: Rock and Roll Stops the Traffic
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+#include "RoadNetwork.hpp"
+#include "TripMetricWeight.hpp"
+
+
+RoadNetwork::GoalBound::GoalBound(
+    const SharedArray<GeoPoint>& points, int targetIndex, double weightPerMile)
+    : points_{points.data()},
+      target_{weightPerMile != 0.0 ? points[targetIndex] : GeoPoint{0.0, 0.0, 1.0}},
+      weightPerMile_{weightPerMile}
+{
+}
+
+
+RoadNetwork::RoadNetwork()
+    : arrays_{}, distanceLandmarkScale_{1.0}, timeLandmarkScale_{1.0}
+{
+    graph_.indexIncomingEdges();
+}
+
+
+RoadNetwork::RoadNetwork(CompactRoadMap graph)
+    : graph_{std::move(graph)}, arrays_{},
+      distanceLandmarkScale_{1.0}, timeLandmarkScale_{1.0}
+{
+    arrays_.distanceWeights = std::vector<double>(graph_.edgeCount());
+    arrays_.timeWeights = std::vector<double>(graph_.edgeCount());
+
+    for (int e = 0; e < graph_.edgeCount(); ++e)
+    {
+        computeWeights(e);
+    }
+
+    graph_.indexIncomingEdges();
+    computeGeoPoints();
+}
+
+
+RoadNetwork::RoadNetwork(const RoadMap& roadMap)
+    : RoadNetwork{roadMap.freeze()}
+{
+}
+
+
+RoadNetwork::RoadNetwork(CompactRoadMap graph, RoadNetworkArrays arrays)
+    : graph_{std::move(graph)}, arrays_{std::move(arrays)},
+      distanceLandmarkScale_{1.0}, timeLandmarkScale_{1.0}
+{
+    std::size_t vertexCount = graph_.vertexCount();
+    std::size_t edgeCount = graph_.edgeCount();
+
+    if (arrays_.distanceWeights.size() != edgeCount
+        || arrays_.timeWeights.size() != edgeCount
+        || (!arrays_.points.empty() && arrays_.points.size() != vertexCount))
+    {
+        throw DigraphException{"road network arrays do not match the road map"};
+    }
+
+    const SharedArray<std::uint64_t>& nameOffsets = arrays_.nameOffsets;
+
+    if (!nameOffsets.empty())
+    {
+        if (nameOffsets.size() != vertexCount + 1
+            || nameOffsets.front() != 0
+            || nameOffsets.back() > arrays_.nameBytes.size())
+        {
+            throw DigraphException{"name offsets do not match the road map"};
+        }
+
+        for (std::size_t i = 0; i < vertexCount; ++i)
+        {
+            if (nameOffsets[i + 1] < nameOffsets[i])
+            {
+                throw DigraphException{"name offsets out of order"};
+            }
+        }
+    }
+
+    graph_.indexIncomingEdges();
+}
+
+
+const CompactRoadMap& RoadNetwork::graph() const
+{
+    return graph_;
+}
+
+
+const RoadNetworkArrays& RoadNetwork::arrays() const
+{
+    return arrays_;
+}
+
+
+const SharedArray<double>& RoadNetwork::weights(TripMetric metric) const
+{
+    return metric == TripMetric::Time ? arrays_.timeWeights : arrays_.distanceWeights;
+}
+
+
+std::string_view RoadNetwork::locationName(int vertex) const
+{
+    if (arrays_.nameOffsets.empty())
+    {
+        return graph_.vertexInfo(vertex).name;
+    }
+
+    int index = graph_.toIndex(vertex);
+    std::uint64_t begin = arrays_.nameOffsets[index];
+
+    return std::string_view{
+        arrays_.nameBytes.data() + begin, arrays_.nameOffsets[index + 1] - begin};
+}
+
+
+RoadNetwork::MetricView RoadNetwork::view(TripMetric metric) const
+{
+    return MetricView{graph_, weights(metric)};
+}
+
+
+bool RoadNetwork::hasCoordinates() const
+{
+    return !arrays_.points.empty();
+}
+
+
+RoadNetwork::GoalBound RoadNetwork::goalBound(TripMetric metric, int targetIndex) const
+{
+    double weightPerMile = 0.0;
+
+    if (hasCoordinates())
+    {
+        double maxMilesPerHour = arrays_.maxMilesPerHour;
+
+        if (metric == TripMetric::Distance)
+        {
+            weightPerMile = arrays_.detourFactor;
+        }
+        else if (maxMilesPerHour > 0.0 && maxMilesPerHour < std::numeric_limits<double>::infinity())
+        {
+            weightPerMile = arrays_.detourFactor / maxMilesPerHour;
+        }
+    }
+
+    return GoalBound{arrays_.points, targetIndex, weightPerMile};
+}
+
+
+void RoadNetwork::buildHierarchies(int threadCount)
+{
+    distanceHierarchy_ = ContractionHierarchy::build(
+        view(TripMetric::Distance), PrecomputedWeight{}, threadCount);
+
+    timeHierarchy_ = ContractionHierarchy::build(
+        view(TripMetric::Time), PrecomputedWeight{}, threadCount);
+}
+
+
+void RoadNetwork::setHierarchies(ContractionHierarchy distance, ContractionHierarchy time)
+{
+    if (distance.vertexCount() != graph_.vertexCount()
+        || time.vertexCount() != graph_.vertexCount())
+    {
+        throw DigraphException{"hierarchy does not match the road map"};
+    }
+
+    distanceHierarchy_ = std::move(distance);
+    timeHierarchy_ = std::move(time);
+}
+
+
+bool RoadNetwork::hasHierarchies() const
+{
+    // An empty hierarchy matches an empty graph, but there's nothing to
+    // route on one anyway.
+    return distanceHierarchy_.vertexCount() == graph_.vertexCount()
+        && graph_.vertexCount() > 0;
+}
+
+
+const ContractionHierarchy& RoadNetwork::hierarchy(TripMetric metric) const
+{
+    return metric == TripMetric::Time ? timeHierarchy_ : distanceHierarchy_;
+}
+
+
+void RoadNetwork::buildLandmarks(int landmarkCount, LandmarkSelection selection)
+{
+    distanceLandmarks_ = LandmarkTable::build(
+        view(TripMetric::Distance), PrecomputedWeight{}, landmarkCount, selection);
+
+    timeLandmarks_ = LandmarkTable::build(
+        view(TripMetric::Time), PrecomputedWeight{}, landmarkCount, selection);
+
+    distanceLandmarkScale_ = 1.0;
+    timeLandmarkScale_ = 1.0;
+}
+
+
+void RoadNetwork::setLandmarks(
+    LandmarkTable distance, LandmarkTable time,
+    double distanceScale, double timeScale)
+{
+    if (distance.vertexCount() != graph_.vertexCount()
+        || time.vertexCount() != graph_.vertexCount())
+    {
+        throw DigraphException{"landmark table does not match the road map"};
+    }
+
+    // Written this way, NaN scales are rejected too.
+    if (!(distanceScale > 0.0 && distanceScale <= 1.0)
+        || !(timeScale > 0.0 && timeScale <= 1.0))
+    {
+        throw DigraphException{"landmark scale out of range"};
+    }
+
+    distanceLandmarks_ = std::move(distance);
+    timeLandmarks_ = std::move(time);
+    distanceLandmarkScale_ = distanceScale;
+    timeLandmarkScale_ = timeScale;
+}
+
+
+bool RoadNetwork::hasLandmarks() const
+{
+    return distanceLandmarks_.landmarkCount() > 0;
+}
+
+
+const LandmarkTable& RoadNetwork::landmarks(TripMetric metric) const
+{
+    return metric == TripMetric::Time ? timeLandmarks_ : distanceLandmarks_;
+}
+
+
+LandmarkTable::Bound RoadNetwork::landmarkBound(TripMetric metric, int targetIndex) const
+{
+    return LandmarkTable::Bound{landmarks(metric), targetIndex, landmarkScale(metric)};
+}
+
+
+double RoadNetwork::landmarkScale(TripMetric metric) const
+{
+    return metric == TripMetric::Time ? timeLandmarkScale_ : distanceLandmarkScale_;
+}
+
+
+void RoadNetwork::buildHubLabels(int threadCount)
+{
+    if (!hasHierarchies())
+    {
+        buildHierarchies(threadCount);
+    }
+
+    distanceLabels_ = HubLabels::build(
+        view(TripMetric::Distance), PrecomputedWeight{}, distanceHierarchy_.order());
+
+    timeLabels_ = HubLabels::build(
+        view(TripMetric::Time), PrecomputedWeight{}, timeHierarchy_.order());
+}
+
+
+void RoadNetwork::setHubLabels(HubLabels distance, HubLabels time)
+{
+    if (distance.vertexCount() != graph_.vertexCount()
+        || time.vertexCount() != graph_.vertexCount())
+    {
+        throw DigraphException{"hub labels do not match the road map"};
+    }
+
+    distanceLabels_ = std::move(distance);
+    timeLabels_ = std::move(time);
+}
+
+
+bool RoadNetwork::hasHubLabels() const
+{
+    return distanceLabels_.vertexCount() == graph_.vertexCount()
+        && graph_.vertexCount() > 0;
+}
+
+
+const HubLabels& RoadNetwork::hubLabels(TripMetric metric) const
+{
+    return metric == TripMetric::Time ? timeLabels_ : distanceLabels_;
+}
+
+
+double RoadNetwork::distance(int startVertex, int endVertex, TripMetric metric) const
+{
+    int startIndex = graph_.toIndex(startVertex);
+    int endIndex = graph_.toIndex(endVertex);
+
+    if (hasHubLabels())
+    {
+        return hubLabels(metric).distance(startIndex, endIndex);
+    }
+
+    ShortestPathSearch search;
+    search.run(view(metric), startIndex, PrecomputedWeight{}, endIndex);
+    return search.distance(endIndex);
+}
+
+
+void RoadNetwork::updateSegment(int fromVertex, int toVertex, const RoadSegment& segment)
+{
+    graph_.setEdgeInfo(fromVertex, toVertex, segment);
+
+    int position = graph_.edgePosition(fromVertex, toVertex);
+
+    double oldDistance = arrays_.distanceWeights[position];
+    double oldTime = arrays_.timeWeights[position];
+
+    computeWeights(position);
+    tightenBounds(graph_.toIndex(fromVertex), position);
+
+    // Each scale is the product of the ratios of every lightening so far,
+    // which is no more than the ratio of any edge's current weight to its
+    // weight when the tables were built, however many times it's changed,
+    // so every route is at least that many times as heavy as it was then.
+    // A scale that reaches zero (from a weight of zero, a weight that was
+    // infinite, or underflow) would give no bound at all, and couldn't be
+    // saved, so the tables go the way of the hierarchies instead.
+    bool distanceScaled =
+        scaleLandmarks(distanceLandmarkScale_, oldDistance, arrays_.distanceWeights[position]);
+    bool timeScaled =
+        scaleLandmarks(timeLandmarkScale_, oldTime, arrays_.timeWeights[position]);
+
+    if (!distanceScaled || !timeScaled)
+    {
+        distanceLandmarks_ = LandmarkTable{};
+        timeLandmarks_ = LandmarkTable{};
+        distanceLandmarkScale_ = 1.0;
+        timeLandmarkScale_ = 1.0;
+    }
+
+    distanceHierarchy_ = ContractionHierarchy{};
+    timeHierarchy_ = ContractionHierarchy{};
+    distanceLabels_ = HubLabels{};
+    timeLabels_ = HubLabels{};
+}
+
+
+ShortestPath<RoadSegment> RoadNetwork::findShortestPath(
+    const Trip& trip, RoutingEngine engine) const
+{
+    if (engine == RoutingEngine::Bidirectional)
+    {
+        BidirectionalSearch search;
+        return findShortestPath(trip, search);
+    }
+    else if (engine == RoutingEngine::ContractionHierarchies && hasHierarchies())
+    {
+        ContractionHierarchyQuery query;
+        return findShortestPath(trip, query);
+    }
+    else if (engine == RoutingEngine::AStar || engine == RoutingEngine::Landmarks)
+    {
+        int startIndex = graph_.toIndex(trip.startVertex);
+        int endIndex = graph_.toIndex(trip.endVertex);
+
+        ShortestPathSearch search;
+
+        if (engine == RoutingEngine::AStar)
+        {
+            search.runToward(
+                view(trip.metric), startIndex, endIndex, PrecomputedWeight{},
+                goalBound(trip.metric, endIndex));
+        }
+        else
+        {
+            search.runToward(
+                view(trip.metric), startIndex, endIndex, PrecomputedWeight{},
+                landmarkBound(trip.metric, endIndex));
+        }
+
+        return search.pathTo<RoadSegment>(graph_, endIndex);
+    }
+
+    SearchWorkspace workspace;
+    return findShortestPath(trip, workspace);
+}
+
+
+ShortestPath<RoadSegment> RoadNetwork::findShortestPath(
+    const Trip& trip, SearchWorkspace& workspace) const
+{
+    int startIndex = graph_.toIndex(trip.startVertex);
+    int endIndex = graph_.toIndex(trip.endVertex);
+
+    ShortestPathSearch search{workspace};
+    search.run(view(trip.metric), startIndex, PrecomputedWeight{}, endIndex);
+
+    // The view and the graph share their indexes, so the path can be
+    // recovered from the graph itself, which yields RoadSegments rather
+    // than precomputed weights.
+    return search.pathTo<RoadSegment>(graph_, endIndex);
+}
+
+
+ShortestPath<RoadSegment> RoadNetwork::findShortestPath(
+    const Trip& trip, BidirectionalSearch& search) const
+{
+    int startIndex = graph_.toIndex(trip.startVertex);
+    int endIndex = graph_.toIndex(trip.endVertex);
+
+    search.run(view(trip.metric), startIndex, endIndex, PrecomputedWeight{});
+    return search.path<RoadSegment>(graph_);
+}
+
+
+ShortestPath<RoadSegment> RoadNetwork::findShortestPath(
+    const Trip& trip, ContractionHierarchyQuery& query) const
+{
+    if (!hasHierarchies())
+    {
+        throw DigraphException{"road network has no hierarchies"};
+    }
+
+    int startIndex = graph_.toIndex(trip.startVertex);
+    int endIndex = graph_.toIndex(trip.endVertex);
+
+    const ContractionHierarchy& metricHierarchy = hierarchy(trip.metric);
+
+    query.run(metricHierarchy, startIndex, endIndex);
+    return query.path<RoadSegment>(metricHierarchy, graph_);
+}
+
+
+void RoadNetwork::computeWeights(int position)
+{
+    const RoadSegment& segment = graph_.edgeInfoAt(position);
+
+    arrays_.distanceWeights.mutableAt(position) = TripMetricWeight<TripMetric::Distance>{}(segment);
+    arrays_.timeWeights.mutableAt(position) = TripMetricWeight<TripMetric::Time>{}(segment);
+}
+
+
+void RoadNetwork::computeGeoPoints()
+{
+    arrays_.detourFactor = std::numeric_limits<double>::infinity();
+    arrays_.maxMilesPerHour = 0.0;
+
+    // One location without coordinates is enough to make every bound
+    // useless, since the bound toward it can't be measured at all.
+
+    std::vector<GeoPoint> points;
+
+    for (int i = 0; i < graph_.vertexCount(); ++i)
+    {
+        const Location& location = graph_.vertexInfo(graph_.toVertexNumber(i));
+
+        if (!location.hasCoordinates())
+        {
+            points.clear();
+            break;
+        }
+
+        points.push_back(toGeoPoint(location));
+    }
+
+    arrays_.points = std::move(points);
+
+    for (int i = 0; i < graph_.vertexCount(); ++i)
+    {
+        for (int e = graph_.edgeBegin(i); e < graph_.edgeEnd(i); ++e)
+        {
+            tightenBounds(i, e);
+        }
+    }
+
+    // A detour factor that no edge limited (because no two connected
+    // locations are apart) could otherwise make a bound infinite.
+    if (arrays_.detourFactor == std::numeric_limits<double>::infinity())
+    {
+        arrays_.detourFactor = 0.0;
+    }
+}
+
+
+void RoadNetwork::tightenBounds(int fromIndex, int position)
+{
+    const RoadSegment& segment = graph_.edgeInfoAt(position);
+
+    arrays_.maxMilesPerHour = std::max(arrays_.maxMilesPerHour, segment.milesPerHour);
+
+    if (hasCoordinates())
+    {
+        const SharedArray<GeoPoint>& points = arrays_.points;
+        double crowMiles = greatCircleMiles(points[fromIndex], points[graph_.edgeTarget(position)]);
+
+        if (crowMiles > 0.0)
+        {
+            arrays_.detourFactor = std::min(arrays_.detourFactor, segment.miles / crowMiles);
+        }
+    }
+}
+
+
+bool RoadNetwork::scaleLandmarks(double& scale, double oldWeight, double newWeight)
+{
+    if (newWeight < oldWeight)
+    {
+        scale *= newWeight / oldWeight;
+    }
+
+    // Written this way, a NaN scale fails too.
+    return scale > 0.0;
+}
+
@@ -0,0 +1,409 @@
+// RoadNetwork.hpp
+//
+// ICS 46 Spring 2016
+// Project #4: Rock and Roll Stops the Traffic
+//
+// A RoadNetwork is the form of a RoadMap that trips are routed on.  It
+// holds the RoadMap frozen into a CompactRoadMap, along with one column of
+// precomputed edge weights per TripMetric: the length of each road segment
+// in miles, and the time in hours it takes to drive it.  Each column is a
+// flat array indexed by edge position (see CompactDigraph.hpp), so a search
+// reads one double per edge instead of a whole RoadSegment, and searches
+// by driving time don't divide miles by speed for every edge they relax.
+//
+// The columns are kept in step with the road segments: the only way to
+// change a segment after the RoadNetwork is built is updateSegment(),
+// which refreshes both columns for that edge.
+//
+// Everything a RoadNetwork computes from its graph when it's built (the
+// columns, the GeoPoints and the figures that scale them, described
+// below) is kept in a RoadNetworkArrays, so a RoadNetwork whose arrays
+// were saved along with its graph, as in a binary road map, can be built
+// again without recomputing any of it.  The arrays may then be borrowed
+// from the saved file, and so may the names of its locations.
+//
+// The frozen RoadMap's incoming edges are indexed, too, so that a trip
+// can be routed by searching backward from its end vertex as well as
+// forward from its start (see RoutingEngine.hpp).
+//
+// If every location has coordinates, the RoadNetwork also keeps them as
+// GeoPoints, indexed like the vertices, so that a trip can be routed with
+// A*.  A great-circle distance becomes a lower bound on a route's weight
+// once it's scaled by two figures the RoadNetwork keeps up to date: the
+// smallest ratio of a road segment's length to the great-circle distance
+// between its ends (the "detour factor", which is at least one when the
+// coordinates are exact, but may be less when they're not), and the
+// highest speed on any road segment.  Scaled that way, the bound never
+// exceeds the weight of any road segment it spans, which is what A* needs
+// to find the same shortest routes that Dijkstra's algorithm does.
+//
+// A RoadNetwork can also hold a ContractionHierarchy per TripMetric, built
+// by buildHierarchies() or loaded along with a binary road map, so that
+// trips can be routed with the ContractionHierarchies engine.  Since the
+// hierarchies' shortcuts bake in the weights they were built from, any
+// call to updateSegment() discards them.
+//
+// Likewise, it can hold a LandmarkTable per TripMetric, for the Landmarks
+// engine.  Those survive updateSegment(): a segment that gets no lighter
+// leaves their bounds valid, and for one that does, the bounds for its
+// metric are scaled down by the ratio of its new weight to its old one.
+// A ratio of zero, as when a segment's length drops to zero or its speed
+// rises from zero, would leave no bound at all, so the tables are
+// discarded instead.
+//
+// Finally, it can hold HubLabels per TripMetric, which answer distance()
+// queries from the labels alone, without searching the road map.  Like
+// the hierarchies, they're discarded by updateSegment().
+
+#ifndef ROADNETWORK_HPP
+#define ROADNETWORK_HPP
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include "BidirectionalSearch.hpp"
+#include "ContractionHierarchy.hpp"
+#include "HubLabels.hpp"
+#include "LandmarkTable.hpp"
+#include "Location.hpp"
+#include "RoadMap.hpp"
+#include "RoutingEngine.hpp"
+#include "SharedArray.hpp"
+#include "ShortestPathSearch.hpp"
+#include "Trip.hpp"
+#include "TripMetric.hpp"
+
+
+
+// A RoadNetworkArrays holds what a RoadNetwork computes from its graph:
+// its weight columns, indexed by edge position; its GeoPoints, indexed
+// like its vertices, or none if any location lacks coordinates; and the
+// detour factor and highest speed that scale its GoalBounds.  The names
+// of its locations can be given here, too, as a NameOffsets and NameBytes
+// pair laid out the way a binary road map lays them out (see
+// BinaryRoadMapFormat.hpp), in which case the names in the graph's own
+// Locations are ignored; if there are no name offsets, those are used.
+
+struct RoadNetworkArrays
+{
+    SharedArray<double> distanceWeights;
+    SharedArray<double> timeWeights;
+    SharedArray<GeoPoint> points;
+    double detourFactor;
+    double maxMilesPerHour;
+    SharedArray<std::uint64_t> nameOffsets;
+    SharedArray<char> nameBytes;
+};
+
+
+
+class RoadNetwork
+{
+public:
+    // A MetricView presents a RoadNetwork to the searches in core (such
+    // as ShortestPathSearch) as a graph whose EdgeInfo is the precomputed
+    // weight of each edge for one TripMetric, so they should be run on it
+    // with PrecomputedWeight, which returns its argument.
+    struct PrecomputedWeight
+    {
+        double operator()(double weight) const
+        {
+            return weight;
+        }
+    };
+
+    class MetricView
+    {
+    public:
+        MetricView(const CompactRoadMap& graph, const SharedArray<double>& weights);
+
+        int vertexCount() const;
+        int toVertexNumber(int index) const;
+
+        template <typename Visit>
+        void forEachOutEdge(int index, Visit&& visit) const;
+
+        template <typename Visit>
+        void forEachInEdge(int index, Visit&& visit) const;
+
+    private:
+        const CompactRoadMap* graph_;
+        const SharedArray<double>* weights_;
+    };
+
+    // A GoalBound is the heuristic for an A* search toward one target
+    // vertex (see ShortestPathSearch::runToward()): given a vertex index,
+    // it returns a lower bound on the weight of any route from that
+    // vertex to the target, for one TripMetric.
+    class GoalBound
+    {
+    public:
+        GoalBound(const SharedArray<GeoPoint>& points, int targetIndex, double weightPerMile);
+
+        double operator()(int index) const;
+
+    private:
+        const GeoPoint* points_;
+        GeoPoint target_;
+        double weightPerMile_;
+    };
+
+public:
+    // The default constructor initializes an empty RoadNetwork.
+    RoadNetwork();
+
+    // This constructor builds a RoadNetwork from an already-frozen
+    // RoadMap, computing its weight columns and indexing its incoming
+    // edges.
+    explicit RoadNetwork(CompactRoadMap graph);
+
+    // This constructor freezes the given RoadMap and builds a RoadNetwork
+    // from it.
+    explicit RoadNetwork(const RoadMap& roadMap);
+
+    // This constructor builds a RoadNetwork from an already-frozen
+    // RoadMap and the arrays another RoadNetwork computed from it, which
+    // are used as they are; only their sizes and the names' offsets are
+    // checked.  The graph's incoming edges are indexed if they aren't
+    // already.  If the arrays don't match the graph, a DigraphException
+    // is thrown instead.
+    RoadNetwork(CompactRoadMap graph, RoadNetworkArrays arrays);
+
+    // graph() returns the frozen RoadMap this RoadNetwork is built on.
+    const CompactRoadMap& graph() const;
+
+    // arrays() returns what this RoadNetwork computed from its graph.
+    const RoadNetworkArrays& arrays() const;
+
+    // weights() returns the weight column for the given metric, indexed
+    // by edge position.
+    const SharedArray<double>& weights(TripMetric metric) const;
+
+    // locationName() returns the name of the location with the given
+    // vertex number, which remains valid as long as this RoadNetwork
+    // does.  If the vertex does not exist, a DigraphException is thrown
+    // instead.
+    std::string_view locationName(int vertex) const;
+
+    // view() returns a MetricView of this RoadNetwork for the given
+    // metric.  It remains valid as long as this RoadNetwork does.
+    MetricView view(TripMetric metric) const;
+
+    // hasCoordinates() returns true if every location in this RoadNetwork
+    // has coordinates, so that goalBound() returns a useful bound.
+    bool hasCoordinates() const;
+
+    // goalBound() returns a GoalBound toward the vertex with the given
+    // index for the given metric.  If hasCoordinates() is false, the
+    // bound is always zero.  It remains valid as long as this RoadNetwork
+    // does, but a route found with it after an updateSegment() call is
+    // only guaranteed to be shortest if the GoalBound was created after
+    // the call, too.
+    GoalBound goalBound(TripMetric metric, int targetIndex) const;
+
+    // buildHierarchies() builds a ContractionHierarchy for each metric,
+    // using the given number of threads (zero meaning one per hardware
+    // thread), replacing any this RoadNetwork already has.
+    void buildHierarchies(int threadCount = 0);
+
+    // setHierarchies() gives this RoadNetwork the given hierarchies, for
+    // the Distance and Time metrics respectively, which must have been
+    // built from its graph (e.g., by an earlier buildHierarchies() call
+    // whose results were saved).  If either has a different number of
+    // vertices than the graph, a DigraphException is thrown instead.
+    void setHierarchies(ContractionHierarchy distance, ContractionHierarchy time);
+
+    // hasHierarchies() returns true if this RoadNetwork has hierarchies,
+    // and hierarchy() returns the one for the given metric, which is
+    // empty if it doesn't.
+    bool hasHierarchies() const;
+    const ContractionHierarchy& hierarchy(TripMetric metric) const;
+
+    // buildLandmarks() builds a LandmarkTable with the given number of
+    // landmarks, chosen with the given strategy, for each metric,
+    // replacing any this RoadNetwork already has.
+    void buildLandmarks(
+        int landmarkCount = 16, LandmarkSelection selection = LandmarkSelection::Avoid);
+
+    // setLandmarks() gives this RoadNetwork the given landmark tables, for
+    // the Distance and Time metrics respectively, along with the scales
+    // of their bounds (see landmarkScale()).  The tables must have been
+    // built from its current weights, or from weights that were heavier
+    // by no more than the given scales allow.  If either table has a
+    // different number of vertices than the graph, or either scale isn't
+    // in (0, 1], a DigraphException is thrown instead.
+    void setLandmarks(
+        LandmarkTable distance, LandmarkTable time,
+        double distanceScale = 1.0, double timeScale = 1.0);
+
+    // hasLandmarks() returns true if this RoadNetwork has landmark tables,
+    // and landmarks() returns the one for the given metric, which is
+    // empty if it doesn't.
+    bool hasLandmarks() const;
+    const LandmarkTable& landmarks(TripMetric metric) const;
+
+    // landmarkBound() returns the heuristic for an A* search toward the
+    // vertex with the given index for the given metric, scaled as needed
+    // to stay valid after any updateSegment() calls.  If hasLandmarks()
+    // is false, the bound is always zero.  Like a GoalBound, a route found
+    // with it is only guaranteed to be shortest if it was created after
+    // the last updateSegment() call.
+    LandmarkTable::Bound landmarkBound(TripMetric metric, int targetIndex) const;
+
+    // landmarkScale() returns the scale of the landmark bounds for the
+    // given metric, which is 1 until updateSegment() makes an edge lighter
+    // than it was when the landmark tables were built.
+    double landmarkScale(TripMetric metric) const;
+
+    // buildHubLabels() builds HubLabels for each metric, taking the
+    // vertices in order of their ranks in that metric's hierarchy, which
+    // is built first (with the given number of threads) if this
+    // RoadNetwork has no hierarchies yet.  Any labels it already has are
+    // replaced.
+    void buildHubLabels(int threadCount = 0);
+
+    // setHubLabels() gives this RoadNetwork the given labels, for the
+    // Distance and Time metrics respectively, which must have been built
+    // from its current weights.  If either has a different number of
+    // vertices than the graph, a DigraphException is thrown instead.
+    void setHubLabels(HubLabels distance, HubLabels time);
+
+    // hasHubLabels() returns true if this RoadNetwork has labels, and
+    // hubLabels() returns the ones for the given metric, which are empty
+    // if it doesn't.
+    bool hasHubLabels() const;
+    const HubLabels& hubLabels(TripMetric metric) const;
+
+    // distance() returns the length of the shortest route from the vertex
+    // with the given start vertex number to the one with the given end
+    // vertex number for the given metric, or infinity if there is none.
+    // With hub labels, only the labels are read; without them, the road
+    // map is searched.  If either vertex does not exist, a
+    // DigraphException is thrown.
+    double distance(int startVertex, int endVertex, TripMetric metric) const;
+
+    // updateSegment() replaces the RoadSegment of the edge with the given
+    // "from" and "to" vertex numbers (e.g., because traffic has changed
+    // its speed), refreshes that edge's weights, discards the hierarchies
+    // and hub labels, and scales down the landmark bounds, as needed (or
+    // discards the landmark tables, if a bound would be scaled to zero).
+    // If there is no such edge, a DigraphException is thrown instead.
+    void updateSegment(int fromVertex, int toVertex, const RoadSegment& segment);
+
+    // findShortestPath() finds the shortest route for the given trip,
+    // using the weight column for the trip's metric and the given engine.
+    // If either of the trip's vertices does not exist, a DigraphException
+    // is thrown.
+    ShortestPath<RoadSegment> findShortestPath(
+        const Trip& trip, RoutingEngine engine = RoutingEngine::Dijkstra) const;
+
+    // This overload of findShortestPath() searches in the given
+    // SearchWorkspace, so that a caller routing many trips one at a time
+    // can reuse the same memory for all of them.
+    ShortestPath<RoadSegment> findShortestPath(
+        const Trip& trip, SearchWorkspace& workspace) const;
+
+    // This overload of findShortestPath() routes the trip with the given
+    // BidirectionalSearch, reusing its memory the same way.
+    ShortestPath<RoadSegment> findShortestPath(
+        const Trip& trip, BidirectionalSearch& search) const;
+
+    // This overload of findShortestPath() routes the trip with the given
+    // ContractionHierarchyQuery, reusing its memory the same way.  If
+    // hasHierarchies() is false, a DigraphException is thrown instead.
+    ShortestPath<RoadSegment> findShortestPath(
+        const Trip& trip, ContractionHierarchyQuery& query) const;
+
+private:
+    void computeWeights(int position);
+    void computeGeoPoints();
+
+    // tightenBounds() lowers the detour factor and raises the highest
+    // speed, as needed, so that the bounds cover the edge with the given
+    // position, whose "from" vertex has the given index.
+    void tightenBounds(int fromIndex, int position);
+
+    // scaleLandmarks() multiplies the given landmark bound scale by the
+    // ratio of the given new weight of an edge to its old one, if the new
+    // weight is lighter, returning false if the scale is no longer
+    // positive.
+    static bool scaleLandmarks(double& scale, double oldWeight, double newWeight);
+
+private:
+    CompactRoadMap graph_;
+    RoadNetworkArrays arrays_;
+    ContractionHierarchy distanceHierarchy_;
+    ContractionHierarchy timeHierarchy_;
+    LandmarkTable distanceLandmarks_;
+    LandmarkTable timeLandmarks_;
+    double distanceLandmarkScale_;
+    double timeLandmarkScale_;
+    HubLabels distanceLabels_;
+    HubLabels timeLabels_;
+};
+
+
+
+inline RoadNetwork::MetricView::MetricView(
+    const CompactRoadMap& graph, const SharedArray<double>& weights)
+    : graph_{&graph}, weights_{&weights}
+{
+}
+
+
+inline int RoadNetwork::MetricView::vertexCount() const
+{
+    return graph_->vertexCount();
+}
+
+
+inline int RoadNetwork::MetricView::toVertexNumber(int index) const
+{
+    return graph_->toVertexNumber(index);
+}
+
+
+// The weights are looked up through their SharedArray on each call, since
+// updateSegment() may have copied borrowed weights since the view was
+// made.
+
+template <typename Visit>
+void RoadNetwork::MetricView::forEachOutEdge(int index, Visit&& visit) const
+{
+    const double* weights = weights_->data();
+    int end = graph_->edgeEnd(index);
+
+    for (int e = graph_->edgeBegin(index); e < end; ++e)
+    {
+        visit(graph_->edgeTarget(e), weights[e]);
+    }
+}
+
+
+template <typename Visit>
+void RoadNetwork::MetricView::forEachInEdge(int index, Visit&& visit) const
+{
+    const double* weights = weights_->data();
+    int end = graph_->inEdgeEnd(index);
+
+    for (int slot = graph_->inEdgeBegin(index); slot < end; ++slot)
+    {
+        visit(graph_->inEdgeSource(slot), weights[graph_->inEdgePosition(slot)]);
+    }
+}
+
+
+inline double RoadNetwork::GoalBound::operator()(int index) const
+{
+    if (weightPerMile_ == 0.0)
+    {
+        return 0.0;
+    }
+
+    return greatCircleMiles(points_[index], target_) * weightPerMile_;
+}
+
+
+
+#endif // ROADNETWORK_HPP
+
@@ -0,0 +1,49 @@
+// RoutingEngine.hpp
+//
+// ICS 46 Spring 2016
+// Project #4: Rock and Roll Stops the Traffic
+//
+// A RoutingEngine describes which search algorithm is used to find the
+// shortest route for a trip.  Every engine finds a route of the same
+// (shortest) length, for either TripMetric; they differ only in how much
+// of the road map they have to explore to find it.
+//
+// * Dijkstra searches forward from the start vertex alone, and is the
+//   only engine that can answer a whole group of trips sharing a start
+//   vertex with one search.
+// * Bidirectional searches forward from the start vertex and backward
+//   from the end vertex at the same time (see BidirectionalSearch.hpp).
+// * AStar searches forward from the start vertex, drawn toward the end
+//   vertex by a lower bound on the remaining distance or time, which is
+//   derived from the great-circle distance between the locations'
+//   coordinates.  If any location has no coordinates, there is no bound,
+//   and AStar explores exactly what Dijkstra does.
+// * ContractionHierarchies searches upward from both the start and end
+//   vertices in the RoadNetwork's contraction hierarchy for the trip's
+//   metric (see ContractionHierarchy.hpp), which explores only a tiny
+//   part of the road map.  If the RoadNetwork has no hierarchies, it
+//   falls back to Dijkstra.
+// * Landmarks searches forward from the start vertex like AStar does, but
+//   draws the search toward the end vertex with the lower bounds given by
+//   the RoadNetwork's landmark tables (see LandmarkTable.hpp), which need
+//   no coordinates.  If the RoadNetwork has no landmark tables, there is
+//   no bound, and Landmarks explores exactly what Dijkstra does.
+
+#ifndef ROUTINGENGINE_HPP
+#define ROUTINGENGINE_HPP
+
+
+
+enum class RoutingEngine
+{
+    Dijkstra,
+    Bidirectional,
+    AStar,
+    ContractionHierarchies,
+    Landmarks
+};
+
+
+
+#endif // ROUTINGENGINE_HPP
+
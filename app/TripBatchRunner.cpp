@@ -0,0 +1,37 @@
+// TripBatchRunner.cpp
+//
+// ICS 46 Spring 2016
+// Project #4: Rock and Roll Stops the Traffic
+
+#include "TripBatchRunner.hpp"
+#include "TripGroupRouter.hpp"
+
+
+TripBatchRunner::TripBatchRunner(const RoadNetwork& network, RoutingEngine engine)
+    : network_{network}, engine_{engine}, searchCount_{0}
+{
+}
+
+
+std::vector<ShortestPath<RoadSegment>> TripBatchRunner::run(const std::vector<Trip>& trips)
+{
+    std::vector<TripGroup> groups = TripGroupRouter::groupTrips(network_, trips);
+    std::vector<ShortestPath<RoadSegment>> routes(trips.size());
+
+    TripGroupRouter router{network_, engine_};
+
+    for (const TripGroup& group : groups)
+    {
+        router.route(group, routes);
+    }
+
+    searchCount_ = static_cast<int>(groups.size());
+    return routes;
+}
+
+
+int TripBatchRunner::searchCount() const
+{
+    return searchCount_;
+}
+
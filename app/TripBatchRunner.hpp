@@ -0,0 +1,51 @@
+// TripBatchRunner.hpp
+//
+// ICS 46 Spring 2016
+// Project #4: Rock and Roll Stops the Traffic
+//
+// A TripBatchRunner finds the shortest routes for a whole sequence of trips
+// at once.  Trips that share a start vertex and a TripMetric are grouped
+// together, and each group is answered by a single search from the shared
+// start vertex, which stops once every end vertex in the group has been
+// settled.  The routes are returned in the same order as the trips, so the
+// grouping is invisible to the caller except in how long it takes.
+
+#ifndef TRIPBATCHRUNNER_HPP
+#define TRIPBATCHRUNNER_HPP
+
+#include <vector>
+#include "RoadNetwork.hpp"
+#include "RoutingEngine.hpp"
+#include "Trip.hpp"
+
+
+
+class TripBatchRunner
+{
+public:
+    // Initializes a TripBatchRunner that routes trips on the given
+    // RoadNetwork, which must outlive it, using the given engine.
+    explicit TripBatchRunner(
+        const RoadNetwork& network, RoutingEngine engine = RoutingEngine::Dijkstra);
+
+    // run() finds the shortest route for each of the given trips,
+    // returning them in the same order.  If any trip's start or end
+    // vertex does not exist, a DigraphException is thrown before any
+    // searching is done.
+    std::vector<ShortestPath<RoadSegment>> run(const std::vector<Trip>& trips);
+
+    // searchCount() returns the number of searches the last call to run()
+    // needed, which is the number of distinct (start vertex, metric)
+    // pairs among its trips.
+    int searchCount() const;
+
+private:
+    const RoadNetwork& network_;
+    RoutingEngine engine_;
+    int searchCount_;
+};
+
+
+
+#endif // TRIPBATCHRUNNER_HPP
+
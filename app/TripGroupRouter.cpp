@@ -0,0 +1,169 @@
+// TripGroupRouter.cpp
+//
+// ICS 46 Spring 2016
+// Project #4: Rock and Roll Stops the Traffic
+
+#include <algorithm>
+#include "TripGroupRouter.hpp"
+
+
+std::vector<TripGroup> TripGroupRouter::groupTrips(
+    const RoadNetwork& network, const std::vector<Trip>& trips)
+{
+    const CompactRoadMap& graph = network.graph();
+
+    std::vector<int> order(trips.size());
+    std::vector<int> startIndexes(trips.size());
+    std::vector<int> endIndexes(trips.size());
+
+    for (unsigned int i = 0; i < trips.size(); ++i)
+    {
+        order[i] = i;
+        startIndexes[i] = graph.toIndex(trips[i].startVertex);
+        endIndexes[i] = graph.toIndex(trips[i].endVertex);
+    }
+
+    std::sort(
+        order.begin(), order.end(),
+        [&](int a, int b)
+        {
+            if (startIndexes[a] != startIndexes[b])
+            {
+                return startIndexes[a] < startIndexes[b];
+            }
+            else if (trips[a].metric != trips[b].metric)
+            {
+                return trips[a].metric < trips[b].metric;
+            }
+            else
+            {
+                return a < b;
+            }
+        });
+
+    std::vector<TripGroup> groups;
+
+    for (int i : order)
+    {
+        if (groups.empty()
+            || groups.back().startIndex != startIndexes[i]
+            || groups.back().metric != trips[i].metric)
+        {
+            groups.push_back(TripGroup{startIndexes[i], trips[i].metric, {}});
+        }
+
+        groups.back().targets.push_back(TripGroup::Target{endIndexes[i], i});
+    }
+
+    return groups;
+}
+
+
+TripGroupRouter::TripGroupRouter(const RoadNetwork& network, RoutingEngine engine)
+    : network_{network}, engine_{engine},
+      targetCounts_(network.graph().vertexCount(), 0)
+{
+}
+
+
+void TripGroupRouter::route(
+    const TripGroup& group, std::vector<ShortestPath<RoadSegment>>& routes)
+{
+    if (engine_ == RoutingEngine::ContractionHierarchies && network_.hasHierarchies())
+    {
+        const ContractionHierarchy& hierarchy = network_.hierarchy(group.metric);
+
+        for (const TripGroup::Target& target : group.targets)
+        {
+            hierarchyQuery_.run(hierarchy, group.startIndex, target.endIndex);
+            routes[target.position] = hierarchyQuery_.path<RoadSegment>(hierarchy, network_.graph());
+        }
+
+        return;
+    }
+
+    if ((engine_ == RoutingEngine::Bidirectional || engine_ == RoutingEngine::AStar
+         || engine_ == RoutingEngine::Landmarks)
+        && hasOneEnd(group))
+    {
+        int endIndex = group.targets.front().endIndex;
+        ShortestPath<RoadSegment> path;
+
+        if (engine_ == RoutingEngine::Bidirectional)
+        {
+            bidirectionalSearch_.run(
+                network_.view(group.metric), group.startIndex, endIndex,
+                RoadNetwork::PrecomputedWeight{});
+
+            path = bidirectionalSearch_.path<RoadSegment>(network_.graph());
+        }
+        else if (engine_ == RoutingEngine::AStar)
+        {
+            search_.runToward(
+                network_.view(group.metric), group.startIndex, endIndex,
+                RoadNetwork::PrecomputedWeight{}, network_.goalBound(group.metric, endIndex));
+
+            path = search_.pathTo<RoadSegment>(network_.graph(), endIndex);
+        }
+        else
+        {
+            search_.runToward(
+                network_.view(group.metric), group.startIndex, endIndex,
+                RoadNetwork::PrecomputedWeight{}, network_.landmarkBound(group.metric, endIndex));
+
+            path = search_.pathTo<RoadSegment>(network_.graph(), endIndex);
+        }
+
+        for (const TripGroup::Target& target : group.targets)
+        {
+            routes[target.position] = path;
+        }
+
+        return;
+    }
+
+    int remaining = 0;
+
+    for (const TripGroup::Target& target : group.targets)
+    {
+        if (targetCounts_[target.endIndex]++ == 0)
+        {
+            ++remaining;
+        }
+    }
+
+    search_.runUntil(
+        network_.view(group.metric), group.startIndex,
+        RoadNetwork::PrecomputedWeight{},
+        [&](int settled)
+        {
+            if (targetCounts_[settled] > 0)
+            {
+                targetCounts_[settled] = 0;
+                --remaining;
+            }
+
+            return remaining == 0;
+        });
+
+    for (const TripGroup::Target& target : group.targets)
+    {
+        targetCounts_[target.endIndex] = 0;
+        routes[target.position] = search_.pathTo<RoadSegment>(network_.graph(), target.endIndex);
+    }
+}
+
+
+bool TripGroupRouter::hasOneEnd(const TripGroup& group)
+{
+    for (const TripGroup::Target& target : group.targets)
+    {
+        if (target.endIndex != group.targets.front().endIndex)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
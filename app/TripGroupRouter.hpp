@@ -0,0 +1,96 @@
+// TripGroupRouter.hpp
+//
+// ICS 46 Spring 2016
+// Project #4: Rock and Roll Stops the Traffic
+//
+// Trips that share a start vertex and a TripMetric can all be answered by
+// one search from that start vertex, which stops once every one of their
+// end vertices has been settled.  A TripGroup describes such a set of
+// trips, and a TripGroupRouter answers TripGroups.
+//
+// A TripGroupRouter owns all of the memory its searches need (distances,
+// predecessors, the heap, and so on), and reuses it from one group to the
+// next, so a thread that routes many groups should hold on to one.  It
+// only ever reads its RoadNetwork, so any number of TripGroupRouters in
+// different threads can share the same RoadNetwork.
+//
+// A TripGroupRouter can be told to use the Bidirectional, AStar or
+// Landmarks RoutingEngine, in which case a group whose trips all share an
+// end vertex as well (so that it amounts to a single query) is answered by
+// a BidirectionalSearch or an A* search instead.  Any other group still
+// needs the one-to-many search.  The ContractionHierarchies engine, on the
+// other hand, answers every group one trip at a time, since a query in a
+// hierarchy costs so much less than a search of the whole road map, as
+// long as the RoadNetwork has hierarchies; if it doesn't, the engine falls
+// back to the one-to-many search.
+
+#ifndef TRIPGROUPROUTER_HPP
+#define TRIPGROUPROUTER_HPP
+
+#include <vector>
+#include "BidirectionalSearch.hpp"
+#include "ContractionHierarchy.hpp"
+#include "RoadNetwork.hpp"
+#include "RoutingEngine.hpp"
+#include "ShortestPathSearch.hpp"
+#include "Trip.hpp"
+
+
+
+// A TripGroup lists the dense index of the shared start vertex, the shared
+// metric, and for each trip in the group, the dense index of its end
+// vertex and its position in the sequence of trips it came from.
+
+struct TripGroup
+{
+    struct Target
+    {
+        int endIndex;
+        int position;
+    };
+
+    int startIndex;
+    TripMetric metric;
+    std::vector<Target> targets;
+};
+
+
+
+class TripGroupRouter
+{
+public:
+    // groupTrips() divides the given trips into TripGroups, ordered by
+    // start vertex index and then by metric.  If any trip's start or end
+    // vertex does not exist in the given RoadNetwork, a DigraphException
+    // is thrown.
+    static std::vector<TripGroup> groupTrips(
+        const RoadNetwork& network, const std::vector<Trip>& trips);
+
+    // Initializes a TripGroupRouter that routes trips on the given
+    // RoadNetwork, which must outlive it, using the given engine.
+    explicit TripGroupRouter(
+        const RoadNetwork& network, RoutingEngine engine = RoutingEngine::Dijkstra);
+
+    // route() finds the shortest route for every trip in the given group
+    // with a single search, storing each one into routes at the trip's
+    // position.
+    void route(const TripGroup& group, std::vector<ShortestPath<RoadSegment>>& routes);
+
+private:
+    // hasOneEnd() returns true if every trip in the given group has the
+    // same end vertex.
+    static bool hasOneEnd(const TripGroup& group);
+
+private:
+    const RoadNetwork& network_;
+    RoutingEngine engine_;
+    ShortestPathSearch search_;
+    BidirectionalSearch bidirectionalSearch_;
+    ContractionHierarchyQuery hierarchyQuery_;
+    std::vector<int> targetCounts_;
+};
+
+
+
+#endif // TRIPGROUPROUTER_HPP
+
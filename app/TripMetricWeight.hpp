@@ -0,0 +1,67 @@
+// TripMetricWeight.hpp
+//
+// ICS 46 Spring 2016
+// Project #4: Rock and Roll Stops the Traffic
+//
+// TripMetricWeight is a family of function objects that compute the weight
+// of a RoadSegment for each TripMetric: its length in miles for
+// TripMetric::Distance, and the number of hours it takes to drive for
+// TripMetric::Time.  Because each one is its own type, passing one to
+// findShortestPath() or findShortestPaths() lets the compiler inline the
+// weight computation into the search.
+
+#ifndef TRIPMETRICWEIGHT_HPP
+#define TRIPMETRICWEIGHT_HPP
+
+#include "RoadSegment.hpp"
+#include "TripMetric.hpp"
+
+
+
+template <TripMetric metric>
+struct TripMetricWeight;
+
+
+template <>
+struct TripMetricWeight<TripMetric::Distance>
+{
+    double operator()(const RoadSegment& segment) const
+    {
+        return segment.miles;
+    }
+};
+
+
+template <>
+struct TripMetricWeight<TripMetric::Time>
+{
+    double operator()(const RoadSegment& segment) const
+    {
+        return segment.miles / segment.milesPerHour;
+    }
+};
+
+
+
+// withTripMetricWeight() calls func with the TripMetricWeight for the given
+// metric and returns whatever it returns.  This turns a metric that's only
+// known at run time (such as one read from a Trip) into a weight function
+// whose type is known at compile time; func is typically a generic lambda.
+
+template <typename Func>
+auto withTripMetricWeight(TripMetric metric, Func&& func)
+{
+    if (metric == TripMetric::Time)
+    {
+        return func(TripMetricWeight<TripMetric::Time>{});
+    }
+    else
+    {
+        return func(TripMetricWeight<TripMetric::Distance>{});
+    }
+}
+
+
+
+#endif // TRIPMETRICWEIGHT_HPP
+
@@ -5,6 +5,7 @@
 
 #include <sstream>
 #include <string>
+#include "InputException.hpp"
 #include "TripReader.hpp"
 
 
@@ -14,6 +15,11 @@ std::vector<Trip> TripReader::readTrips(InputReader& in)
 
     int numberOfTrips = in.readIntLine();
 
+    if (numberOfTrips < 0)
+    {
+        throw InputException{"negative number of trips"};
+    }
+
     for (int i = 0; i < numberOfTrips; ++i)
     {
         std::istringstream tripLine{in.readLine()};
@@ -32,3 +38,33 @@ std::vector<Trip> TripReader::readTrips(InputReader& in)
     return trips;
 }
 
+
+std::vector<Trip> TripReader::readTrips(MappedInputReader& in)
+{
+    std::vector<Trip> trips;
+
+    int numberOfTrips = in.readIntLine();
+
+    if (numberOfTrips < 0)
+    {
+        throw InputException{"negative number of trips"};
+    }
+
+    trips.reserve(numberOfTrips);
+
+    for (int i = 0; i < numberOfTrips; ++i)
+    {
+        LineFields tripLine{in.readLine()};
+
+        int fromVertex = tripLine.readInt();
+        int toVertex = tripLine.readInt();
+        std::string_view metricType = tripLine.readWord();
+
+        trips.push_back(
+            {fromVertex, toVertex,
+             metricType == "D" ? TripMetric::Distance : TripMetric::Time});
+    }
+
+    return trips;
+}
+
@@ -12,6 +12,7 @@
 #include <vector>
 #include "Trip.hpp"
 #include "InputReader.hpp"
+#include "MappedInputReader.hpp"
 
 
 
@@ -19,8 +20,15 @@ class TripReader
 {
 public:
     // readTrips() reads a sequence of trips from the given input,
-    // returning them as a vector of Trip structs.
-    std::vector<Trip> readTrips(InputReader& in);    
+    // returning them as a vector of Trip structs.  If the number of trips
+    // is negative, an InputException is thrown.
+    std::vector<Trip> readTrips(InputReader& in);
+
+    // This overload of readTrips() reads the trips from the given
+    // MappedInputReader, parsing each line in place.  If the input ends
+    // too soon, a number is malformed or the number of trips is negative,
+    // an InputException is thrown.
+    std::vector<Trip> readTrips(MappedInputReader& in);
 };
 
 
@@ -0,0 +1,96 @@
+// TripReportWriter.cpp
+//
+// ICS 46 Spring 2016
+// Project #4: Rock and Roll Stops the Traffic
+
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include "TripReportWriter.hpp"
+
+
+namespace
+{
+    // formatTime() turns a number of hours into text like "1 hr 2 mins
+    // 3.4 secs", leaving out any leading units that would be zero.
+    std::string formatTime(double hours)
+    {
+        double seconds = hours * 3600.0;
+        int wholeHours = static_cast<int>(seconds / 3600.0);
+        seconds -= wholeHours * 3600.0;
+        int wholeMinutes = static_cast<int>(seconds / 60.0);
+        seconds -= wholeMinutes * 60.0;
+
+        std::ostringstream out;
+        out << std::fixed << std::setprecision(1);
+
+        if (wholeHours > 0)
+        {
+            out << wholeHours << (wholeHours == 1 ? " hr " : " hrs ");
+        }
+
+        if (wholeHours > 0 || wholeMinutes > 0)
+        {
+            out << wholeMinutes << (wholeMinutes == 1 ? " min " : " mins ");
+        }
+
+        out << seconds << " secs";
+        return out.str();
+    }
+}
+
+
+void TripReportWriter::writeTrip(
+    std::ostream& out, const RoadNetwork& network, const Trip& trip,
+    const ShortestPath<RoadSegment>& path)
+{
+    bool byTime = trip.metric == TripMetric::Time;
+
+    out << (byTime ? "Shortest driving time from " : "Shortest distance from ")
+        << network.locationName(trip.startVertex) << " to "
+        << network.locationName(trip.endVertex) << std::endl;
+
+    if (path.vertices.empty())
+    {
+        out << "  No route exists" << std::endl << std::endl;
+        return;
+    }
+
+    out << std::fixed << std::setprecision(1);
+    out << "  Begin at " << network.locationName(path.vertices.front()) << std::endl;
+
+    double totalMiles = 0.0;
+    double totalHours = 0.0;
+
+    for (unsigned int i = 0; i < path.edges.size(); ++i)
+    {
+        const RoadSegment& segment = path.edges[i];
+        double hours = segment.miles / segment.milesPerHour;
+
+        totalMiles += segment.miles;
+        totalHours += hours;
+
+        out << "  Continue to " << network.locationName(path.vertices[i + 1])
+            << " (" << segment.miles << " miles";
+
+        if (byTime)
+        {
+            out << " @ " << segment.milesPerHour << "mph = " << formatTime(hours);
+        }
+
+        out << ")" << std::endl;
+    }
+
+    if (byTime)
+    {
+        out << "Total time: " << formatTime(totalHours) << std::endl;
+    }
+    else
+    {
+        out << "Total distance: " << totalMiles << " miles" << std::endl;
+    }
+
+    out << std::endl;
+}
+
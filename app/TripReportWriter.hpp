@@ -0,0 +1,35 @@
+// TripReportWriter.hpp
+//
+// ICS 46 Spring 2016
+// Project #4: Rock and Roll Stops the Traffic
+//
+// The TripReportWriter class writes a human-readable description of the
+// route chosen for a trip: each location along the way, the distance (and,
+// for trips that minimize driving time, the speed and time) of each road
+// segment, and the trip's total distance or driving time.
+
+#ifndef TRIPREPORTWRITER_HPP
+#define TRIPREPORTWRITER_HPP
+
+#include <ostream>
+#include "RoadNetwork.hpp"
+#include "Trip.hpp"
+
+
+
+class TripReportWriter
+{
+public:
+    // writeTrip() writes a description of the given trip to the given
+    // output stream, assuming it followed the given path through the
+    // given RoadNetwork.  If the path is empty, the trip is reported as
+    // having no route.
+    void writeTrip(
+        std::ostream& out, const RoadNetwork& network, const Trip& trip,
+        const ShortestPath<RoadSegment>& path);
+};
+
+
+
+#endif // TRIPREPORTWRITER_HPP
+
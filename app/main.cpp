@@ -4,233 +4,220 @@
 // Project #4: Rock and Roll Stops the Traffic
 //
 // This is the program's main() function, which is the entry point for your
-// console user interface.
-#include <iostream>
+// console user interface.  It reads a RoadMap and a sequence of trips from
+// the standard input, finds the shortest route for each trip (by distance
+// or by driving time, as each trip requests), and describes each route on
+// the standard output.
+//
+// If the name of an input file is given on the command line, the input is
+// read from that file instead, by mapping it into memory and parsing it in
+// place (with the road segments parsed on several threads), which is much
+// faster for large road maps.  If that file is a binary road map (see
+// BinaryRoadMapFormat.hpp), the road map is loaded from it without parsing
+// at all, and only the trips are read from the standard input.
+//
+// Running the program as "a.out.app --write-binary FILE" reads a road map
+// from the standard input and writes it to FILE as a binary road map.
+// Adding "--hierarchies" builds a contraction hierarchy for each metric
+// and saves them in FILE, too; trips routed on a binary road map that has
+// them are routed with the ContractionHierarchies engine.  Similarly,
+// adding "--landmarks" builds and saves a landmark table for each metric,
+// and trips routed on a binary road map that has those but no hierarchies
+// are routed with the Landmarks engine.  Adding "--hub-labels" builds and
+// saves hub labels for each metric, building the hierarchies they're
+// ordered by, too, so that RoadNetwork::distance() answers from them.
+
 #include <fstream>
-#include "InputReader.hpp"
-#include "RoadMapReader.hpp"
+#include <iostream>
+#include <memory>
 #include <string>
 #include <vector>
-#include <map>
-#include <set>
-#include "RoadSegment.hpp"
-#include "Digraph.hpp"
-/*
-#include "RoadMapReader.cpp"
-#include "RoadMapWriter.cpp"
-#include "RoadSegment.hpp"
+#include "BinaryRoadMapReader.hpp"
+#include "BinaryRoadMapWriter.hpp"
+#include "InputException.hpp"
+#include "InputReader.hpp"
+#include "MappedFile.hpp"
+#include "MappedInputReader.hpp"
+#include "ParallelRoadMapReader.hpp"
+#include "ParallelTripRunner.hpp"
+#include "RoadMap.hpp"
+#include "RoadMapReader.hpp"
+#include "RoadNetwork.hpp"
+#include "RoutingEngine.hpp"
 #include "Trip.hpp"
-#include "TripMetric.hpp"
-#include "TripReader.cpp"
-*/
-void open_f()
-{
-	
-	//int lines=10;
-	std::string str;
-	int a;
-	std::cin>>str;
-	//std::string str;
-	InputReader inpt(std::cin);
-	//int x;
-	//for(int i=0;i<20;++i)
-	//while(!str.eof())
-	//while(inpt.readLine())
-	//while(std::cin.good())
-	//
-
-	inpt.readLine();
-	for(int i=0; i<3;++i)
-	{
-		//inpt.readLine();
-		a=inpt.readIntLine();
-		//std::cout<<"a: "<<a<<std::endl;
-		for(int j=0; j<a;++j)
-		{
-			std::cout<<inpt.readLine()<<std::endl;
-		}
-	}
-	//while(true)//while
-	
-	return;
-
-	//for (int i=0; i<20; ++i)
-	//{
-	//	std::getline(std::cin,str);
-	//	std::cout<<i<<std::endl;
-	//	std::cout<<str<<std::endl;
-	//}
-	/*
-	std::ofstream myfile;
-	try
-	{
-		myfile.open("sample.txt");
-	}
-	catch(...)
-	{
-		if(myfile.is_open())
-			myfile.close();
-	}
-	//InputReader inpt{myfile};
-	
-	//char outpt[1000];
-	//InputReader::readLine();
-	//while(!myfile.eof())
-	//{
-	//	myfile>>outpt;
-	//	std::cout<<outpt<<std::endl;
-	//}
-	
-	//std::cout<<inpt.read<<std::endl;
-*/
-}
-template <typename T>
-T weight(T a,T b)
-{
-	return b+a;
-}
-//template<typename EdgeInfo>
-double weight2(const RoadSegment& rs)
-{	
+#include "TripReader.hpp"
+#include "TripReportWriter.hpp"
 
-	return rs.miles;//-rs.milesPerHour;
-}
-void test_weight()
-{
-	double x,y;
-	x=3.4;
-	y=5.3;
-	int s,t;
-	s=3;
-	t=4;
-	std::cout<<weight<int>(s,t)<<std::endl;
-	std::cout<<weight<double>(x,y)<<std::endl;
-}
-void exception_test(RoadMap& rmap)
+
+namespace
 {
-	std::vector<std::pair<int,int>> _edges; //from and to edges of a vertex
-
-	_edges=rmap.edges(100);
-	_edges=rmap.edges(3);
-	rmap.vertexInfo(30);
-	rmap.vertexInfo(7);
-	rmap.edgeInfo(10,22);
-	rmap.edgeInfo(22,22);
-	rmap.edgeInfo(14,8);
-	//rmap.removeVertex(0);
-	rmap.addVertex(0, "whatever");
-	std::cout<<rmap.vertexInfo(0)<<std::endl;
-	rmap.addEdge(0, 1, RoadSegment{double (3.4), double (3.2)});
-	rmap.removeVertex(100);
-	rmap.removeVertex(0);
-	rmap.vertexInfo(0);
-	rmap.removeEdge(0, 1);
-	rmap.removeEdge(1, 20);
-	rmap.removeEdge(1,2);
-	rmap.edgeInfo(1,2);//<<std::endl;
+    int routeTrips(const RoadNetwork& network, const std::vector<Trip>& trips)
+    {
+        TripReportWriter writer;
+
+        RoutingEngine engine = RoutingEngine::Dijkstra;
+
+        if (network.hasHierarchies())
+        {
+            engine = RoutingEngine::ContractionHierarchies;
+        }
+        else if (network.hasLandmarks())
+        {
+            engine = RoutingEngine::Landmarks;
+        }
+
+        try
+        {
+            std::vector<ShortestPath<RoadSegment>> routes =
+                ParallelTripRunner{network, 0, engine}.run(trips);
+
+            for (unsigned int i = 0; i < trips.size(); ++i)
+            {
+                writer.writeTrip(std::cout, network, trips[i], routes[i]);
+            }
+        }
+        catch (DigraphException& e)
+        {
+            std::cout << "Cannot route trips: " << e.reason() << std::endl;
+            return 1;
+        }
+
+        return 0;
+    }
+
+
+    int writeBinaryRoadMap(
+        const std::string& path, bool withHierarchies, bool withLandmarks, bool withHubLabels)
+    {
+        InputReader in{std::cin};
+        RoadNetwork network{RoadMapReader{}.readRoadMap(in)};
+
+        if (withHierarchies)
+        {
+            network.buildHierarchies();
+        }
+
+        if (withLandmarks)
+        {
+            network.buildLandmarks();
+        }
+
+        if (withHubLabels)
+        {
+            network.buildHubLabels();
+        }
+
+        std::ofstream out{path, std::ios::binary};
+        BinaryRoadMapWriter{}.writeRoadMap(out, network);
+
+        if (!out)
+        {
+            std::cout << "Cannot write " << path << std::endl;
+            return 1;
+        }
+
+        return 0;
+    }
+
+
+    int routeTripsFromFile(const std::string& path)
+    {
+        // A binary road map is searched in place for as long as the
+        // program runs, so it's mapped for random access; a text file is
+        // mapped again for a single pass once it turns out not to be one.
+        std::shared_ptr<const MappedFile> file =
+            std::make_shared<MappedFile>(path, MappedFile::Access::Random);
+
+        if (BinaryRoadMapReader::isBinaryRoadMap(*file))
+        {
+            RoadNetwork network = BinaryRoadMapReader{}.readRoadNetwork(file);
+
+            InputReader in{std::cin};
+            std::vector<Trip> trips = TripReader{}.readTrips(in);
+
+            return routeTrips(network, trips);
+        }
+
+        file = std::make_shared<MappedFile>(path, MappedFile::Access::Sequential);
+        MappedInputReader in{file->begin(), file->end()};
+
+        RoadNetwork network{ParallelRoadMapReader{}.readRoadMap(in)};
+        std::vector<Trip> trips = TripReader{}.readTrips(in);
+
+        return routeTrips(network, trips);
+    }
+
+
+    int routeTripsFromStandardInput()
+    {
+        InputReader in{std::cin};
+
+        RoadNetwork network{RoadMapReader{}.readRoadMap(in)};
+        std::vector<Trip> trips = TripReader{}.readTrips(in);
+
+        return routeTrips(network, trips);
+    }
+
+
+    int run(int argc, char* argv[])
+    {
+        if (argc >= 3 && std::string{argv[1]} == "--write-binary")
+        {
+            bool withHierarchies = false;
+            bool withLandmarks = false;
+            bool withHubLabels = false;
+
+            for (int i = 3; i < argc; ++i)
+            {
+                std::string option{argv[i]};
+
+                if (option == "--hierarchies")
+                {
+                    withHierarchies = true;
+                }
+                else if (option == "--landmarks")
+                {
+                    withLandmarks = true;
+                }
+                else if (option == "--hub-labels")
+                {
+                    withHubLabels = true;
+                }
+                else
+                {
+                    std::cout << "Unknown option " << option << std::endl;
+                    return 1;
+                }
+            }
+
+            return writeBinaryRoadMap(argv[2], withHierarchies, withLandmarks, withHubLabels);
+        }
+
+        if (argc > 1)
+        {
+            return routeTripsFromFile(argv[1]);
+        }
+
+        return routeTripsFromStandardInput();
+    }
 }
-//template <typename VertexInfo, typename EdgeInfo>
-int main()
-{
 
-	//std::cout<<"--------hello from main"<<std::endl;
-	//open_f();
-	//std::string str;
-	//int a;
-	//std::cin>>str;
-	//std::string str;
-
-	InputReader inpt(std::cin);
-	//inpt.readLine();
-	RoadMapReader map;
-	RoadMap rmap=map.readRoadMap(inpt);
-	
-	std::vector<int> vertxx;
-	//std::map<int, std::vector<int, int>> kdv; //vertices: best distance so far, visited or not
-	std::map<int, bool> visited; //visited kv
-	std::map<int, int> top; // dv
-	std::map<int,int> pv; //predecessors 
-
-	vertxx=rmap.vertices();
-
-
-	for(auto& v: vertxx)
-	{
-		//std::cout<<v<<std::endl;
-		visited.insert(std::make_pair(v, false));
-		top.insert(std::make_pair(v, 99999));
-		pv.insert(std::make_pair(v, 0));
-
-		//kdv.push_back(std::make_pair(v, std::make_pair(9999, false)));
-		//pv.push_back(v, NULL);
-	}
-	//std::vector<std::pair<int,int>> _edges; //from and to edges of a vertex
-
-	// pv[vertxx[0]]=-1;
-	// top[vertxx[0]]=0;
-	//for(auto& v:vertxx)
-	//{
-		//_edges=rmap.edges(v);
-
-		//for(auto& e: _edges)
-		//{
-	std::map<int, int> shortest;
-
-	shortest=rmap.findShortestPaths(vertxx[0], (weight2));
-	for(auto s: shortest)
-	{
-		std::cout<<"first: "<<s.first<<" second: "<<s.second<<std::endl;
-		//}
-	}
-	std::cout<<rmap.isStronglyConnected()<<std::endl;
-	//RoadMap new_map=rmap;
-	//exception_test(new_map);
-	//}
-
-
-	//std::cout<<rmap.vertexInfo(30).vinfo<<std::endl;
-	//std::cout<<rmap.vertexInfo(13).vinfo<<std::endl;
-
-	//std::cout<<"after edge[0]: "<<rmap.edges(0)<<std::endl;
-	//std::cout<<"after edge[1]: "<<rmap.edges(1)<<std::endl;
-
-	//std::cout<<map.EdgeInfo<<std::endl;
-
-
-	std::cout<<"done!"<<std::endl;
-    return 0;
-}
-double func(const RoadSegment& rs){ return 3.4;}
 
-void test_map(RoadMap rmap)
+int main(int argc, char* argv[])
 {
-	/*
-	std::cout<<"edgecount: "<<rmap.edgeCount()<<std::endl;
-	std::cout<<"vertexcout: "<<rmap.vertexCount()<<std::endl;
-	rmap.removeVertex(0);
-	std::cout<<"aftervertexcout: "<<rmap.vertexCount()<<std::endl;
-	rmap.removeVertex(0);
-	//std::vector<std::pair<int, int>> vect;
-	
-	rmap.removeEdge(0,0);
-	rmap.removeEdge(1,0);
-	vect=rmap.edges(2);
-	vect=rmap.edges();
-	std::cout<<rmap.vertexInfo(2)<<std::endl;
-	//EdgeInfo ei;
-	//ei=rmap.edgeInfo(1,4);
-	std::cout<<rmap.edgeInfo(1,4).miles<<"	"<<rmap.edgeInfo(1,4).milesPerHour<<std::endl;
-	std::cout<<rmap.edgeInfo(0,0).miles<<"	"<<rmap.edgeInfo(0,0).milesPerHour<<std::endl;
-	//std::vector<int> vect=rmap.edges(0);
-	
-	std::vector<int,int> vect=rmap.edges(0);
-
-
-	for(int i=0; i<rmap.edges(0).size();++i)
-	{
-		std::cout<<"edge[0]: "<<vect[i]<<std::endl;
-		//std::cout<<"edge[1]: "<<rmap.edges(1)<<std::endl;
-	}
-	*/
+    try
+    {
+        return run(argc, argv);
+    }
+    catch (InputException& e)
+    {
+        std::cout << "Cannot read input: " << e.reason() << std::endl;
+        return 1;
+    }
+    catch (DigraphException& e)
+    {
+        std::cout << "Cannot read road map: " << e.reason() << std::endl;
+        return 1;
+    }
 }
 
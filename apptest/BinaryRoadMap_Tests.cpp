@@ -0,0 +1,502 @@
+// BinaryRoadMap_Tests.cpp
+//
+// ICS 46 Spring 2016
+// Project #4: Rock and Roll Stops the Traffic
+//
+// Unit tests for BinaryRoadMapWriter and BinaryRoadMapReader, checking
+// that a road map and a RoadNetwork read back what was written, and that
+// truncated and corrupt files are rejected with an InputException rather
+// than being read out of bounds.
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include "BinaryRoadMapFormat.hpp"
+#include "BinaryRoadMapReader.hpp"
+#include "BinaryRoadMapWriter.hpp"
+#include "InputException.hpp"
+#include "MappedFile.hpp"
+
+
+namespace
+{
+    // makeRoadMap() builds a small road map whose vertex numbers aren't
+    // dense, with one location lacking coordinates unless allCoordinates
+    // is true.
+    RoadMap makeRoadMap(bool allCoordinates = false)
+    {
+        RoadMap roadMap;
+
+        roadMap.addVertex(10, Location{"Alpha", 33.60, -117.80});
+        roadMap.addVertex(3, Location{"Bravo", 33.61, -117.82});
+        roadMap.addVertex(7, Location{"Charlie", 33.63, -117.81});
+        roadMap.addVertex(
+            22, allCoordinates ? Location{"Delta", 33.63, -117.80} : Location{"", NAN, NAN});
+        roadMap.addVertex(5, Location{"Echo @ 5th", 33.62, -117.79});
+
+        roadMap.addEdge(10, 3, RoadSegment{1.5, 45.0});
+        roadMap.addEdge(3, 10, RoadSegment{1.5, 40.0});
+        roadMap.addEdge(3, 7, RoadSegment{2.0, 65.0});
+        roadMap.addEdge(7, 22, RoadSegment{0.5, 25.0});
+        roadMap.addEdge(22, 5, RoadSegment{1.0, 35.0});
+        roadMap.addEdge(5, 10, RoadSegment{0.75, 30.0});
+        roadMap.addEdge(10, 7, RoadSegment{4.0, 70.0});
+
+        return roadMap;
+    }
+
+
+    // makeDetourRoadMap() builds a road map with a direct road 10.5 miles
+    // long from location 1 to location 3, which lie 10 miles apart, and a
+    // detour through location 2, which lies 3 miles to the side halfway
+    // between them, made of two roads 6 miles long.  Every road's speed is
+    // 60 miles per hour.
+    RoadMap makeDetourRoadMap()
+    {
+        RoadMap roadMap;
+
+        roadMap.addVertex(1, Location{"Start", 33.60, -117.80});
+        roadMap.addVertex(2, Location{"Detour", 33.6434, -117.7132});
+        roadMap.addVertex(3, Location{"End", 33.60, -117.6264});
+
+        roadMap.addEdge(1, 3, RoadSegment{10.5, 60.0});
+        roadMap.addEdge(1, 2, RoadSegment{6.0, 60.0});
+        roadMap.addEdge(2, 3, RoadSegment{6.0, 60.0});
+
+        return roadMap;
+    }
+
+
+    std::string writeToString(const RoadNetwork& network)
+    {
+        std::ostringstream out{std::ios::binary};
+        BinaryRoadMapWriter{}.writeRoadMap(out, network);
+        return out.str();
+    }
+
+
+    // mapBytes() writes the given bytes to a temporary file and maps it.
+    std::shared_ptr<const MappedFile> mapBytes(const std::string& bytes)
+    {
+        std::string path = testing::TempDir() + "BinaryRoadMap_Tests.bin";
+
+        {
+            std::ofstream out{path, std::ios::binary};
+            out.write(bytes.data(), bytes.size());
+        }
+
+        return std::make_shared<MappedFile>(path, MappedFile::Access::Random);
+    }
+
+
+    BinaryRoadMapHeader& headerOf(std::string& bytes)
+    {
+        return *reinterpret_cast<BinaryRoadMapHeader*>(&bytes[0]);
+    }
+}
+
+
+TEST(BinaryRoadMap_Tests, writeThenReadGivesTheSameRoadMap)
+{
+    RoadNetwork network{makeRoadMap()};
+    std::shared_ptr<const MappedFile> file = mapBytes(writeToString(network));
+
+    ASSERT_TRUE(BinaryRoadMapReader::isBinaryRoadMap(*file));
+
+    const CompactRoadMap& written = network.graph();
+    CompactRoadMap read = BinaryRoadMapReader{}.readRoadMap(file);
+
+    ASSERT_EQ(written.vertexCount(), read.vertexCount());
+    ASSERT_EQ(written.edgeCount(), read.edgeCount());
+    EXPECT_EQ(written.vertices(), read.vertices());
+    EXPECT_EQ(written.edges(), read.edges());
+
+    for (int vertex : written.vertices())
+    {
+        const Location& expected = written.vertexInfo(vertex);
+        const Location& actual = read.vertexInfo(vertex);
+
+        EXPECT_EQ(expected.name, actual.name);
+        EXPECT_EQ(expected.hasCoordinates(), actual.hasCoordinates());
+
+        if (expected.hasCoordinates())
+        {
+            EXPECT_EQ(expected.latitude, actual.latitude);
+            EXPECT_EQ(expected.longitude, actual.longitude);
+        }
+    }
+
+    for (const auto& edge : written.edges())
+    {
+        EXPECT_EQ(
+            written.edgeInfo(edge.first, edge.second).miles,
+            read.edgeInfo(edge.first, edge.second).miles);
+        EXPECT_EQ(
+            written.edgeInfo(edge.first, edge.second).milesPerHour,
+            read.edgeInfo(edge.first, edge.second).milesPerHour);
+    }
+}
+
+
+TEST(BinaryRoadMap_Tests, roadNetworkKeepsItsHierarchiesLandmarksAndLabels)
+{
+    RoadNetwork network{makeRoadMap(true)};
+    network.buildLandmarks(2);
+    network.buildHubLabels(1);
+
+    RoadNetwork read = BinaryRoadMapReader{}.readRoadNetwork(mapBytes(writeToString(network)));
+
+    EXPECT_TRUE(read.hasHierarchies());
+    EXPECT_TRUE(read.hasLandmarks());
+    EXPECT_TRUE(read.hasHubLabels());
+
+    // Nothing the RoadNetwork computed is computed again.
+    EXPECT_TRUE(read.weights(TripMetric::Time).borrowed());
+    EXPECT_TRUE(read.hasCoordinates());
+    EXPECT_EQ(network.arrays().detourFactor, read.arrays().detourFactor);
+    EXPECT_EQ(network.arrays().maxMilesPerHour, read.arrays().maxMilesPerHour);
+
+    for (int vertex : network.graph().vertices())
+    {
+        EXPECT_EQ(network.locationName(vertex), read.locationName(vertex));
+    }
+
+    for (TripMetric metric : {TripMetric::Distance, TripMetric::Time})
+    {
+        EXPECT_TRUE(std::equal(
+            network.weights(metric).begin(), network.weights(metric).end(),
+            read.weights(metric).begin(), read.weights(metric).end()));
+
+        for (int start : network.graph().vertices())
+        {
+            for (int end : network.graph().vertices())
+            {
+                Trip trip{start, end, metric};
+
+                EXPECT_EQ(network.distance(start, end, metric), read.distance(start, end, metric));
+                EXPECT_DOUBLE_EQ(
+                    network.findShortestPath(trip).totalCost,
+                    read.findShortestPath(trip, RoutingEngine::ContractionHierarchies).totalCost);
+                EXPECT_DOUBLE_EQ(
+                    network.findShortestPath(trip).totalCost,
+                    read.findShortestPath(trip, RoutingEngine::Landmarks).totalCost);
+                EXPECT_DOUBLE_EQ(
+                    network.findShortestPath(trip).totalCost,
+                    read.findShortestPath(trip, RoutingEngine::Bidirectional).totalCost);
+                EXPECT_DOUBLE_EQ(
+                    network.findShortestPath(trip).totalCost,
+                    read.findShortestPath(trip, RoutingEngine::AStar).totalCost);
+            }
+        }
+    }
+}
+
+
+TEST(BinaryRoadMap_Tests, aStarStaysExactAfterASpeedIsRaised)
+{
+    RoadNetwork read =
+        BinaryRoadMapReader{}.readRoadNetwork(mapBytes(writeToString(RoadNetwork{makeDetourRoadMap()})));
+
+    Trip trip{1, 3, TripMetric::Time};
+    EXPECT_DOUBLE_EQ(10.5 / 60.0, read.findShortestPath(trip, RoutingEngine::AStar).totalCost);
+
+    // Once the second leg of the detour is faster than any road was, the
+    // time bounds have to be scaled by its speed, or the detour's bound
+    // would exceed its time and A* would settle for the direct road.
+    read.updateSegment(2, 3, RoadSegment{6.0, 120.0});
+    EXPECT_EQ(120.0, read.arrays().maxMilesPerHour);
+
+    EXPECT_DOUBLE_EQ(6.0 / 60.0 + 6.0 / 120.0, read.findShortestPath(trip).totalCost);
+    EXPECT_DOUBLE_EQ(
+        read.findShortestPath(trip).totalCost,
+        read.findShortestPath(trip, RoutingEngine::AStar).totalCost);
+}
+
+
+TEST(BinaryRoadMap_Tests, landmarksStayExactAfterARoadIsShortenedAndSaved)
+{
+    RoadNetwork network{makeDetourRoadMap()};
+    network.buildLandmarks(2);
+
+    // Shortened, the second leg of the detour makes it shorter than the
+    // direct road.  Whichever two landmarks were chosen, the tables still
+    // bound the detour's remaining distance by its old 6 miles, so only
+    // the scaled bounds let A* find it.
+    network.updateSegment(2, 3, RoadSegment{0.5, 60.0});
+    ASSERT_LT(network.landmarkScale(TripMetric::Distance), 1.0);
+
+    RoadNetwork read = BinaryRoadMapReader{}.readRoadNetwork(mapBytes(writeToString(network)));
+
+    ASSERT_TRUE(read.hasLandmarks());
+    EXPECT_EQ(network.landmarkScale(TripMetric::Distance), read.landmarkScale(TripMetric::Distance));
+    EXPECT_EQ(network.landmarkScale(TripMetric::Time), read.landmarkScale(TripMetric::Time));
+
+    Trip trip{1, 3, TripMetric::Distance};
+    EXPECT_DOUBLE_EQ(6.5, read.findShortestPath(trip).totalCost);
+    EXPECT_DOUBLE_EQ(6.5, read.findShortestPath(trip, RoutingEngine::Landmarks).totalCost);
+
+    for (TripMetric metric : {TripMetric::Distance, TripMetric::Time})
+    {
+        for (int start : read.graph().vertices())
+        {
+            for (int end : read.graph().vertices())
+            {
+                Trip t{start, end, metric};
+
+                EXPECT_DOUBLE_EQ(
+                    read.findShortestPath(t).totalCost,
+                    read.findShortestPath(t, RoutingEngine::Landmarks).totalCost);
+            }
+        }
+    }
+}
+
+
+TEST(BinaryRoadMap_Tests, landmarksAreDiscardedWhenARoadShrinksToNothing)
+{
+    // A road shortened to 0 miles would scale the distance bounds to 0.
+    RoadNetwork shortened{makeDetourRoadMap()};
+    shortened.buildLandmarks(2);
+    shortened.updateSegment(2, 3, RoadSegment{0.0, 60.0});
+
+    // A road whose speed rises from 0 miles per hour had an infinite time,
+    // which would scale the time bounds to 0.
+    RoadNetwork sped{makeDetourRoadMap()};
+    sped.updateSegment(1, 3, RoadSegment{10.5, 0.0});
+    sped.buildLandmarks(2);
+    sped.updateSegment(1, 3, RoadSegment{10.5, 60.0});
+
+    for (RoadNetwork* network : {&shortened, &sped})
+    {
+        EXPECT_FALSE(network->hasLandmarks());
+        EXPECT_EQ(1.0, network->landmarkScale(TripMetric::Distance));
+        EXPECT_EQ(1.0, network->landmarkScale(TripMetric::Time));
+
+        RoadNetwork read = BinaryRoadMapReader{}.readRoadNetwork(mapBytes(writeToString(*network)));
+        EXPECT_FALSE(read.hasLandmarks());
+
+        for (TripMetric metric : {TripMetric::Distance, TripMetric::Time})
+        {
+            Trip trip{1, 3, metric};
+
+            EXPECT_DOUBLE_EQ(
+                network->findShortestPath(trip).totalCost,
+                read.findShortestPath(trip, RoutingEngine::Landmarks).totalCost);
+        }
+    }
+
+    EXPECT_DOUBLE_EQ(6.0, shortened.findShortestPath(Trip{1, 3, TripMetric::Distance}).totalCost);
+    EXPECT_DOUBLE_EQ(10.5 / 60.0, sped.findShortestPath(Trip{1, 3, TripMetric::Time}).totalCost);
+}
+
+
+TEST(BinaryRoadMap_Tests, rejectsTruncatedAndCorruptFiles)
+{
+    std::string bytes = writeToString(RoadNetwork{makeRoadMap()});
+    BinaryRoadMapReader reader;
+
+    EXPECT_FALSE(BinaryRoadMapReader::isBinaryRoadMap(*mapBytes("LOCATIONS\n")));
+    EXPECT_THROW(reader.readRoadMap(mapBytes("LOCATIONS\n")), InputException);
+
+    // The header itself is cut short.
+    EXPECT_THROW(reader.readRoadMap(mapBytes(bytes.substr(0, 40))), InputException);
+
+    // The road segments run past the end of the file.
+    const BinaryRoadMapSectionEntry& segments =
+        headerOf(bytes).sections[static_cast<int>(BinaryRoadMapSection::RoadSegments)];
+    EXPECT_THROW(
+        reader.readRoadMap(mapBytes(bytes.substr(0, segments.offset + segments.size - 8))),
+        InputException);
+
+    std::string wrongVersion = bytes;
+    headerOf(wrongVersion).version = BinaryRoadMapVersion + 1;
+    EXPECT_THROW(reader.readRoadMap(mapBytes(wrongVersion)), InputException);
+
+    std::string misaligned = bytes;
+    headerOf(misaligned).sections[static_cast<int>(BinaryRoadMapSection::EdgeTargets)].offset += 4;
+    EXPECT_THROW(reader.readRoadMap(mapBytes(misaligned)), InputException);
+
+    std::string tooManyEdges = bytes;
+    headerOf(tooManyEdges).edgeCount += 1;
+    EXPECT_THROW(reader.readRoadMap(mapBytes(tooManyEdges)), InputException);
+
+    // An edge whose target is no vertex at all.
+    std::string badTarget = bytes;
+    std::uint64_t targets =
+        headerOf(badTarget).sections[static_cast<int>(BinaryRoadMapSection::EdgeTargets)].offset;
+    int outOfRange = 99;
+    std::memcpy(&badTarget[targets], &outOfRange, sizeof(outOfRange));
+    EXPECT_THROW(reader.readRoadMap(mapBytes(badTarget)), InputException);
+
+    // A vertex with two edges to the same vertex, which lookups by their
+    // endpoints couldn't tell apart.
+    std::string repeatedTarget = bytes;
+    const int* offsets = reinterpret_cast<const int*>(
+        &repeatedTarget[headerOf(repeatedTarget).sections[static_cast<int>(BinaryRoadMapSection::EdgeOffsets)].offset]);
+    int* edgeTargets = reinterpret_cast<int*>(&repeatedTarget[targets]);
+    int from = 0;
+
+    while (offsets[from + 1] - offsets[from] < 2)
+    {
+        ++from;
+    }
+
+    edgeTargets[offsets[from] + 1] = edgeTargets[offsets[from]];
+    EXPECT_THROW(reader.readRoadMap(mapBytes(repeatedTarget)), InputException);
+}
+
+
+TEST(BinaryRoadMap_Tests, rejectsMismatchedIncomingEdges)
+{
+    RoadNetwork network{makeRoadMap()};
+    std::string bytes = writeToString(network);
+    BinaryRoadMapReader reader;
+
+    ASSERT_NO_THROW(reader.readRoadNetwork(mapBytes(bytes)));
+
+    // Alpha's edges to Bravo and Charlie are listed in different
+    // vertices' slots, with the same source, so swapping their positions
+    // leaves every slot with a source that owns its position, but an edge
+    // pointing somewhere else.
+    const CompactRoadMap& graph = network.graph();
+    int toBravo = graph.edgePosition(10, 3);
+    int toCharlie = graph.edgePosition(10, 7);
+
+    std::string swappedPositions = bytes;
+    std::uint64_t positions =
+        headerOf(swappedPositions).sections[static_cast<int>(BinaryRoadMapSection::InEdgePositions)].offset;
+    int* inPositions = reinterpret_cast<int*>(&swappedPositions[positions]);
+
+    for (int slot = 0; slot < graph.edgeCount(); ++slot)
+    {
+        if (inPositions[slot] == toBravo || inPositions[slot] == toCharlie)
+        {
+            inPositions[slot] = toBravo + toCharlie - inPositions[slot];
+        }
+    }
+
+    EXPECT_THROW(reader.readRoadNetwork(mapBytes(swappedPositions)), InputException);
+
+    // A slot whose source is a vertex, but not the one its edge leaves.
+    std::string wrongSource = bytes;
+    std::uint64_t sources =
+        headerOf(wrongSource).sections[static_cast<int>(BinaryRoadMapSection::InEdgeSources)].offset;
+    int* inSources = reinterpret_cast<int*>(&wrongSource[sources]);
+    inSources[0] = (inSources[0] + 1) % static_cast<int>(headerOf(wrongSource).vertexCount);
+    EXPECT_THROW(reader.readRoadNetwork(mapBytes(wrongSource)), InputException);
+}
+
+
+TEST(BinaryRoadMap_Tests, rejectsCorruptHierarchies)
+{
+    RoadNetwork network{makeRoadMap()};
+    network.buildHierarchies(1);
+
+    std::string bytes = writeToString(network);
+    BinaryRoadMapReader reader;
+
+    ASSERT_NO_THROW(reader.readRoadNetwork(mapBytes(bytes)));
+
+    const BinaryRoadMapSectionEntry& arcs =
+        headerOf(bytes).sections[static_cast<int>(BinaryRoadMapSection::DistanceForwardArcs)];
+    ASSERT_GT(arcs.size, 0u);
+
+    // An arc leading to a vertex that doesn't exist.
+    std::string badVertex = bytes;
+    reinterpret_cast<HierarchyArc*>(&badVertex[arcs.offset])->vertex = 1000000;
+    EXPECT_THROW(reader.readRoadNetwork(mapBytes(badVertex)), InputException);
+
+    // A shortcut whose middle vertex doesn't exist.
+    std::string badMiddle = bytes;
+    reinterpret_cast<HierarchyArc*>(&badMiddle[arcs.offset])->middle = -7;
+    EXPECT_THROW(reader.readRoadNetwork(mapBytes(badMiddle)), InputException);
+
+    // A shortcut whose middle vertex is ranked below both of its ends but
+    // isn't linked to them, so it can't be unpacked.
+    const ContractionHierarchy& hierarchy = network.hierarchy(TripMetric::Distance);
+    std::vector<int> order = hierarchy.order();
+    int lowest = order.back();
+    int arc = -1;
+
+    for (int v = 0; v < hierarchy.vertexCount() && arc < 0; ++v)
+    {
+        bool linked = v == lowest;
+
+        for (const HierarchyArc& a : hierarchy.forwardArcs(lowest))
+        {
+            linked = linked || a.vertex == v;
+        }
+
+        for (const HierarchyArc& a : hierarchy.backwardArcs(lowest))
+        {
+            linked = linked || a.vertex == v;
+        }
+
+        if (!linked && hierarchy.forwardOffsetArray()[v] < hierarchy.forwardOffsetArray()[v + 1])
+        {
+            arc = hierarchy.forwardOffsetArray()[v];
+        }
+    }
+
+    ASSERT_GE(arc, 0);
+
+    std::string unlinkedMiddle = bytes;
+    reinterpret_cast<HierarchyArc*>(&unlinkedMiddle[arcs.offset])[arc].middle = lowest;
+    EXPECT_THROW(reader.readRoadNetwork(mapBytes(unlinkedMiddle)), InputException);
+
+    // Forward offsets that go backward partway through.
+    std::string badOffsets = bytes;
+    std::uint64_t offsets =
+        headerOf(badOffsets).sections[static_cast<int>(BinaryRoadMapSection::DistanceForwardOffsets)].offset;
+    int* forwardOffsets = reinterpret_cast<int*>(&badOffsets[offsets]);
+    forwardOffsets[1] = forwardOffsets[5] + 1;
+    EXPECT_THROW(reader.readRoadNetwork(mapBytes(badOffsets)), InputException);
+
+    std::string badRank = bytes;
+    std::uint64_t ranks =
+        headerOf(badRank).sections[static_cast<int>(BinaryRoadMapSection::DistanceRanks)].offset;
+    reinterpret_cast<int*>(&badRank[ranks])[0] = -1;
+    EXPECT_THROW(reader.readRoadNetwork(mapBytes(badRank)), InputException);
+}
+
+
+TEST(BinaryRoadMap_Tests, rejectsCorruptLandmarks)
+{
+    RoadNetwork network{makeRoadMap()};
+    network.buildLandmarks(2);
+
+    std::string bytes = writeToString(network);
+    BinaryRoadMapReader reader;
+
+    ASSERT_NO_THROW(reader.readRoadNetwork(mapBytes(bytes)));
+
+    // A landmark that isn't a vertex.  (The distances themselves are
+    // trusted, so damaging one isn't noticed.)
+    std::string badLandmark = bytes;
+    std::uint64_t landmarks =
+        headerOf(badLandmark).sections[static_cast<int>(BinaryRoadMapSection::TimeLandmarks)].offset;
+    reinterpret_cast<int*>(&badLandmark[landmarks])[1] = 1000000;
+    EXPECT_THROW(reader.readRoadNetwork(mapBytes(badLandmark)), InputException);
+
+    // A distance section that's too short for the table's landmarks.
+    std::string shortDistances = bytes;
+    BinaryRoadMapSectionEntry& fromLandmarks =
+        headerOf(shortDistances).sections[static_cast<int>(BinaryRoadMapSection::DistanceFromLandmarks)];
+    fromLandmarks.size -= sizeof(double);
+    EXPECT_THROW(reader.readRoadNetwork(mapBytes(shortDistances)), InputException);
+
+    // A scale that would make the bounds higher than the tables' own, and
+    // one that isn't a number.
+    std::string badScale = bytes;
+    headerOf(badScale).timeLandmarkScale = 2.0;
+    EXPECT_THROW(reader.readRoadNetwork(mapBytes(badScale)), InputException);
+
+    std::string nanScale = bytes;
+    headerOf(nanScale).distanceLandmarkScale = NAN;
+    EXPECT_THROW(reader.readRoadNetwork(mapBytes(nanScale)), InputException);
+}
@@ -0,0 +1,64 @@
+// Location_Tests.cpp
+//
+// ICS 46 Spring 2016
+// Project #4: Rock and Roll Stops the Traffic
+//
+// Unit tests for parseLocation() and the great-circle distance, checking
+// that names are kept intact whether or not coordinates follow them, and
+// that malformed or out-of-range coordinates are rejected.
+
+#include <gtest/gtest.h>
+#include "InputException.hpp"
+#include "Location.hpp"
+
+
+TEST(Location_Tests, nameWithoutCoordinates)
+{
+    Location location = parseLocation("Freeway North @ 101st Ave");
+
+    EXPECT_EQ("Freeway North @ 101st Ave", location.name);
+    EXPECT_FALSE(location.hasCoordinates());
+}
+
+
+TEST(Location_Tests, nameWithCoordinates)
+{
+    Location location = parseLocation("Freeway North @ 101st Ave  | 33.6846 -117.8265");
+
+    EXPECT_EQ("Freeway North @ 101st Ave", location.name);
+    ASSERT_TRUE(location.hasCoordinates());
+    EXPECT_EQ(33.6846, location.latitude);
+    EXPECT_EQ(-117.8265, location.longitude);
+}
+
+
+TEST(Location_Tests, coordinatesAtTheirLimits)
+{
+    Location location = parseLocation("Corner|-90 180");
+
+    EXPECT_EQ("Corner", location.name);
+    EXPECT_EQ(-90.0, location.latitude);
+    EXPECT_EQ(180.0, location.longitude);
+}
+
+
+TEST(Location_Tests, rejectsMalformedCoordinates)
+{
+    EXPECT_THROW(parseLocation("Nowhere |"), InputException);
+    EXPECT_THROW(parseLocation("Nowhere | 33.6"), InputException);
+    EXPECT_THROW(parseLocation("Nowhere | north west"), InputException);
+    EXPECT_THROW(parseLocation("Nowhere | 90.5 0"), InputException);
+    EXPECT_THROW(parseLocation("Nowhere | 0 -180.5"), InputException);
+}
+
+
+TEST(Location_Tests, greatCircleMiles)
+{
+    GeoPoint irvine = toGeoPoint(parseLocation("Irvine | 33.6846 -117.8265"));
+    GeoPoint losAngeles = toGeoPoint(parseLocation("Los Angeles | 34.0522 -118.2437"));
+
+    EXPECT_EQ(0.0, greatCircleMiles(irvine, irvine));
+    EXPECT_NEAR(35.2, greatCircleMiles(irvine, losAngeles), 0.5);
+    EXPECT_DOUBLE_EQ(greatCircleMiles(irvine, losAngeles), greatCircleMiles(losAngeles, irvine));
+}
+
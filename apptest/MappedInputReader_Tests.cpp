@@ -0,0 +1,79 @@
+// MappedInputReader_Tests.cpp
+//
+// ICS 46 Spring 2016
+// Project #4: Rock and Roll Stops the Traffic
+//
+// Unit tests for MappedInputReader and LineFields, checking that lines are
+// skipped and trimmed the way an InputReader skips and trims them, and
+// that fields are parsed the way the original stream-based readers parsed
+// them.
+
+#include <gtest/gtest.h>
+#include <string>
+#include <string_view>
+#include "InputException.hpp"
+#include "MappedInputReader.hpp"
+
+
+TEST(MappedInputReader_Tests, skipsCommentsAndBlankLines)
+{
+    std::string text = "# header\n\n   \n3\r\n# comment\nfirst line  \n\tsecond\nlast";
+    MappedInputReader in{text.data(), text.data() + text.size()};
+
+    EXPECT_EQ(3, in.readIntLine());
+    EXPECT_EQ("first line", in.readLine());
+    EXPECT_EQ("\tsecond", in.readLine());
+
+    const char* beforeLast = in.position();
+    EXPECT_EQ("last", in.readLine());
+    EXPECT_EQ(in.end(), in.position());
+
+    std::string_view line;
+    EXPECT_FALSE(in.tryReadLine(line));
+    EXPECT_THROW(in.readLine(), InputException);
+
+    in.setPosition(beforeLast);
+    EXPECT_TRUE(in.tryReadLine(line));
+    EXPECT_EQ("last", line);
+}
+
+
+TEST(MappedInputReader_Tests, linesAreViewsOfTheInput)
+{
+    std::string text = "one\ntwo\n";
+    MappedInputReader in{text.data(), text.data() + text.size()};
+
+    std::string_view line = in.readLine();
+    EXPECT_EQ(text.data(), line.data());
+}
+
+
+TEST(MappedInputReader_Tests, parsesFields)
+{
+    LineFields fields{"  12 -7\t+3 2.5 -0.125 +1e3  D "};
+
+    EXPECT_EQ(12, fields.readInt());
+    EXPECT_EQ(-7, fields.readInt());
+    EXPECT_EQ(3, fields.readInt());
+    EXPECT_EQ(2.5, fields.readDouble());
+    EXPECT_EQ(-0.125, fields.readDouble());
+    EXPECT_EQ(1000.0, fields.readDouble());
+    EXPECT_EQ("D", fields.readWord());
+    EXPECT_THROW(fields.readWord(), InputException);
+}
+
+
+TEST(MappedInputReader_Tests, rejectsMalformedFields)
+{
+    EXPECT_THROW(LineFields{"12x"}.readInt(), InputException);
+    EXPECT_THROW(LineFields{"2.5"}.readInt(), InputException);
+    EXPECT_THROW(LineFields{"99999999999"}.readInt(), InputException);
+    EXPECT_THROW(LineFields{"miles"}.readDouble(), InputException);
+    EXPECT_THROW(LineFields{"1.5.2"}.readDouble(), InputException);
+    EXPECT_THROW(LineFields{""}.readInt(), InputException);
+
+    std::string text = "not a number\n";
+    MappedInputReader in{text.data(), text.data() + text.size()};
+    EXPECT_THROW(in.readIntLine(), InputException);
+}
+
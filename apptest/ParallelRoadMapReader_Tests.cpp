@@ -0,0 +1,154 @@
+// ParallelRoadMapReader_Tests.cpp
+//
+// ICS 46 Spring 2016
+// Project #4: Rock and Roll Stops the Traffic
+//
+// Unit tests for ParallelRoadMapReader, checking that it gives exactly
+// what freezing the RoadMap built by a RoadMapReader would give, whether
+// the road segments are parsed in one chunk or several, and that it
+// rejects what a RoadMap would reject.
+
+#include <gtest/gtest.h>
+#include <random>
+#include <sstream>
+#include <string>
+#include "InputException.hpp"
+#include "InputReader.hpp"
+#include "MappedInputReader.hpp"
+#include "ParallelRoadMapReader.hpp"
+#include "RoadMapReader.hpp"
+
+
+namespace
+{
+    // makeInput() builds a road map in the text format, followed by a
+    // line that stands in for the trips.  It has enough road segments,
+    // with comments and blank lines among them, to be split into several
+    // chunks, and each location has several edges, which must keep their
+    // input order.
+    std::string makeInput(int locationCount, int segmentsPerLocation)
+    {
+        std::mt19937 random{46};
+        std::uniform_int_distribution<int> lengths{1, 400};
+        std::ostringstream out;
+
+        out << "# LOCATIONS\n" << locationCount << "\n";
+
+        for (int i = 0; i < locationCount; ++i)
+        {
+            out << "Location " << i << "\n";
+        }
+
+        out << "\n# ROAD SEGMENTS\n" << locationCount * segmentsPerLocation << "\n";
+
+        for (int s = 0; s < segmentsPerLocation; ++s)
+        {
+            for (int i = 0; i < locationCount; ++i)
+            {
+                int target = (i + s * 7 + 1) % locationCount;
+                out << i << " " << target << " " << lengths(random) / 100.0 << " 35\n";
+            }
+
+            out << "\n# more road segments\n";
+        }
+
+        out << "TRIPS\n";
+        return out.str();
+    }
+
+
+    CompactRoadMap readInParallel(const std::string& input, int threadCount)
+    {
+        MappedInputReader in{input.data(), input.data() + input.size()};
+        CompactRoadMap roadMap = ParallelRoadMapReader{threadCount}.readRoadMap(in);
+
+        EXPECT_EQ("TRIPS", in.readLine());
+        return roadMap;
+    }
+
+
+    void expectSameRoadMap(const CompactRoadMap& expected, const CompactRoadMap& actual)
+    {
+        ASSERT_EQ(expected.vertexCount(), actual.vertexCount());
+        ASSERT_EQ(expected.edgeCount(), actual.edgeCount());
+
+        for (int v = 0; v < expected.vertexCount(); ++v)
+        {
+            EXPECT_EQ(expected.vertexInfo(v).name, actual.vertexInfo(v).name);
+        }
+
+        EXPECT_EQ(expected.edges(), actual.edges());
+
+        for (const auto& edge : expected.edges())
+        {
+            EXPECT_EQ(
+                expected.edgeInfo(edge.first, edge.second).miles,
+                actual.edgeInfo(edge.first, edge.second).miles);
+        }
+    }
+}
+
+
+TEST(ParallelRoadMapReader_Tests, readsTheSameRoadMapAsRoadMapReader)
+{
+    // About 3MB of road segments, which is enough for three chunks.
+    std::string input = makeInput(2000, 100);
+
+    std::istringstream stream{input};
+    InputReader in{stream};
+    CompactRoadMap expected = RoadMapReader{}.readRoadMap(in).freeze();
+
+    expectSameRoadMap(expected, readInParallel(input, 1));
+    expectSameRoadMap(expected, readInParallel(input, 4));
+}
+
+
+TEST(ParallelRoadMapReader_Tests, rejectsDuplicateEdgesInDifferentChunks)
+{
+    std::string input = makeInput(2000, 100);
+
+    // The first road segment appears again just before the trips, which
+    // is in a different chunk.
+    std::string first = "0 1 ";
+    std::size_t position = input.find("\n" + first) + 1;
+    std::string duplicate = input.substr(position, input.find('\n', position) + 1 - position);
+
+    input.insert(input.rfind("TRIPS"), duplicate);
+    input.replace(input.find("200000"), 6, "200001");
+
+    MappedInputReader in{input.data(), input.data() + input.size()};
+    EXPECT_THROW(ParallelRoadMapReader{4}.readRoadMap(in), DigraphException);
+}
+
+
+TEST(ParallelRoadMapReader_Tests, rejectsMissingLocationsAndSegments)
+{
+    std::string missingLocation = "2\nA\nB\n1\n0 2 1.0 35\n";
+    MappedInputReader missingLocationIn{
+        missingLocation.data(), missingLocation.data() + missingLocation.size()};
+    EXPECT_THROW(ParallelRoadMapReader{}.readRoadMap(missingLocationIn), DigraphException);
+
+    std::string tooFewSegments = "2\nA\nB\n3\n0 1 1.0 35\n1 0 1.0 35\n";
+    MappedInputReader tooFewSegmentsIn{
+        tooFewSegments.data(), tooFewSegments.data() + tooFewSegments.size()};
+    EXPECT_THROW(ParallelRoadMapReader{}.readRoadMap(tooFewSegmentsIn), InputException);
+
+    std::string malformed = "2\nA\nB\n1\n0 one 1.0 35\n";
+    MappedInputReader malformedIn{malformed.data(), malformed.data() + malformed.size()};
+    EXPECT_THROW(ParallelRoadMapReader{}.readRoadMap(malformedIn), InputException);
+}
+
+
+TEST(ParallelRoadMapReader_Tests, rejectsNegativeCounts)
+{
+    std::string negativeLocations = "-1\n0\n0\n";
+    MappedInputReader negativeLocationsIn{
+        negativeLocations.data(), negativeLocations.data() + negativeLocations.size()};
+    EXPECT_THROW(ParallelRoadMapReader{}.readRoadMap(negativeLocationsIn), InputException);
+
+    std::string negativeSegments = "2\nA\nB\n-1\n0\n";
+    MappedInputReader negativeSegmentsIn{
+        negativeSegments.data(), negativeSegments.data() + negativeSegments.size()};
+    EXPECT_THROW(ParallelRoadMapReader{}.readRoadMap(negativeSegmentsIn), InputException);
+}
+
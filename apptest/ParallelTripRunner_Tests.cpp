@@ -0,0 +1,168 @@
+// ParallelTripRunner_Tests.cpp
+//
+// ICS 46 Spring 2016
+// Project #4: Rock and Roll Stops the Traffic
+//
+// Unit tests for ParallelTripRunner and TripBatchRunner, checking that
+// routes come back in the same order as the trips, whichever thread found
+// them, and that an exception thrown while routing is passed back to the
+// caller instead of terminating the program.
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <random>
+#include <set>
+#include <vector>
+#include "ParallelTripRunner.hpp"
+#include "TripBatchRunner.hpp"
+
+
+namespace
+{
+    // makeRoadMap() builds a road map of the given number of locations,
+    // each with a few road segments of random lengths and speeds leading
+    // to other locations.
+    RoadMap makeRoadMap(int locationCount)
+    {
+        std::mt19937 random{46};
+        std::uniform_int_distribution<int> targets{0, locationCount - 1};
+        std::uniform_real_distribution<double> miles{0.1, 5.0};
+        std::uniform_real_distribution<double> speeds{25.0, 70.0};
+
+        RoadMap roadMap;
+
+        for (int i = 0; i < locationCount; ++i)
+        {
+            roadMap.addVertex(i, Location{"Location", NAN, NAN});
+        }
+
+        for (int i = 0; i < locationCount; ++i)
+        {
+            std::set<int> edgeTargets{(i + 1) % locationCount};
+
+            for (int e = 0; e < 3; ++e)
+            {
+                edgeTargets.insert(targets(random));
+            }
+
+            edgeTargets.erase(i);
+
+            for (int target : edgeTargets)
+            {
+                roadMap.addEdge(i, target, RoadSegment{miles(random), speeds(random)});
+            }
+        }
+
+        return roadMap;
+    }
+
+
+    // makeTrips() makes trips between random locations, starting from
+    // only a few of them, so that many trips share a group.
+    std::vector<Trip> makeTrips(int locationCount, int tripCount)
+    {
+        std::mt19937 random{1};
+        std::uniform_int_distribution<int> starts{0, 9};
+        std::uniform_int_distribution<int> ends{0, locationCount - 1};
+        std::vector<Trip> trips;
+
+        for (int i = 0; i < tripCount; ++i)
+        {
+            TripMetric metric = i % 3 == 0 ? TripMetric::Time : TripMetric::Distance;
+            trips.push_back(Trip{starts(random), ends(random), metric});
+        }
+
+        return trips;
+    }
+
+
+    void expectRoutesInTripOrder(
+        const RoadNetwork& network, const std::vector<Trip>& trips,
+        const std::vector<ShortestPath<RoadSegment>>& routes)
+    {
+        ASSERT_EQ(trips.size(), routes.size());
+
+        for (unsigned int i = 0; i < trips.size(); ++i)
+        {
+            ShortestPath<RoadSegment> expected = network.findShortestPath(trips[i]);
+
+            EXPECT_EQ(expected.vertices, routes[i].vertices);
+            EXPECT_EQ(expected.totalCost, routes[i].totalCost);
+        }
+    }
+}
+
+
+TEST(ParallelTripRunner_Tests, routesComeBackInTripOrder)
+{
+    RoadNetwork network{makeRoadMap(300)};
+    std::vector<Trip> trips = makeTrips(300, 200);
+
+    for (int threadCount : {1, 2, 4, 8})
+    {
+        expectRoutesInTripOrder(
+            network, trips, ParallelTripRunner{network, threadCount}.run(trips));
+    }
+
+    EXPECT_TRUE(ParallelTripRunner(network, 4).run(std::vector<Trip>{}).empty());
+}
+
+
+TEST(ParallelTripRunner_Tests, batchRunnerSearchesOncePerGroup)
+{
+    RoadNetwork network{makeRoadMap(300)};
+    std::vector<Trip> trips = makeTrips(300, 200);
+
+    TripBatchRunner runner{network};
+    expectRoutesInTripOrder(network, trips, runner.run(trips));
+
+    // Ten start vertices, each with two metrics.
+    EXPECT_EQ(20, runner.searchCount());
+}
+
+
+TEST(ParallelTripRunner_Tests, rejectsTripsToMissingVertices)
+{
+    RoadNetwork network{makeRoadMap(10)};
+    std::vector<Trip> trips = makeTrips(10, 20);
+    trips.push_back(Trip{0, 10, TripMetric::Distance});
+
+    EXPECT_THROW(ParallelTripRunner(network, 4).run(trips), DigraphException);
+    EXPECT_THROW(ParallelTripRunner(network, 1).run(trips), DigraphException);
+}
+
+
+TEST(ParallelTripRunner_Tests, exceptionWhileRoutingIsRethrown)
+{
+    RoadMap roadMap;
+    roadMap.addVertex(0, Location{"A", NAN, NAN});
+    roadMap.addVertex(1, Location{"B", NAN, NAN});
+    roadMap.addVertex(2, Location{"C", NAN, NAN});
+    roadMap.addEdge(0, 1, RoadSegment{1.0, 30.0});
+    roadMap.addEdge(1, 2, RoadSegment{1.0, 30.0});
+
+    RoadNetwork network{roadMap};
+
+    // The shortcut from A to C goes through B, but the hierarchy is
+    // missing the arc from B to C, so unpacking the shortcut fails.
+    ContractionHierarchy broken{
+        std::vector<int>{1, 0, 2},
+        std::vector<int>{0, 1, 1, 1}, std::vector<HierarchyArc>{HierarchyArc{2, 1, 2.0}},
+        std::vector<int>{0, 0, 1, 1}, std::vector<HierarchyArc>{HierarchyArc{0, -1, 1.0}}};
+
+    network.setHierarchies(broken, broken);
+
+    std::vector<Trip> trips{
+        Trip{1, 1, TripMetric::Time},
+        Trip{0, 2, TripMetric::Distance},
+        Trip{2, 2, TripMetric::Distance},
+        Trip{0, 2, TripMetric::Time},
+        Trip{1, 1, TripMetric::Distance}};
+
+    for (int threadCount : {1, 2, 4})
+    {
+        ParallelTripRunner runner{network, threadCount, RoutingEngine::ContractionHierarchies};
+        EXPECT_THROW(runner.run(trips), DigraphException);
+    }
+}
+
@@ -0,0 +1,42 @@
+// RoadMapReader_Tests.cpp
+//
+// ICS 46 Spring 2016
+// Project #4: Rock and Roll Stops the Traffic
+//
+// Unit tests for RoadMapReader, checking that it rejects counts that no
+// road map could have.
+
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+#include "InputException.hpp"
+#include "InputReader.hpp"
+#include "RoadMapReader.hpp"
+
+
+namespace
+{
+    RoadMap readFromStream(const std::string& input)
+    {
+        std::istringstream stream{input};
+        InputReader in{stream};
+        return RoadMapReader{}.readRoadMap(in);
+    }
+}
+
+
+TEST(RoadMapReader_Tests, readsLocationsAndSegments)
+{
+    RoadMap roadMap = readFromStream("2\nA\nB\n1\n0 1 1.5 30\n");
+
+    EXPECT_EQ(2, roadMap.vertexCount());
+    EXPECT_EQ(1, roadMap.edgeCount());
+    EXPECT_EQ(1.5, roadMap.edgeInfo(0, 1).miles);
+}
+
+
+TEST(RoadMapReader_Tests, rejectsNegativeCounts)
+{
+    EXPECT_THROW(readFromStream("-1\n0\n0\n"), InputException);
+    EXPECT_THROW(readFromStream("2\nA\nB\n-1\n0\n"), InputException);
+}
@@ -0,0 +1,61 @@
+// TripReader_Tests.cpp
+//
+// ICS 46 Spring 2016
+// Project #4: Rock and Roll Stops the Traffic
+//
+// Unit tests for TripReader, checking that reading trips from a stream
+// and from memory gives the same trips, and that both reject the same
+// input.
+
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "InputException.hpp"
+#include "InputReader.hpp"
+#include "MappedInputReader.hpp"
+#include "TripReader.hpp"
+
+
+namespace
+{
+    std::vector<Trip> readFromStream(const std::string& input)
+    {
+        std::istringstream stream{input};
+        InputReader in{stream};
+        return TripReader{}.readTrips(in);
+    }
+
+
+    std::vector<Trip> readInPlace(const std::string& input)
+    {
+        MappedInputReader in{input.data(), input.data() + input.size()};
+        return TripReader{}.readTrips(in);
+    }
+}
+
+
+TEST(TripReader_Tests, bothReadersGiveTheSameTrips)
+{
+    std::string input = "# TRIPS\n2\n0 3 D\n\n3 1 T\n";
+
+    for (const std::vector<Trip>& trips : {readFromStream(input), readInPlace(input)})
+    {
+        ASSERT_EQ(2u, trips.size());
+        EXPECT_EQ(0, trips[0].startVertex);
+        EXPECT_EQ(3, trips[0].endVertex);
+        EXPECT_EQ(TripMetric::Distance, trips[0].metric);
+        EXPECT_EQ(3, trips[1].startVertex);
+        EXPECT_EQ(1, trips[1].endVertex);
+        EXPECT_EQ(TripMetric::Time, trips[1].metric);
+    }
+}
+
+
+TEST(TripReader_Tests, bothReadersRejectANegativeTripCount)
+{
+    std::string input = "-1\n";
+
+    EXPECT_THROW(readFromStream(input), InputException);
+    EXPECT_THROW(readInPlace(input), InputException);
+}
@@ -0,0 +1,311 @@
+// BidirectionalSearch.hpp
+//
+// ICS 46 Spring 2016
+// Project #4: Rock and Roll Stops the Traffic
+//
+// A BidirectionalSearch finds the shortest path between one start vertex
+// and one target vertex by running two of Dijkstra's searches at once: one
+// forward from the start along outgoing edges, and one backward from the
+// target along incoming edges.  Each step settles one vertex on whichever
+// side has the smaller tentative distance at the top of its heap, so the
+// two searches grow at the same rate.  Whenever an edge is relaxed into a
+// vertex the other side has already reached, the path through that vertex
+// becomes a candidate, and the search stops once the two heaps' smallest
+// distances add up to no less than the best candidate.  Where a forward
+// search explores a disc around the start that reaches the target, the two
+// halves explore two discs of half that radius, which on a road map is
+// about half as many vertices.
+//
+// The graph can be of any type that provides these member functions:
+//
+// * int vertexCount() const, returning the number of dense indexes
+// * forEachOutEdge(int index, Visit visit) const, calling visit(toIndex,
+//   einfo) for each edge outgoing from the vertex with the given index
+// * forEachInEdge(int index, Visit visit) const, calling visit(fromIndex,
+//   einfo) for each edge pointing to the vertex with the given index
+//
+// Like a ShortestPathSearch, a BidirectionalSearch keeps its state in
+// SearchWorkspaces (one per direction) that it either owns or borrows, so
+// starting a new run costs constant time.
+
+#ifndef BIDIRECTIONALSEARCH_HPP
+#define BIDIRECTIONALSEARCH_HPP
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+#include "SearchWorkspace.hpp"
+#include "ShortestPathSearch.hpp"
+
+
+
+class BidirectionalSearch
+{
+public:
+    // The default constructor initializes a search that owns its own
+    // SearchWorkspaces.
+    BidirectionalSearch();
+
+    // This constructor initializes a search that works in the given
+    // SearchWorkspaces, one for each direction, which must outlive it.
+    BidirectionalSearch(SearchWorkspace& forward, SearchWorkspace& backward);
+
+    // A search can't be copied, since it may be borrowing its workspaces.
+    BidirectionalSearch(const BidirectionalSearch&) = delete;
+    BidirectionalSearch& operator=(const BidirectionalSearch&) = delete;
+
+    // run() finds the shortest path from the vertex with the given start
+    // index to the vertex with the given target index, replacing the
+    // results of any previous run.  Edge weights are determined by calling
+    // weightFunc on each edge's EdgeInfo, and must not be negative.
+    template <typename Graph, typename WeightFunc>
+    void run(const Graph& graph, int startIndex, int targetIndex, WeightFunc&& weightFunc);
+
+    // settledCount() returns the number of vertices settled by the last
+    // run, counting both directions.
+    int settledCount() const;
+
+    // reached() returns true if the last run found a path.
+    bool reached() const;
+
+    // distance() returns the length of the path found by the last run, or
+    // infinity if there was none.
+    double distance() const;
+
+    // meetingIndex() returns the index of a vertex on the path found by
+    // the last run, where its forward and backward halves meet, or -1 if
+    // there was no path.
+    int meetingIndex() const;
+
+    // path() returns the path found by the last run on the given graph,
+    // in the same form as ShortestPathSearch::pathTo().
+    template <typename EdgeInfo, typename Graph>
+    ShortestPath<EdgeInfo> path(const Graph& graph) const;
+
+private:
+    // settleNext() settles the next vertex on one side of the search and
+    // relaxes its edges (outgoing ones going forward, incoming ones going
+    // backward), recording any better path through a vertex the other
+    // side has reached.
+    template <typename Graph, typename WeightFunc>
+    void settleNext(
+        const Graph& graph, WeightFunc& weightFunc, bool forward,
+        SearchWorkspace& mine, SearchWorkspace& other);
+
+    // appendEdge() appends the EdgeInfo of the edge between the vertices
+    // with the given indexes to the given path.
+    template <typename EdgeInfo, typename Graph>
+    static void appendEdge(
+        const Graph& graph, int fromIndex, int toIndex, ShortestPath<EdgeInfo>& path);
+
+private:
+    SearchWorkspace ownForward_;
+    SearchWorkspace ownBackward_;
+    SearchWorkspace* forward_;
+    SearchWorkspace* backward_;
+    int settledCount_;
+    double bestDistance_;
+    int meetingIndex_;
+};
+
+
+
+inline BidirectionalSearch::BidirectionalSearch()
+    : forward_{&ownForward_}, backward_{&ownBackward_},
+      settledCount_{0}, bestDistance_{std::numeric_limits<double>::infinity()},
+      meetingIndex_{-1}
+{
+}
+
+
+inline BidirectionalSearch::BidirectionalSearch(
+    SearchWorkspace& forward, SearchWorkspace& backward)
+    : forward_{&forward}, backward_{&backward},
+      settledCount_{0}, bestDistance_{std::numeric_limits<double>::infinity()},
+      meetingIndex_{-1}
+{
+}
+
+
+
+template <typename Graph, typename WeightFunc>
+void BidirectionalSearch::run(
+    const Graph& graph, int startIndex, int targetIndex, WeightFunc&& weightFunc)
+{
+    SearchWorkspace& forward = *forward_;
+    SearchWorkspace& backward = *backward_;
+
+    forward.reset(graph.vertexCount());
+    backward.reset(graph.vertexCount());
+
+    settledCount_ = 0;
+    bestDistance_ = std::numeric_limits<double>::infinity();
+    meetingIndex_ = -1;
+
+    forward.setEntry(startIndex, 0.0, -1);
+    forward.heap().push(startIndex, 0.0);
+    backward.setEntry(targetIndex, 0.0, -1);
+    backward.heap().push(targetIndex, 0.0);
+
+    if (startIndex == targetIndex)
+    {
+        bestDistance_ = 0.0;
+        meetingIndex_ = startIndex;
+        return;
+    }
+
+    // Once either side runs out of vertices, every vertex it can reach has
+    // been settled, so the best candidate (if any) is already known.
+
+    while (!forward.heap().empty() && !backward.heap().empty())
+    {
+        double forwardTop = forward.heap().topKey();
+        double backwardTop = backward.heap().topKey();
+
+        if (forwardTop + backwardTop >= bestDistance_)
+        {
+            break;
+        }
+
+        if (forwardTop <= backwardTop)
+        {
+            settleNext(graph, weightFunc, true, forward, backward);
+        }
+        else
+        {
+            settleNext(graph, weightFunc, false, backward, forward);
+        }
+    }
+}
+
+
+template <typename Graph, typename WeightFunc>
+void BidirectionalSearch::settleNext(
+    const Graph& graph, WeightFunc& weightFunc, bool forward,
+    SearchWorkspace& mine, SearchWorkspace& other)
+{
+    IndexedDaryHeap<4>& heap = mine.heap();
+
+    double base = heap.topKey();
+    int v = heap.pop();
+    ++settledCount_;
+
+    auto relax =
+        [&](int w, const auto& einfo)
+        {
+            double candidate = base + weightFunc(einfo);
+
+            if (candidate < mine.distance(w))
+            {
+                mine.setEntry(w, candidate, v);
+                heap.pushOrDecrease(w, candidate);
+            }
+
+            double total = mine.distance(w) + other.distance(w);
+
+            if (total < bestDistance_)
+            {
+                bestDistance_ = total;
+                meetingIndex_ = w;
+            }
+        };
+
+    if (forward)
+    {
+        graph.forEachOutEdge(v, relax);
+    }
+    else
+    {
+        graph.forEachInEdge(v, relax);
+    }
+}
+
+
+inline int BidirectionalSearch::settledCount() const
+{
+    return settledCount_;
+}
+
+
+inline bool BidirectionalSearch::reached() const
+{
+    return meetingIndex_ >= 0;
+}
+
+
+inline double BidirectionalSearch::distance() const
+{
+    return bestDistance_;
+}
+
+
+inline int BidirectionalSearch::meetingIndex() const
+{
+    return meetingIndex_;
+}
+
+
+template <typename EdgeInfo, typename Graph>
+ShortestPath<EdgeInfo> BidirectionalSearch::path(const Graph& graph) const
+{
+    ShortestPath<EdgeInfo> path{{}, {}, bestDistance_};
+
+    if (!reached())
+    {
+        return path;
+    }
+
+    // The forward half is found by walking the forward predecessors back
+    // from the meeting vertex to the start; the backward half by walking
+    // the backward ones, each of which is the next vertex toward the
+    // target, from the meeting vertex on.
+
+    std::vector<int> forwardHalf;
+
+    for (int v = meetingIndex_; v >= 0; v = forward_->predecessor(v))
+    {
+        forwardHalf.push_back(v);
+    }
+
+    std::reverse(forwardHalf.begin(), forwardHalf.end());
+
+    for (unsigned int i = 0; i < forwardHalf.size(); ++i)
+    {
+        path.vertices.push_back(graph.toVertexNumber(forwardHalf[i]));
+
+        if (i > 0)
+        {
+            appendEdge(graph, forwardHalf[i - 1], forwardHalf[i], path);
+        }
+    }
+
+    for (int v = meetingIndex_, next = backward_->predecessor(v); next >= 0;
+         v = next, next = backward_->predecessor(v))
+    {
+        path.vertices.push_back(graph.toVertexNumber(next));
+        appendEdge(graph, v, next, path);
+    }
+
+    return path;
+}
+
+
+template <typename EdgeInfo, typename Graph>
+void BidirectionalSearch::appendEdge(
+    const Graph& graph, int fromIndex, int toIndex, ShortestPath<EdgeInfo>& path)
+{
+    graph.forEachOutEdge(
+        fromIndex,
+        [&](int w, const EdgeInfo& einfo)
+        {
+            if (w == toIndex)
+            {
+                path.edges.push_back(einfo);
+            }
+        });
+}
+
+
+
+#endif // BIDIRECTIONALSEARCH_HPP
+
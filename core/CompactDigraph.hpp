@@ -0,0 +1,768 @@
+// CompactDigraph.hpp
+//
+// ICS 46 Spring 2016
+// Project #4: Rock and Roll Stops the Traffic
+//
+// This header file declares a class template called CompactDigraph, which
+// is a read-only snapshot of a Digraph stored in compressed sparse row
+// (CSR) form.  Every vertex is given a dense "index" between 0 and
+// vertexCount() - 1, and the outgoing edges of all vertices are laid out
+// back to back in three contiguous arrays:
+//
+// * an offsets array, where the outgoing edges of the vertex with index i
+//   occupy positions offsets[i] through offsets[i + 1] - 1 of the other two
+// * a targets array, holding the index of the vertex each edge points to
+// * an EdgeInfo array, holding the EdgeInfo object of each edge
+//
+// A CompactDigraph's vertices and edges can't be added or removed once it's
+// been built (though an edge's EdgeInfo can be replaced in place), but in
+// exchange for that, traversing it touches memory sequentially instead of
+// chasing pointers, which is what we want for graphs that are built once
+// and then queried many times.  The usual way to get one is to call
+// freeze() on a Digraph.
+//
+// Each edge also has a "position", which is where it lives in the targets
+// and EdgeInfo arrays.  Positions are dense, so code that wants to keep its
+// own per-edge data alongside a CompactDigraph (such as precomputed edge
+// weights) can keep it in an array indexed by position.
+//
+// The vertex numbers, offsets, targets and EdgeInfo arrays are SharedArrays,
+// so they can either be owned by the CompactDigraph or borrowed from memory
+// that belongs to something else, such as a file that was written in the
+// same layout and mapped into memory.  Borrowing them means that loading
+// such a file doesn't copy its edges at all.
+//
+// Searches that run backward from a destination need each vertex's
+// incoming edges, too.  Calling indexIncomingEdges() lays those out in a
+// second, reversed CSR layout, which lists the "from" index and the
+// position of each edge pointing to each vertex.  Those arrays are
+// SharedArrays, too, so a layout saved along with the rest can be handed
+// back with setIncomingEdges() instead of being built again.
+
+#ifndef COMPACTDIGRAPH_HPP
+#define COMPACTDIGRAPH_HPP
+
+#include <functional>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include "DigraphException.hpp"
+#include "FlatHashMap.hpp"
+#include "SharedArray.hpp"
+#include "ShortestPathSearch.hpp"
+#include "StrongComponents.hpp"
+
+
+
+template <typename VertexInfo, typename EdgeInfo>
+class CompactDigraph
+{
+public:
+    // The default constructor initializes an empty CompactDigraph, which
+    // contains no vertices and no edges.
+    CompactDigraph();
+
+    // This constructor takes already-built CSR arrays, which may either be
+    // handed over as std::vectors or borrowed (see SharedArray.hpp).  The
+    // vertex with index i has vertex number vertexNumbers[i] and info
+    // vertexInfos[i]; offsets must have one more element than there are
+    // vertices, and targets must contain vertex indexes, not vertex
+    // numbers.  If the arrays are inconsistent with one another, or a
+    // vertex has two edges to the same vertex, a DigraphException is
+    // thrown.
+    CompactDigraph(
+        SharedArray<int> vertexNumbers,
+        std::vector<VertexInfo> vertexInfos,
+        SharedArray<int> offsets,
+        SharedArray<int> targets,
+        SharedArray<EdgeInfo> edgeInfos);
+
+    // vertices() returns a std::vector containing the vertex numbers of
+    // every vertex in this CompactDigraph, in index order.
+    std::vector<int> vertices() const;
+
+    // edges() returns a std::vector of std::pairs, in which each pair
+    // contains the "from" and "to" vertex numbers of an edge in this
+    // CompactDigraph.  All edges are included in the std::vector.
+    std::vector<std::pair<int, int>> edges() const;
+
+    // This overload of edges() returns only the edges outgoing from the
+    // given vertex number.  If the given vertex does not exist, a
+    // DigraphException is thrown instead.
+    std::vector<std::pair<int, int>> edges(int vertex) const;
+
+    // vertexInfo() returns the VertexInfo object belonging to the vertex
+    // with the given vertex number.  If that vertex does not exist, a
+    // DigraphException is thrown instead.
+    const VertexInfo& vertexInfo(int vertex) const;
+
+    // edgeInfo() returns the EdgeInfo object belonging to the edge
+    // with the given "from" and "to" vertex numbers.  If either of those
+    // vertices does not exist *or* if the edge does not exist, a
+    // DigraphException is thrown instead.
+    const EdgeInfo& edgeInfo(int fromVertex, int toVertex) const;
+
+    // vertexCount() returns the number of vertices in the graph.
+    int vertexCount() const;
+
+    // edgeCount() returns the total number of edges in the graph.
+    int edgeCount() const;
+
+    // This overload of edgeCount() returns the number of edges outgoing
+    // from the given vertex number.  If the given vertex does not exist,
+    // a DigraphException is thrown instead.
+    int edgeCount(int vertex) const;
+
+    // isStronglyConnected() returns true if the graph is strongly
+    // connected (i.e., every vertex is reachable from every other),
+    // false otherwise.
+    bool isStronglyConnected() const;
+
+    // strongComponents() divides the graph into its strongly connected
+    // components, listing the component of each vertex by dense index,
+    // just as Digraph's does.
+    StrongComponents strongComponents() const;
+
+    // findShortestPaths() behaves exactly like Digraph's: it runs
+    // Dijkstra's algorithm from the given start vertex and returns a
+    // std::map from each vertex number to its predecessor on a shortest
+    // path, where vertices without a predecessor map to themselves.
+    std::map<int, int> findShortestPaths(
+        int startVertex,
+        std::function<double(const EdgeInfo&)> edgeWeightFunc) const;
+
+    // As with Digraph, this overload takes the edge weight function as
+    // any callable object, so the weight computation can be inlined.
+    template <typename WeightFunc>
+    std::map<int, int> findShortestPaths(
+        int startVertex, WeightFunc&& edgeWeightFunc) const;
+
+    // findShortestPath() finds the shortest path from one start vertex
+    // number to one end vertex number, using the same kind of edge weight
+    // function as findShortestPaths().  Unlike findShortestPaths(), it
+    // stops searching as soon as the path to the end vertex is known,
+    // which is much sooner when the two are near each other.  The path's
+    // vertices, the EdgeInfo of each edge along it, and its total cost
+    // are returned; if the end vertex isn't reachable, the path is empty
+    // and its cost is infinity.  If either vertex does not exist, a
+    // DigraphException is thrown instead.
+    ShortestPath<EdgeInfo> findShortestPath(
+        int startVertex, int endVertex,
+        std::function<double(const EdgeInfo&)> edgeWeightFunc) const;
+
+    // This overload of findShortestPath() takes the edge weight function
+    // as any callable object, for the same reason as findShortestPaths().
+    template <typename WeightFunc>
+    ShortestPath<EdgeInfo> findShortestPath(
+        int startVertex, int endVertex, WeightFunc&& edgeWeightFunc) const;
+
+    // This overload of findShortestPath() searches in the given
+    // SearchWorkspace instead of allocating its own.  Callers that find
+    // many paths can keep one workspace for all of them, so that each
+    // search costs time proportional to the part of the graph it visits,
+    // rather than to the size of the whole graph.
+    template <typename WeightFunc>
+    ShortestPath<EdgeInfo> findShortestPath(
+        int startVertex, int endVertex, WeightFunc&& edgeWeightFunc,
+        SearchWorkspace& workspace) const;
+
+    // toIndex() returns the dense index (between 0 and vertexCount() - 1)
+    // of the given vertex number.  If the vertex does not exist, a
+    // DigraphException is thrown instead.
+    int toIndex(int vertex) const;
+
+    // toVertexNumber() returns the vertex number of the vertex with the
+    // given dense index.  If there is no such index, a DigraphException
+    // is thrown instead.
+    int toVertexNumber(int index) const;
+
+    // forEachOutEdge() calls visit(toIndex, einfo) for each edge outgoing
+    // from the vertex with the given dense index.  This is how the
+    // algorithms in ShortestPathSearch.hpp traverse a CompactDigraph.
+    template <typename Visit>
+    void forEachOutEdge(int index, Visit&& visit) const;
+
+    // indexIncomingEdges() builds the reversed CSR layout of the incoming
+    // edges, in time proportional to the number of vertices plus the
+    // number of edges.  Calling it again has no effect.
+    void indexIncomingEdges();
+
+    // setIncomingEdges() gives this CompactDigraph the reversed layout of
+    // its incoming edges, as indexIncomingEdges() would have built it
+    // (e.g., borrowed from a file it was saved in), replacing any it
+    // already has.  Every slot is checked against the edge it names, in
+    // time proportional to the number of vertices plus the number of
+    // edges: if the arrays have the wrong sizes, their offsets are out of
+    // order, or the slots don't list each edge exactly once, under the
+    // vertex it points to and with its own "from" index, a
+    // DigraphException is thrown instead.
+    void setIncomingEdges(
+        SharedArray<int> inOffsets, SharedArray<int> inSources,
+        SharedArray<int> inPositions);
+
+    // incomingEdgesIndexed() returns true if indexIncomingEdges() or
+    // setIncomingEdges() has been called on this CompactDigraph.
+    bool incomingEdgesIndexed() const;
+
+    // forEachInEdge() calls visit(fromIndex, einfo) for each edge pointing
+    // to the vertex with the given dense index, which is how a search
+    // runs backward over a CompactDigraph.  It's only cheap when the
+    // incoming edges are indexed; otherwise, it scans every edge.
+    template <typename Visit>
+    void forEachInEdge(int index, Visit&& visit) const;
+
+    // inEdgeBegin() and inEdgeEnd() return the range of slots in the
+    // reversed layout occupied by the edges pointing to the vertex with
+    // the given dense index, and inEdgeSource() and inEdgePosition()
+    // return the "from" index and the position of the edge in a slot.
+    // They may only be called once the incoming edges are indexed.
+    int inEdgeBegin(int index) const;
+    int inEdgeEnd(int index) const;
+    int inEdgeSource(int slot) const;
+    int inEdgePosition(int slot) const;
+
+    // edgeBegin() and edgeEnd() return the range of positions occupied
+    // by the edges outgoing from the vertex with the given dense index:
+    // edgeBegin(index) through edgeEnd(index) - 1.
+    int edgeBegin(int index) const;
+    int edgeEnd(int index) const;
+
+    // edgeTarget() and edgeInfoAt() return the dense index of the vertex
+    // the edge at the given position points to, and that edge's EdgeInfo.
+    int edgeTarget(int position) const;
+    const EdgeInfo& edgeInfoAt(int position) const;
+
+    // edgePosition() returns the position of the edge with the given
+    // "from" and "to" vertex numbers.  If either of those vertices does
+    // not exist *or* if the edge does not exist, a DigraphException is
+    // thrown instead.
+    int edgePosition(int fromVertex, int toVertex) const;
+
+    // setEdgeInfo() replaces the EdgeInfo of the edge with the given
+    // "from" and "to" vertex numbers, leaving the graph's structure (and
+    // therefore every edge's position) unchanged.  If either of those
+    // vertices does not exist *or* if the edge does not exist, a
+    // DigraphException is thrown instead.
+    void setEdgeInfo(int fromVertex, int toVertex, const EdgeInfo& einfo);
+
+private:
+    // findEdge() returns the position in targets_ and edgeInfos_ of the
+    // edge between the vertices with the given indexes, or -1 if there
+    // is no such edge.
+    int findEdge(int fromIndex, int targetIndex) const;
+
+private:
+    SharedArray<int> vertexNumbers_;
+    std::vector<VertexInfo> vertexInfos_;
+    SharedArray<int> offsets_;
+    SharedArray<int> targets_;
+    SharedArray<EdgeInfo> edgeInfos_;
+    FlatHashMap<int, int> indexes_;
+    SharedArray<int> inOffsets_;
+    SharedArray<int> inSources_;
+    SharedArray<int> inPositions_;
+};
+
+
+
+template <typename VertexInfo, typename EdgeInfo>
+CompactDigraph<VertexInfo, EdgeInfo>::CompactDigraph()
+    : offsets_{std::vector<int>{0}}
+{
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+CompactDigraph<VertexInfo, EdgeInfo>::CompactDigraph(
+    SharedArray<int> vertexNumbers,
+    std::vector<VertexInfo> vertexInfos,
+    SharedArray<int> offsets,
+    SharedArray<int> targets,
+    SharedArray<EdgeInfo> edgeInfos)
+    : vertexNumbers_{std::move(vertexNumbers)},
+      vertexInfos_{std::move(vertexInfos)},
+      offsets_{std::move(offsets)},
+      targets_{std::move(targets)},
+      edgeInfos_{std::move(edgeInfos)}
+{
+    int count = static_cast<int>(vertexNumbers_.size());
+
+    if (vertexInfos_.size() != vertexNumbers_.size()
+        || offsets_.size() != vertexNumbers_.size() + 1
+        || targets_.size() != edgeInfos_.size()
+        || offsets_.front() != 0
+        || offsets_.back() != static_cast<int>(targets_.size()))
+    {
+        throw DigraphException{"inconsistent compact digraph arrays"};
+    }
+
+    for (int i = 0; i < count; ++i)
+    {
+        if (offsets_[i + 1] < offsets_[i])
+        {
+            throw DigraphException{"edge offsets out of order"};
+        }
+    }
+
+    // Each target is stamped with the index of the vertex whose edges it
+    // was last seen among, so a repeated one is found in a single pass.
+    std::vector<int> stamps(count, -1);
+
+    for (int i = 0; i < count; ++i)
+    {
+        for (int e = offsets_[i]; e < offsets_[i + 1]; ++e)
+        {
+            int target = targets_[e];
+
+            if (target < 0 || target >= count)
+            {
+                throw DigraphException{"edge target out of range"};
+            }
+
+            if (stamps[target] == i)
+            {
+                throw DigraphException{"edge already exists"};
+            }
+
+            stamps[target] = i;
+        }
+    }
+
+    indexes_.reserve(count);
+
+    for (int i = 0; i < count; ++i)
+    {
+        if (!indexes_.insert(vertexNumbers_[i], i))
+        {
+            throw DigraphException{"vertex already exists"};
+        }
+    }
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+std::vector<int> CompactDigraph<VertexInfo, EdgeInfo>::vertices() const
+{
+    return std::vector<int>(vertexNumbers_.begin(), vertexNumbers_.end());
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+std::vector<std::pair<int, int>> CompactDigraph<VertexInfo, EdgeInfo>::edges() const
+{
+    std::vector<std::pair<int, int>> result;
+    result.reserve(targets_.size());
+
+    for (int from = 0; from < vertexCount(); ++from)
+    {
+        for (int e = offsets_[from]; e < offsets_[from + 1]; ++e)
+        {
+            result.emplace_back(vertexNumbers_[from], vertexNumbers_[targets_[e]]);
+        }
+    }
+
+    return result;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+std::vector<std::pair<int, int>> CompactDigraph<VertexInfo, EdgeInfo>::edges(int vertex) const
+{
+    int from = toIndex(vertex);
+
+    std::vector<std::pair<int, int>> result;
+    result.reserve(offsets_[from + 1] - offsets_[from]);
+
+    for (int e = offsets_[from]; e < offsets_[from + 1]; ++e)
+    {
+        result.emplace_back(vertex, vertexNumbers_[targets_[e]]);
+    }
+
+    return result;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+const VertexInfo& CompactDigraph<VertexInfo, EdgeInfo>::vertexInfo(int vertex) const
+{
+    return vertexInfos_[toIndex(vertex)];
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+const EdgeInfo& CompactDigraph<VertexInfo, EdgeInfo>::edgeInfo(int fromVertex, int toVertex) const
+{
+    return edgeInfos_[edgePosition(fromVertex, toVertex)];
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+int CompactDigraph<VertexInfo, EdgeInfo>::vertexCount() const
+{
+    return static_cast<int>(vertexNumbers_.size());
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+int CompactDigraph<VertexInfo, EdgeInfo>::edgeCount() const
+{
+    return static_cast<int>(targets_.size());
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+int CompactDigraph<VertexInfo, EdgeInfo>::edgeCount(int vertex) const
+{
+    int from = toIndex(vertex);
+    return offsets_[from + 1] - offsets_[from];
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+bool CompactDigraph<VertexInfo, EdgeInfo>::isStronglyConnected() const
+{
+    // A graph with no vertices has no components, so it's not considered
+    // strongly connected.
+    return strongComponents().componentCount == 1;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+StrongComponents CompactDigraph<VertexInfo, EdgeInfo>::strongComponents() const
+{
+    return findStrongComponents(*this);
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+std::map<int, int> CompactDigraph<VertexInfo, EdgeInfo>::findShortestPaths(
+    int startVertex,
+    std::function<double(const EdgeInfo&)> edgeWeightFunc) const
+{
+    ShortestPathSearch search;
+    search.run(*this, toIndex(startVertex), edgeWeightFunc);
+    return search.predecessorMap(*this);
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+template <typename WeightFunc>
+std::map<int, int> CompactDigraph<VertexInfo, EdgeInfo>::findShortestPaths(
+    int startVertex, WeightFunc&& edgeWeightFunc) const
+{
+    ShortestPathSearch search;
+    search.run(*this, toIndex(startVertex), edgeWeightFunc);
+    return search.predecessorMap(*this);
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+ShortestPath<EdgeInfo> CompactDigraph<VertexInfo, EdgeInfo>::findShortestPath(
+    int startVertex, int endVertex,
+    std::function<double(const EdgeInfo&)> edgeWeightFunc) const
+{
+    int endIndex = toIndex(endVertex);
+
+    ShortestPathSearch search;
+    search.run(*this, toIndex(startVertex), edgeWeightFunc, endIndex);
+    return search.pathTo<EdgeInfo>(*this, endIndex);
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+template <typename WeightFunc>
+ShortestPath<EdgeInfo> CompactDigraph<VertexInfo, EdgeInfo>::findShortestPath(
+    int startVertex, int endVertex, WeightFunc&& edgeWeightFunc) const
+{
+    SearchWorkspace workspace;
+    return findShortestPath(startVertex, endVertex, edgeWeightFunc, workspace);
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+template <typename WeightFunc>
+ShortestPath<EdgeInfo> CompactDigraph<VertexInfo, EdgeInfo>::findShortestPath(
+    int startVertex, int endVertex, WeightFunc&& edgeWeightFunc,
+    SearchWorkspace& workspace) const
+{
+    int endIndex = toIndex(endVertex);
+
+    ShortestPathSearch search{workspace};
+    search.run(*this, toIndex(startVertex), edgeWeightFunc, endIndex);
+    return search.pathTo<EdgeInfo>(*this, endIndex);
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+int CompactDigraph<VertexInfo, EdgeInfo>::toIndex(int vertex) const
+{
+    const int* found = indexes_.find(vertex);
+
+    if (found == nullptr)
+    {
+        throw DigraphException{"vertex does not exist"};
+    }
+
+    return *found;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+int CompactDigraph<VertexInfo, EdgeInfo>::toVertexNumber(int index) const
+{
+    if (index < 0 || index >= vertexCount())
+    {
+        throw DigraphException{"index does not exist"};
+    }
+
+    return vertexNumbers_[index];
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+template <typename Visit>
+void CompactDigraph<VertexInfo, EdgeInfo>::forEachOutEdge(int index, Visit&& visit) const
+{
+    for (int e = offsets_[index]; e < offsets_[index + 1]; ++e)
+    {
+        visit(targets_[e], edgeInfos_[e]);
+    }
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+void CompactDigraph<VertexInfo, EdgeInfo>::indexIncomingEdges()
+{
+    if (incomingEdgesIndexed())
+    {
+        return;
+    }
+
+    // A counting sort of the edges by target: count each vertex's incoming
+    // edges, turn the counts into offsets, then place each edge, visiting
+    // them in position order so that each vertex's list is sorted by
+    // "from" index.
+
+    std::vector<int> offsets(vertexCount() + 1, 0);
+
+    for (int target : targets_)
+    {
+        ++offsets[target + 1];
+    }
+
+    for (int i = 0; i < vertexCount(); ++i)
+    {
+        offsets[i + 1] += offsets[i];
+    }
+
+    std::vector<int> sources(edgeCount());
+    std::vector<int> positions(edgeCount());
+    std::vector<int> next(offsets.begin(), offsets.end() - 1);
+
+    for (int from = 0; from < vertexCount(); ++from)
+    {
+        for (int e = offsets_[from]; e < offsets_[from + 1]; ++e)
+        {
+            int slot = next[targets_[e]]++;
+            sources[slot] = from;
+            positions[slot] = e;
+        }
+    }
+
+    inOffsets_ = std::move(offsets);
+    inSources_ = std::move(sources);
+    inPositions_ = std::move(positions);
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+void CompactDigraph<VertexInfo, EdgeInfo>::setIncomingEdges(
+    SharedArray<int> inOffsets, SharedArray<int> inSources, SharedArray<int> inPositions)
+{
+    int count = vertexCount();
+
+    if (inOffsets.size() != static_cast<std::size_t>(count) + 1
+        || inSources.size() != targets_.size()
+        || inPositions.size() != targets_.size()
+        || inOffsets.front() != 0
+        || inOffsets.back() != edgeCount())
+    {
+        throw DigraphException{"inconsistent incoming edge arrays"};
+    }
+
+    for (int i = 0; i < count; ++i)
+    {
+        if (inOffsets[i + 1] < inOffsets[i])
+        {
+            throw DigraphException{"incoming edge offsets out of order"};
+        }
+    }
+
+    // A backward search trusts each slot to name an edge that really
+    // points to the slot's vertex from the slot's source, so each one is
+    // checked against the edge at its position, and no edge may be listed
+    // twice (which, since there are as many slots as edges, also means
+    // that none is missing).
+
+    std::vector<char> listed(edgeCount(), 0);
+
+    for (int v = 0; v < count; ++v)
+    {
+        for (int slot = inOffsets[v]; slot < inOffsets[v + 1]; ++slot)
+        {
+            int source = inSources[slot];
+            int position = inPositions[slot];
+
+            if (source < 0 || source >= count || position < 0 || position >= edgeCount())
+            {
+                throw DigraphException{"incoming edge out of range"};
+            }
+
+            if (targets_[position] != v
+                || position < offsets_[source] || position >= offsets_[source + 1]
+                || listed[position])
+            {
+                throw DigraphException{"incoming edge does not match the graph's edges"};
+            }
+
+            listed[position] = 1;
+        }
+    }
+
+    inOffsets_ = std::move(inOffsets);
+    inSources_ = std::move(inSources);
+    inPositions_ = std::move(inPositions);
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+bool CompactDigraph<VertexInfo, EdgeInfo>::incomingEdgesIndexed() const
+{
+    return !inOffsets_.empty();
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+template <typename Visit>
+void CompactDigraph<VertexInfo, EdgeInfo>::forEachInEdge(int index, Visit&& visit) const
+{
+    if (incomingEdgesIndexed())
+    {
+        for (int slot = inOffsets_[index]; slot < inOffsets_[index + 1]; ++slot)
+        {
+            visit(inSources_[slot], edgeInfos_[inPositions_[slot]]);
+        }
+
+        return;
+    }
+
+    for (int from = 0; from < vertexCount(); ++from)
+    {
+        for (int e = offsets_[from]; e < offsets_[from + 1]; ++e)
+        {
+            if (targets_[e] == index)
+            {
+                visit(from, edgeInfos_[e]);
+            }
+        }
+    }
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+int CompactDigraph<VertexInfo, EdgeInfo>::inEdgeBegin(int index) const
+{
+    return inOffsets_[index];
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+int CompactDigraph<VertexInfo, EdgeInfo>::inEdgeEnd(int index) const
+{
+    return inOffsets_[index + 1];
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+int CompactDigraph<VertexInfo, EdgeInfo>::inEdgeSource(int slot) const
+{
+    return inSources_[slot];
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+int CompactDigraph<VertexInfo, EdgeInfo>::inEdgePosition(int slot) const
+{
+    return inPositions_[slot];
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+int CompactDigraph<VertexInfo, EdgeInfo>::edgeBegin(int index) const
+{
+    return offsets_[index];
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+int CompactDigraph<VertexInfo, EdgeInfo>::edgeEnd(int index) const
+{
+    return offsets_[index + 1];
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+int CompactDigraph<VertexInfo, EdgeInfo>::edgeTarget(int position) const
+{
+    return targets_[position];
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+const EdgeInfo& CompactDigraph<VertexInfo, EdgeInfo>::edgeInfoAt(int position) const
+{
+    return edgeInfos_[position];
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+int CompactDigraph<VertexInfo, EdgeInfo>::edgePosition(int fromVertex, int toVertex) const
+{
+    int e = findEdge(toIndex(fromVertex), toIndex(toVertex));
+
+    if (e < 0)
+    {
+        throw DigraphException{"edge does not exist"};
+    }
+
+    return e;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+void CompactDigraph<VertexInfo, EdgeInfo>::setEdgeInfo(
+    int fromVertex, int toVertex, const EdgeInfo& einfo)
+{
+    edgeInfos_.mutableAt(edgePosition(fromVertex, toVertex)) = einfo;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+int CompactDigraph<VertexInfo, EdgeInfo>::findEdge(int fromIndex, int targetIndex) const
+{
+    for (int e = offsets_[fromIndex]; e < offsets_[fromIndex + 1]; ++e)
+    {
+        if (targets_[e] == targetIndex)
+        {
+            return e;
+        }
+    }
+
+    return -1;
+}
+
+
+
+#endif // COMPACTDIGRAPH_HPP
+
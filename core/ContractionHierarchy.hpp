@@ -0,0 +1,1188 @@
+// ContractionHierarchy.hpp
+//
+// ICS 46 Spring 2016
+// Project #4: Rock and Roll Stops the Traffic
+//
+// A ContractionHierarchy answers shortest path queries on a graph whose
+// weights rarely change far faster than Dijkstra's algorithm can, in
+// exchange for preprocessing done once in advance.  Preprocessing
+// "contracts" the vertices one at a time, from least important to most:
+// each is removed from the graph, and wherever a shortest path ran through
+// it between two of its remaining neighbors, a shortcut with the combined
+// weight is added between them, recording the removed vertex as its
+// middle.  A vertex's rank is its position in that order.
+//
+// Every vertex then keeps only its arcs to and from vertices of higher
+// rank, and every shortest path has an equally short counterpart in the
+// hierarchy that climbs in rank and then descends, so it can be found by
+// two searches that only ever go upward (see ContractionHierarchyQuery).
+// The shortcuts on the path it finds are unpacked back into the original
+// edges by following their middle vertices.
+//
+// The order is chosen greedily by each vertex's priority: its edge
+// difference (the number of shortcuts contracting it would add, minus the
+// number of arcs it would remove), weighted most heavily, plus the number
+// of its neighbors already contracted and its level (one more than the
+// highest level among them), both of which spread the contraction evenly
+// across the graph.  Whether a shortcut is needed is decided by a witness
+// search: a small Dijkstra search from one neighbor that avoids the vertex
+// being contracted, which makes the shortcut unnecessary if it finds
+// another path to the other neighbor that's no longer.  A witness search
+// gives up after settling a fixed number of vertices, which may add a
+// shortcut that wasn't needed, but never leaves out one that was.  Since
+// priorities are recomputed far more often than vertices are contracted,
+// the searches that estimate them give up much sooner.
+//
+// Preprocessing runs on several threads.  In each round, the vertices
+// whose priority is lower than all of their neighbors' form an independent
+// set, whose shortcuts the threads find in parallel, and then the whole
+// set is removed.  The result is as if the set's vertices had been
+// contracted one at a time in order of priority, except that a witness
+// search doesn't see the shortcuts of the vertices contracted before its
+// own; it avoids those vertices instead, so every witness it finds is
+// still a real path, though it may miss some.
+//
+// The arcs are kept in flat arrays indexed like a CompactDigraph's edges:
+// the forward arcs, leaving each vertex toward higher-ranked ones, and the
+// backward arcs, entering each vertex from higher-ranked ones.  Like a
+// CompactDigraph's, they can be borrowed from a memory-mapped file, so a
+// hierarchy built once can be saved and reloaded without being rebuilt.
+//
+// The graph can be of any type that provides these member functions:
+//
+// * int vertexCount() const, returning the number of dense indexes
+// * forEachOutEdge(int index, Visit visit) const, calling visit(toIndex,
+//   einfo) for each edge outgoing from the vertex with the given index
+
+#ifndef CONTRACTIONHIERARCHY_HPP
+#define CONTRACTIONHIERARCHY_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "DigraphException.hpp"
+#include "SearchWorkspace.hpp"
+#include "SharedArray.hpp"
+#include "ShortestPathSearch.hpp"
+
+
+
+// A HierarchyArc is one arc of a ContractionHierarchy: the index of the
+// vertex at its other end, the index of its middle vertex (or -1 if it's
+// an edge of the original graph), and its weight.
+
+struct HierarchyArc
+{
+    int vertex;
+    int middle;
+    double weight;
+};
+
+
+
+// A HierarchyArcRange is a read-only view of the arcs of one vertex.
+
+class HierarchyArcRange
+{
+public:
+    HierarchyArcRange(const HierarchyArc* begin, const HierarchyArc* end);
+
+    const HierarchyArc* begin() const;
+    const HierarchyArc* end() const;
+
+private:
+    const HierarchyArc* begin_;
+    const HierarchyArc* end_;
+};
+
+
+
+class ContractionHierarchy
+{
+public:
+    // The default constructor initializes an empty hierarchy.
+    ContractionHierarchy();
+
+    // This constructor initializes a hierarchy from its arrays: the rank
+    // of each vertex, and the forward and backward arcs, laid out the way
+    // a CompactDigraph lays out its edges.  Only the sizes of the arrays
+    // are checked here; if they don't agree, a DigraphException is thrown.
+    // The ranks and arcs themselves are checked by verify(), which must be
+    // called before querying a hierarchy whose arrays came from outside
+    // the program, such as from a file.
+    ContractionHierarchy(
+        SharedArray<int> ranks,
+        SharedArray<int> forwardOffsets, SharedArray<HierarchyArc> forwardArcs,
+        SharedArray<int> backwardOffsets, SharedArray<HierarchyArc> backwardArcs);
+
+    // build() contracts the given graph, whose edge weights are determined
+    // by calling weightFunc on each edge's EdgeInfo and must not be
+    // negative, using the given number of threads.  A thread count of zero
+    // (the default) means one thread per hardware thread.
+    template <typename Graph, typename WeightFunc>
+    static ContractionHierarchy build(
+        const Graph& graph, WeightFunc&& weightFunc, int threadCount = 0);
+
+    // verify() checks every rank and every arc, throwing a
+    // DigraphException if any rank is out of range, any vertex's arcs are
+    // out of order, any arc doesn't lead upward or has a middle vertex
+    // that isn't ranked below both of its ends, or any shortcut lacks
+    // either of the two arcs it unpacks into.  It takes time linear in the
+    // size of the hierarchy, plus the time to find each shortcut's two
+    // halves among the arcs of its middle vertex.
+    void verify() const;
+
+    // vertexCount() returns the number of vertices, and arcCount() the
+    // number of arcs in both directions, including shortcuts.
+    int vertexCount() const;
+    int arcCount() const;
+
+    // rank() returns the rank of the vertex with the given index.
+    int rank(int index) const;
+
+    // order() lists the indexes of the vertices from highest rank to
+    // lowest, which is the order HubLabels take them in.
+    std::vector<int> order() const;
+
+    // forwardArcs() returns the arcs leaving the vertex with the given
+    // index, and backwardArcs() the arcs entering it, each of whose vertex
+    // is the one it comes from.
+    HierarchyArcRange forwardArcs(int index) const;
+    HierarchyArcRange backwardArcs(int index) const;
+
+    // unpack() appends to vertices the indexes of the vertices along the
+    // original edges that the arc from the vertex with index fromIndex to
+    // the one with index toIndex stands for, not including fromIndex.  If
+    // there is no such arc, a DigraphException is thrown.
+    void unpack(int fromIndex, int toIndex, std::vector<int>& vertices) const;
+
+    // These functions return the hierarchy's arrays, in the form the
+    // constructor takes them, so they can be saved.
+    const SharedArray<int>& rankArray() const;
+    const SharedArray<int>& forwardOffsetArray() const;
+    const SharedArray<HierarchyArc>& forwardArcArray() const;
+    const SharedArray<int>& backwardOffsetArray() const;
+    const SharedArray<HierarchyArc>& backwardArcArray() const;
+
+private:
+    class Contractor;
+
+    // findArc() returns the arc from the vertex with index fromIndex to
+    // the one with index toIndex, wherever the hierarchy keeps it, and
+    // arcBetween() returns a pointer to it, or nullptr if there is none.
+    const HierarchyArc& findArc(int fromIndex, int toIndex) const;
+    const HierarchyArc* arcBetween(int fromIndex, int toIndex) const;
+
+    void checkArcs(
+        const SharedArray<int>& offsets, const SharedArray<HierarchyArc>& arcs) const;
+
+    void verifyArcs(
+        const SharedArray<int>& offsets, const SharedArray<HierarchyArc>& arcs) const;
+
+    // verifyShortcuts() checks that both halves of every shortcut among
+    // the given arcs exist; forward is true for the forward arcs, whose
+    // vertex is the one each leads to, and false for the backward arcs,
+    // whose vertex is the one each comes from.
+    void verifyShortcuts(
+        const SharedArray<int>& offsets, const SharedArray<HierarchyArc>& arcs,
+        bool forward) const;
+
+private:
+    SharedArray<int> ranks_;
+    SharedArray<int> forwardOffsets_;
+    SharedArray<HierarchyArc> forwardArcs_;
+    SharedArray<int> backwardOffsets_;
+    SharedArray<HierarchyArc> backwardArcs_;
+};
+
+
+
+// A Contractor holds a graph while it's being contracted: the arcs into
+// and out of each vertex not yet contracted, including the shortcuts added
+// so far.  Once a vertex is contracted, its arcs are no longer changed, and
+// they're exactly its arcs in the finished hierarchy.
+
+class ContractionHierarchy::Contractor
+{
+public:
+    explicit Contractor(int vertexCount);
+
+    // addEdge() adds an edge of the original graph, keeping only the
+    // lighter of any two edges between the same vertices.
+    void addEdge(int fromIndex, int toIndex, double weight);
+
+    // contract() contracts every vertex, using the given number of
+    // threads, and returns the finished hierarchy.
+    ContractionHierarchy contract(int threadCount);
+
+private:
+    struct Shortcut
+    {
+        int fromIndex;
+        int toIndex;
+        int middle;
+        double weight;
+    };
+
+    // runWitnessSearch() searches from the given source through the
+    // vertices not yet contracted, avoiding the given vertex and the
+    // vertices in the current round that come before it, until it has
+    // settled targetCount of the given vertex's out-neighbors, every
+    // vertex within the given limit, or settleLimit vertices.
+    void runWitnessSearch(
+        SearchWorkspace& workspace, int source, int avoid, int targetCount,
+        double limit, int settleLimit) const;
+
+    // isTarget() returns true if there is an arc from the vertex with
+    // index v to the one with index w.
+    bool isTarget(int w, int v) const;
+
+    // findShortcuts() appends to shortcuts every shortcut that contracting
+    // the given vertex would add, according to witness searches that give
+    // up after settling settleLimit vertices.
+    void findShortcuts(
+        SearchWorkspace& workspace, int v, int settleLimit,
+        std::vector<Shortcut>& shortcuts) const;
+
+    // priority() returns the given vertex's priority: three times its edge
+    // difference, plus the number of its neighbors already contracted,
+    // plus its level.
+    int priority(SearchWorkspace& workspace, int v, std::vector<Shortcut>& scratch) const;
+
+    // comesBefore() returns true if the vertex with index v comes before
+    // the one with index w, ordered by priority and then by index, and
+    // isLocalMinimum() returns true if the given vertex comes before every
+    // one of its neighbors.
+    bool comesBefore(int v, int w) const;
+    bool isLocalMinimum(int v) const;
+
+    static void addOrImprove(std::vector<HierarchyArc>& arcs, int vertex, int middle, double weight);
+    static void removeArc(std::vector<HierarchyArc>& arcs, int vertex);
+
+    // parallelFor() calls work(thread, i) for each i from 0 up to count,
+    // spread across the given number of threads.
+    template <typename Work>
+    static void parallelFor(int count, int threadCount, Work work);
+
+private:
+    static const int simulationSettleLimit = 30;
+    static const int contractionSettleLimit = 500;
+
+    std::vector<std::vector<HierarchyArc>> out_;
+    std::vector<std::vector<HierarchyArc>> in_;
+    std::vector<char> contracted_;
+    std::vector<char> inRound_;
+    std::vector<char> stale_;
+    std::vector<int> priorities_;
+    std::vector<int> contractedNeighbors_;
+    std::vector<int> levels_;
+};
+
+
+
+class ContractionHierarchyQuery
+{
+public:
+    // The default constructor initializes a query that owns its own
+    // SearchWorkspaces.
+    ContractionHierarchyQuery();
+
+    // This constructor initializes a query that works in the given
+    // SearchWorkspaces, one for each direction, which must outlive it.
+    ContractionHierarchyQuery(SearchWorkspace& forward, SearchWorkspace& backward);
+
+    // A query can't be copied, since it may be borrowing its workspaces.
+    ContractionHierarchyQuery(const ContractionHierarchyQuery&) = delete;
+    ContractionHierarchyQuery& operator=(const ContractionHierarchyQuery&) = delete;
+
+    // run() finds the shortest path in the given hierarchy from the vertex
+    // with the given start index to the vertex with the given target
+    // index, replacing the results of any previous run.  Each direction
+    // stops once the smallest distance left in its heap is no less than
+    // the best path found so far.
+    void run(const ContractionHierarchy& hierarchy, int startIndex, int targetIndex);
+
+    // settledCount() returns the number of vertices settled by the last
+    // run, counting both directions.
+    int settledCount() const;
+
+    // reached() returns true if the last run found a path.
+    bool reached() const;
+
+    // distance() returns the length of the path found by the last run, or
+    // infinity if there was none.
+    double distance() const;
+
+    // path() returns the path found by the last run on the given
+    // hierarchy, which was built from the given graph, with its shortcuts
+    // unpacked into the graph's own edges, in the same form as
+    // ShortestPathSearch::pathTo().
+    template <typename EdgeInfo, typename Graph>
+    ShortestPath<EdgeInfo> path(const ContractionHierarchy& hierarchy, const Graph& graph) const;
+
+private:
+    void settleNext(
+        const ContractionHierarchy& hierarchy, bool forward,
+        SearchWorkspace& mine, SearchWorkspace& other);
+
+private:
+    SearchWorkspace ownForward_;
+    SearchWorkspace ownBackward_;
+    SearchWorkspace* forward_;
+    SearchWorkspace* backward_;
+    int settledCount_;
+    double bestDistance_;
+    int meetingIndex_;
+};
+
+
+
+inline HierarchyArcRange::HierarchyArcRange(const HierarchyArc* begin, const HierarchyArc* end)
+    : begin_{begin}, end_{end}
+{
+}
+
+
+inline const HierarchyArc* HierarchyArcRange::begin() const
+{
+    return begin_;
+}
+
+
+inline const HierarchyArc* HierarchyArcRange::end() const
+{
+    return end_;
+}
+
+
+
+inline ContractionHierarchy::ContractionHierarchy()
+    : forwardOffsets_{std::vector<int>{0}}, backwardOffsets_{std::vector<int>{0}}
+{
+}
+
+
+inline ContractionHierarchy::ContractionHierarchy(
+    SharedArray<int> ranks,
+    SharedArray<int> forwardOffsets, SharedArray<HierarchyArc> forwardArcs,
+    SharedArray<int> backwardOffsets, SharedArray<HierarchyArc> backwardArcs)
+    : ranks_{std::move(ranks)},
+      forwardOffsets_{std::move(forwardOffsets)},
+      forwardArcs_{std::move(forwardArcs)},
+      backwardOffsets_{std::move(backwardOffsets)},
+      backwardArcs_{std::move(backwardArcs)}
+{
+    checkArcs(forwardOffsets_, forwardArcs_);
+    checkArcs(backwardOffsets_, backwardArcs_);
+}
+
+
+template <typename Graph, typename WeightFunc>
+ContractionHierarchy ContractionHierarchy::build(
+    const Graph& graph, WeightFunc&& weightFunc, int threadCount)
+{
+    Contractor contractor{graph.vertexCount()};
+
+    for (int v = 0; v < graph.vertexCount(); ++v)
+    {
+        graph.forEachOutEdge(
+            v,
+            [&](int w, const auto& einfo)
+            {
+                contractor.addEdge(v, w, weightFunc(einfo));
+            });
+    }
+
+    if (threadCount <= 0)
+    {
+        threadCount = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+
+    return contractor.contract(threadCount);
+}
+
+
+inline int ContractionHierarchy::vertexCount() const
+{
+    return static_cast<int>(ranks_.size());
+}
+
+
+inline int ContractionHierarchy::arcCount() const
+{
+    return static_cast<int>(forwardArcs_.size() + backwardArcs_.size());
+}
+
+
+inline int ContractionHierarchy::rank(int index) const
+{
+    return ranks_[index];
+}
+
+
+inline std::vector<int> ContractionHierarchy::order() const
+{
+    int count = vertexCount();
+    std::vector<int> order(count);
+
+    for (int v = 0; v < count; ++v)
+    {
+        order[count - 1 - rank(v)] = v;
+    }
+
+    return order;
+}
+
+
+inline HierarchyArcRange ContractionHierarchy::forwardArcs(int index) const
+{
+    return HierarchyArcRange{
+        forwardArcs_.data() + forwardOffsets_[index],
+        forwardArcs_.data() + forwardOffsets_[index + 1]};
+}
+
+
+inline HierarchyArcRange ContractionHierarchy::backwardArcs(int index) const
+{
+    return HierarchyArcRange{
+        backwardArcs_.data() + backwardOffsets_[index],
+        backwardArcs_.data() + backwardOffsets_[index + 1]};
+}
+
+
+inline void ContractionHierarchy::unpack(int fromIndex, int toIndex, std::vector<int>& vertices) const
+{
+    // The middle vertex of a shortcut is ranked below both of its ends, so
+    // each level of unpacking is closer to the bottom of the hierarchy.
+    int middle = findArc(fromIndex, toIndex).middle;
+
+    if (middle < 0)
+    {
+        vertices.push_back(toIndex);
+    }
+    else
+    {
+        unpack(fromIndex, middle, vertices);
+        unpack(middle, toIndex, vertices);
+    }
+}
+
+
+inline const SharedArray<int>& ContractionHierarchy::rankArray() const
+{
+    return ranks_;
+}
+
+
+inline const SharedArray<int>& ContractionHierarchy::forwardOffsetArray() const
+{
+    return forwardOffsets_;
+}
+
+
+inline const SharedArray<HierarchyArc>& ContractionHierarchy::forwardArcArray() const
+{
+    return forwardArcs_;
+}
+
+
+inline const SharedArray<int>& ContractionHierarchy::backwardOffsetArray() const
+{
+    return backwardOffsets_;
+}
+
+
+inline const SharedArray<HierarchyArc>& ContractionHierarchy::backwardArcArray() const
+{
+    return backwardArcs_;
+}
+
+
+inline const HierarchyArc& ContractionHierarchy::findArc(int fromIndex, int toIndex) const
+{
+    const HierarchyArc* arc = arcBetween(fromIndex, toIndex);
+
+    if (arc == nullptr)
+    {
+        throw DigraphException{"hierarchy arc does not exist"};
+    }
+
+    return *arc;
+}
+
+
+inline const HierarchyArc* ContractionHierarchy::arcBetween(int fromIndex, int toIndex) const
+{
+    // An arc leading upward is a forward arc of its lower end; one leading
+    // downward is a backward arc of its lower end.
+
+    bool upward = rank(toIndex) > rank(fromIndex);
+    int lower = upward ? fromIndex : toIndex;
+    int other = upward ? toIndex : fromIndex;
+
+    for (const HierarchyArc& arc : upward ? forwardArcs(lower) : backwardArcs(lower))
+    {
+        if (arc.vertex == other)
+        {
+            return &arc;
+        }
+    }
+
+    return nullptr;
+}
+
+
+inline void ContractionHierarchy::verify() const
+{
+    int count = vertexCount();
+
+    for (int rank : ranks_)
+    {
+        if (rank < 0 || rank >= count)
+        {
+            throw DigraphException{"vertex rank out of range"};
+        }
+    }
+
+    verifyArcs(forwardOffsets_, forwardArcs_);
+    verifyArcs(backwardOffsets_, backwardArcs_);
+
+    // The halves of a shortcut may be kept in either direction's arrays,
+    // so they're only looked for once both have been checked.
+    verifyShortcuts(forwardOffsets_, forwardArcs_, true);
+    verifyShortcuts(backwardOffsets_, backwardArcs_, false);
+}
+
+
+inline void ContractionHierarchy::checkArcs(
+    const SharedArray<int>& offsets, const SharedArray<HierarchyArc>& arcs) const
+{
+    if (offsets.size() != ranks_.size() + 1
+        || offsets.front() != 0
+        || offsets.back() != static_cast<int>(arcs.size()))
+    {
+        throw DigraphException{"inconsistent contraction hierarchy arrays"};
+    }
+}
+
+
+inline void ContractionHierarchy::verifyArcs(
+    const SharedArray<int>& offsets, const SharedArray<HierarchyArc>& arcs) const
+{
+    int count = vertexCount();
+
+    for (int v = 0; v < count; ++v)
+    {
+        if (offsets[v + 1] < offsets[v])
+        {
+            throw DigraphException{"arc offsets out of order"};
+        }
+
+        for (int a = offsets[v]; a < offsets[v + 1]; ++a)
+        {
+            const HierarchyArc& arc = arcs[a];
+
+            if (arc.vertex < 0 || arc.vertex >= count || rank(arc.vertex) <= rank(v)
+                || !(arc.weight >= 0.0))
+            {
+                throw DigraphException{"hierarchy arc out of range"};
+            }
+
+            if (arc.middle < -1 || arc.middle >= count
+                || (arc.middle >= 0 && rank(arc.middle) >= rank(v)))
+            {
+                throw DigraphException{"shortcut middle out of range"};
+            }
+        }
+    }
+}
+
+
+inline void ContractionHierarchy::verifyShortcuts(
+    const SharedArray<int>& offsets, const SharedArray<HierarchyArc>& arcs,
+    bool forward) const
+{
+    int count = vertexCount();
+
+    for (int v = 0; v < count; ++v)
+    {
+        for (int a = offsets[v]; a < offsets[v + 1]; ++a)
+        {
+            const HierarchyArc& arc = arcs[a];
+
+            if (arc.middle < 0)
+            {
+                continue;
+            }
+
+            int fromIndex = forward ? v : arc.vertex;
+            int toIndex = forward ? arc.vertex : v;
+
+            if (arcBetween(fromIndex, arc.middle) == nullptr
+                || arcBetween(arc.middle, toIndex) == nullptr)
+            {
+                throw DigraphException{"shortcut half does not exist"};
+            }
+        }
+    }
+}
+
+
+
+inline ContractionHierarchy::Contractor::Contractor(int vertexCount)
+    : out_(vertexCount), in_(vertexCount),
+      contracted_(vertexCount, 0), inRound_(vertexCount, 0), stale_(vertexCount, 1),
+      priorities_(vertexCount, 0), contractedNeighbors_(vertexCount, 0),
+      levels_(vertexCount, 0)
+{
+}
+
+
+inline void ContractionHierarchy::Contractor::addEdge(int fromIndex, int toIndex, double weight)
+{
+    // A loop is never part of a shortest path, so it can be dropped.
+    if (fromIndex != toIndex)
+    {
+        addOrImprove(out_[fromIndex], toIndex, -1, weight);
+        addOrImprove(in_[toIndex], fromIndex, -1, weight);
+    }
+}
+
+
+inline ContractionHierarchy ContractionHierarchy::Contractor::contract(int threadCount)
+{
+    int count = static_cast<int>(out_.size());
+
+    std::vector<int> remaining(count);
+    std::vector<int> ranks(count);
+    int nextRank = 0;
+
+    for (int v = 0; v < count; ++v)
+    {
+        remaining[v] = v;
+    }
+
+    std::vector<SearchWorkspace> workspaces(threadCount);
+    std::vector<std::vector<Shortcut>> scratch(threadCount);
+
+    while (!remaining.empty())
+    {
+        // Only the vertices whose neighborhoods have changed since their
+        // priorities were last computed need them computed again.
+
+        std::vector<int> stale;
+
+        for (int v : remaining)
+        {
+            if (stale_[v])
+            {
+                stale.push_back(v);
+            }
+        }
+
+        parallelFor(
+            static_cast<int>(stale.size()), threadCount,
+            [&](int thread, int i)
+            {
+                priorities_[stale[i]] = priority(workspaces[thread], stale[i], scratch[thread]);
+                stale_[stale[i]] = 0;
+            });
+
+        std::vector<int> round;
+
+        for (int v : remaining)
+        {
+            if (isLocalMinimum(v))
+            {
+                round.push_back(v);
+                inRound_[v] = 1;
+            }
+        }
+
+        // The round's vertices are ranked in the order they're contracted
+        // in, as far as their witness searches are concerned.
+        std::sort(
+            round.begin(), round.end(),
+            [&](int v, int w)
+            {
+                return comesBefore(v, w);
+            });
+
+        std::vector<std::vector<Shortcut>> shortcuts(round.size());
+
+        parallelFor(
+            static_cast<int>(round.size()), threadCount,
+            [&](int thread, int i)
+            {
+                findShortcuts(workspaces[thread], round[i], contractionSettleLimit, shortcuts[i]);
+            });
+
+        // No two vertices in the round are neighbors, so removing them one
+        // at a time never changes the arcs of another one.
+
+        for (unsigned int i = 0; i < round.size(); ++i)
+        {
+            int v = round[i];
+
+            ranks[v] = nextRank++;
+            contracted_[v] = 1;
+            inRound_[v] = 0;
+
+            for (const HierarchyArc& arc : out_[v])
+            {
+                removeArc(in_[arc.vertex], v);
+                ++contractedNeighbors_[arc.vertex];
+                levels_[arc.vertex] = std::max(levels_[arc.vertex], levels_[v] + 1);
+                stale_[arc.vertex] = 1;
+            }
+
+            for (const HierarchyArc& arc : in_[v])
+            {
+                removeArc(out_[arc.vertex], v);
+                ++contractedNeighbors_[arc.vertex];
+                levels_[arc.vertex] = std::max(levels_[arc.vertex], levels_[v] + 1);
+                stale_[arc.vertex] = 1;
+            }
+
+            for (const Shortcut& shortcut : shortcuts[i])
+            {
+                addOrImprove(out_[shortcut.fromIndex], shortcut.toIndex, shortcut.middle, shortcut.weight);
+                addOrImprove(in_[shortcut.toIndex], shortcut.fromIndex, shortcut.middle, shortcut.weight);
+            }
+        }
+
+        remaining.erase(
+            std::remove_if(
+                remaining.begin(), remaining.end(),
+                [&](int v)
+                {
+                    return contracted_[v] != 0;
+                }),
+            remaining.end());
+    }
+
+    std::vector<int> forwardOffsets{0};
+    std::vector<HierarchyArc> forwardArcs;
+    std::vector<int> backwardOffsets{0};
+    std::vector<HierarchyArc> backwardArcs;
+
+    for (int v = 0; v < count; ++v)
+    {
+        forwardArcs.insert(forwardArcs.end(), out_[v].begin(), out_[v].end());
+        forwardOffsets.push_back(static_cast<int>(forwardArcs.size()));
+
+        backwardArcs.insert(backwardArcs.end(), in_[v].begin(), in_[v].end());
+        backwardOffsets.push_back(static_cast<int>(backwardArcs.size()));
+    }
+
+    return ContractionHierarchy{
+        std::move(ranks),
+        std::move(forwardOffsets), std::move(forwardArcs),
+        std::move(backwardOffsets), std::move(backwardArcs)};
+}
+
+
+inline void ContractionHierarchy::Contractor::runWitnessSearch(
+    SearchWorkspace& workspace, int source, int avoid, int targetCount,
+    double limit, int settleLimit) const
+{
+    IndexedDaryHeap<4>& heap = workspace.heap();
+
+    workspace.reset(static_cast<int>(out_.size()));
+    workspace.setEntry(source, 0.0, -1);
+    heap.push(source, 0.0);
+
+    int settled = 0;
+
+    while (!heap.empty() && heap.topKey() <= limit && settled < settleLimit)
+    {
+        double base = heap.topKey();
+        int v = heap.pop();
+        ++settled;
+
+        if (v != source && isTarget(v, avoid) && --targetCount == 0)
+        {
+            break;
+        }
+
+        for (const HierarchyArc& arc : out_[v])
+        {
+            int w = arc.vertex;
+
+            if (w == avoid || (inRound_[w] && comesBefore(w, avoid)))
+            {
+                continue;
+            }
+
+            double candidate = base + arc.weight;
+
+            if (candidate < workspace.distance(w))
+            {
+                workspace.setEntry(w, candidate, v);
+                heap.pushOrDecrease(w, candidate);
+            }
+        }
+    }
+}
+
+
+inline void ContractionHierarchy::Contractor::findShortcuts(
+    SearchWorkspace& workspace, int v, int settleLimit,
+    std::vector<Shortcut>& shortcuts) const
+{
+    double longestOut = 0.0;
+
+    for (const HierarchyArc& arc : out_[v])
+    {
+        longestOut = std::max(longestOut, arc.weight);
+    }
+
+    for (const HierarchyArc& in : in_[v])
+    {
+        int targetCount = static_cast<int>(out_[v].size()) - (isTarget(in.vertex, v) ? 1 : 0);
+
+        if (targetCount == 0)
+        {
+            continue;
+        }
+
+        runWitnessSearch(workspace, in.vertex, v, targetCount, in.weight + longestOut, settleLimit);
+
+        // A tentative distance is the length of a real path, so even an
+        // unsettled vertex can be a witness.
+
+        for (const HierarchyArc& out : out_[v])
+        {
+            double through = in.weight + out.weight;
+
+            if (out.vertex != in.vertex && workspace.distance(out.vertex) > through)
+            {
+                shortcuts.push_back(Shortcut{in.vertex, out.vertex, v, through});
+            }
+        }
+    }
+}
+
+
+inline int ContractionHierarchy::Contractor::priority(
+    SearchWorkspace& workspace, int v, std::vector<Shortcut>& scratch) const
+{
+    scratch.clear();
+    findShortcuts(workspace, v, simulationSettleLimit, scratch);
+
+    int removed = static_cast<int>(out_[v].size() + in_[v].size());
+    int edgeDifference = static_cast<int>(scratch.size()) - removed;
+
+    return 3 * edgeDifference + contractedNeighbors_[v] + levels_[v];
+}
+
+
+inline bool ContractionHierarchy::Contractor::isTarget(int w, int v) const
+{
+    for (const HierarchyArc& arc : in_[w])
+    {
+        if (arc.vertex == v)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+inline bool ContractionHierarchy::Contractor::comesBefore(int v, int w) const
+{
+    return priorities_[v] < priorities_[w]
+        || (priorities_[v] == priorities_[w] && v < w);
+}
+
+
+inline bool ContractionHierarchy::Contractor::isLocalMinimum(int v) const
+{
+    for (const HierarchyArc& arc : out_[v])
+    {
+        if (comesBefore(arc.vertex, v))
+        {
+            return false;
+        }
+    }
+
+    for (const HierarchyArc& arc : in_[v])
+    {
+        if (comesBefore(arc.vertex, v))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+inline void ContractionHierarchy::Contractor::addOrImprove(
+    std::vector<HierarchyArc>& arcs, int vertex, int middle, double weight)
+{
+    for (HierarchyArc& arc : arcs)
+    {
+        if (arc.vertex == vertex)
+        {
+            if (weight < arc.weight)
+            {
+                arc.middle = middle;
+                arc.weight = weight;
+            }
+
+            return;
+        }
+    }
+
+    arcs.push_back(HierarchyArc{vertex, middle, weight});
+}
+
+
+inline void ContractionHierarchy::Contractor::removeArc(std::vector<HierarchyArc>& arcs, int vertex)
+{
+    for (unsigned int i = 0; i < arcs.size(); ++i)
+    {
+        if (arcs[i].vertex == vertex)
+        {
+            arcs[i] = arcs.back();
+            arcs.pop_back();
+            return;
+        }
+    }
+}
+
+
+template <typename Work>
+void ContractionHierarchy::Contractor::parallelFor(int count, int threadCount, Work work)
+{
+    // The work is handed out in small batches from a shared counter, since
+    // some vertices take far longer to simulate than others.
+    const int batchSize = 64;
+
+    std::atomic<int> next{0};
+
+    auto run =
+        [&](int thread)
+        {
+            for (int begin = next.fetch_add(batchSize); begin < count;
+                 begin = next.fetch_add(batchSize))
+            {
+                for (int i = begin; i < std::min(count, begin + batchSize); ++i)
+                {
+                    work(thread, i);
+                }
+            }
+        };
+
+    int workerCount = std::min(threadCount, (count + batchSize - 1) / batchSize);
+    std::vector<std::thread> threads;
+
+    for (int t = 1; t < workerCount; ++t)
+    {
+        threads.emplace_back(run, t);
+    }
+
+    run(0);
+
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+}
+
+
+
+inline ContractionHierarchyQuery::ContractionHierarchyQuery()
+    : forward_{&ownForward_}, backward_{&ownBackward_},
+      settledCount_{0}, bestDistance_{std::numeric_limits<double>::infinity()},
+      meetingIndex_{-1}
+{
+}
+
+
+inline ContractionHierarchyQuery::ContractionHierarchyQuery(
+    SearchWorkspace& forward, SearchWorkspace& backward)
+    : forward_{&forward}, backward_{&backward},
+      settledCount_{0}, bestDistance_{std::numeric_limits<double>::infinity()},
+      meetingIndex_{-1}
+{
+}
+
+
+inline void ContractionHierarchyQuery::run(
+    const ContractionHierarchy& hierarchy, int startIndex, int targetIndex)
+{
+    SearchWorkspace& forward = *forward_;
+    SearchWorkspace& backward = *backward_;
+
+    forward.reset(hierarchy.vertexCount());
+    backward.reset(hierarchy.vertexCount());
+
+    settledCount_ = 0;
+    bestDistance_ = std::numeric_limits<double>::infinity();
+    meetingIndex_ = -1;
+
+    forward.setEntry(startIndex, 0.0, -1);
+    forward.heap().push(startIndex, 0.0);
+    backward.setEntry(targetIndex, 0.0, -1);
+    backward.heap().push(targetIndex, 0.0);
+
+    // Unlike a BidirectionalSearch, neither direction can stop when the
+    // two meet, since the top of the path may be far above where they
+    // first do; each runs until nothing in its heap could improve on the
+    // best path.
+
+    while (true)
+    {
+        IndexedDaryHeap<4>& forwardHeap = forward.heap();
+        IndexedDaryHeap<4>& backwardHeap = backward.heap();
+
+        bool forwardLive = !forwardHeap.empty() && forwardHeap.topKey() < bestDistance_;
+        bool backwardLive = !backwardHeap.empty() && backwardHeap.topKey() < bestDistance_;
+
+        if (forwardLive && (!backwardLive || forwardHeap.topKey() <= backwardHeap.topKey()))
+        {
+            settleNext(hierarchy, true, forward, backward);
+        }
+        else if (backwardLive)
+        {
+            settleNext(hierarchy, false, backward, forward);
+        }
+        else
+        {
+            break;
+        }
+    }
+}
+
+
+inline int ContractionHierarchyQuery::settledCount() const
+{
+    return settledCount_;
+}
+
+
+inline bool ContractionHierarchyQuery::reached() const
+{
+    return meetingIndex_ >= 0;
+}
+
+
+inline double ContractionHierarchyQuery::distance() const
+{
+    return bestDistance_;
+}
+
+
+template <typename EdgeInfo, typename Graph>
+ShortestPath<EdgeInfo> ContractionHierarchyQuery::path(
+    const ContractionHierarchy& hierarchy, const Graph& graph) const
+{
+    ShortestPath<EdgeInfo> path{{}, {}, bestDistance_};
+
+    if (!reached())
+    {
+        return path;
+    }
+
+    // The forward half climbs from the start to the meeting vertex and
+    // the backward half descends from it to the target; each of their
+    // arcs is unpacked into the original edges it stands for.
+
+    std::vector<int> climb;
+
+    for (int v = meetingIndex_; v >= 0; v = forward_->predecessor(v))
+    {
+        climb.push_back(v);
+    }
+
+    std::reverse(climb.begin(), climb.end());
+
+    std::vector<int> indexes{climb.front()};
+
+    for (unsigned int i = 1; i < climb.size(); ++i)
+    {
+        hierarchy.unpack(climb[i - 1], climb[i], indexes);
+    }
+
+    for (int v = meetingIndex_, next = backward_->predecessor(v); next >= 0;
+         v = next, next = backward_->predecessor(v))
+    {
+        hierarchy.unpack(v, next, indexes);
+    }
+
+    for (unsigned int i = 0; i < indexes.size(); ++i)
+    {
+        path.vertices.push_back(graph.toVertexNumber(indexes[i]));
+
+        if (i > 0)
+        {
+            graph.forEachOutEdge(
+                indexes[i - 1],
+                [&](int w, const EdgeInfo& einfo)
+                {
+                    if (w == indexes[i])
+                    {
+                        path.edges.push_back(einfo);
+                    }
+                });
+        }
+    }
+
+    return path;
+}
+
+
+inline void ContractionHierarchyQuery::settleNext(
+    const ContractionHierarchy& hierarchy, bool forward,
+    SearchWorkspace& mine, SearchWorkspace& other)
+{
+    IndexedDaryHeap<4>& heap = mine.heap();
+
+    double base = heap.topKey();
+    int v = heap.pop();
+    ++settledCount_;
+
+    double total = base + other.distance(v);
+
+    if (total < bestDistance_)
+    {
+        bestDistance_ = total;
+        meetingIndex_ = v;
+    }
+
+    // If the search has reached a higher vertex from which an arc leads
+    // down to this one more cheaply, this vertex's distance isn't its true
+    // one, so nothing reached through it can be on the shortest path and
+    // its arcs needn't be relaxed ("stall-on-demand").
+
+    for (const HierarchyArc& arc : forward ? hierarchy.backwardArcs(v) : hierarchy.forwardArcs(v))
+    {
+        if (mine.distance(arc.vertex) + arc.weight < base)
+        {
+            return;
+        }
+    }
+
+    for (const HierarchyArc& arc : forward ? hierarchy.forwardArcs(v) : hierarchy.backwardArcs(v))
+    {
+        double candidate = base + arc.weight;
+
+        if (candidate < mine.distance(arc.vertex))
+        {
+            mine.setEntry(arc.vertex, candidate, v);
+            heap.pushOrDecrease(arc.vertex, candidate);
+        }
+    }
+}
+
+
+
+#endif // CONTRACTIONHIERARCHY_HPP
+
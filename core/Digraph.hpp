@@ -5,12 +5,14 @@
 //
 // This header file declares a class template called Digraph, which is
 // intended to implement a generic directed graph.  The implementation
-// uses the adjacency lists technique, so each vertex stores a linked
-// list of its outgoing edges.
+// uses the adjacency lists technique, so each vertex stores a list of
+// its outgoing edges.
 //
-// Along with the Digraph class template is a class DigraphException
-// and a couple of utility structs that aren't generally useful outside
-// of this header file.
+// Along with the Digraph class template are a couple of utility structs
+// that aren't generally useful outside of this header file, and the views
+// that let callers walk its edges without copying them.  The
+// DigraphException class that its member functions throw is declared in
+// DigraphException.hpp.
 //
 // In general, directed graphs are all the same, except in the sense
 // that they store different kinds of information about each vertex and
@@ -20,76 +22,198 @@
 #ifndef DIGRAPH_HPP
 #define DIGRAPH_HPP
 
+#include <algorithm>
 #include <functional>
-#include <list>
+#include <memory>
 #include <map>
+#include <string>
+#include <tuple>
+#include <type_traits>
 #include <utility>
 #include <vector>
-#include <iostream>
-#include <set>
-#include <queue>
-#include "TripReader.hpp"
-#include "RoadSegment.hpp"
-// DigraphExceptions are thrown from some of the member functions in the
-// Digraph class template, so that exception is declared here, so it
-// will be available to any code that includes this header file.
+#include "CompactDigraph.hpp"
+#include "DigraphException.hpp"
+#include "FlatHashMap.hpp"
+#include "ShortestPathSearch.hpp"
+#include "SmallVector.hpp"
+#include "StrongComponents.hpp"
 
-class DigraphException
-{
-public:
-    DigraphException(const std::string& reason): reason_{reason} { }
 
-    std::string reason() const { return reason_; }
 
-private:
-    std::string reason_;
-};
+// ReboundAllocator is the allocator that a Digraph with the given Allocator
+// uses for objects of type T.  Every allocation a Digraph makes goes
+// through its Allocator this way, whatever the Allocator's value_type.
+
+template <typename Allocator, typename T>
+using ReboundAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<T>;
 
 
 
 // A DigraphEdge lists a "from vertex" (the number of the vertex from which
 // the edge points), a "to vertex" (the number of the vertex to which the
-// edge points), and an EdgeInfo object.  Because different kinds of Digraphs
-// store different kinds of edge information, DigraphEdge is a template
-// struct.
+// edge points), and an EdgeInfo object.  It also caches the index of the
+// "to vertex" (see Digraph below), so that traversals never have to look
+// up a vertex number.  Because different kinds of Digraphs store different
+// kinds of edge information, DigraphEdge is a template struct.
 
 template <typename EdgeInfo>
 struct DigraphEdge
 {
     int fromVertex;
     int toVertex;
+    int toIndex;
     EdgeInfo einfo;
 };
 
 
 
-// A DigraphVertex includes two things: a VertexInfo object and a list of
-// its outgoing edges.  Because different kinds of Digraphs store different
-// kinds of vertex and edge information, DigraphVertex is a template struct.
+// A DigraphEdgeList is the list of a vertex's outgoing edges.  Road map
+// intersections rarely have more than four, so that many are stored inline
+// in the DigraphVertex, and only vertices with more edges than that
+// allocate any memory for them (see SmallVector.hpp).
+
+template <typename EdgeInfo, typename Allocator = std::allocator<char>>
+using DigraphEdgeList =
+    SmallVector<DigraphEdge<EdgeInfo>, 4, ReboundAllocator<Allocator, DigraphEdge<EdgeInfo>>>;
+
+
 
-template <typename VertexInfo, typename EdgeInfo>
+// A DigraphVertex includes a VertexInfo object, a list of its outgoing
+// edges and, when its Digraph maintains an incoming edge index (see
+// indexIncomingEdges() below), the indexes of the vertices with edges
+// pointing to it, in no particular order.  Because different kinds of
+// Digraphs store different kinds of vertex and edge information,
+// DigraphVertex is a template struct.
+
+template <typename VertexInfo, typename EdgeInfo, typename Allocator = std::allocator<char>>
 struct DigraphVertex
 {
     VertexInfo vinfo;
-    std::list<DigraphEdge<EdgeInfo>> edges;
+    DigraphEdgeList<EdgeInfo, Allocator> edges;
+    std::vector<int, ReboundAllocator<Allocator, int>> predecessors;
+};
+
+
+
+// A DigraphEdgeRange is a read-only view of the outgoing edges of one vertex
+// in a Digraph, as returned by outEdges().  It refers to the edges where
+// they're stored, rather than copying them, so it's only valid until the
+// Digraph is next changed.
+
+template <typename EdgeInfo>
+class DigraphEdgeRange
+{
+public:
+    using iterator = const DigraphEdge<EdgeInfo>*;
+
+public:
+    DigraphEdgeRange(iterator begin, iterator end);
+
+    iterator begin() const;
+    iterator end() const;
+    int size() const;
+    bool empty() const;
+
+private:
+    iterator begin_;
+    iterator end_;
+};
+
+
+
+// A DigraphAllEdges is a read-only view of every edge in a Digraph, as
+// returned by allEdges(), listing them in the same order as edges().  Like
+// a DigraphEdgeRange, it refers to the edges where they're stored, and is
+// only valid until the Digraph is next changed.
+
+template <typename VertexInfo, typename EdgeInfo, typename Allocator>
+class DigraphAllEdges
+{
+public:
+    // An iterator walks the edges of one vertex after another, skipping
+    // the vertices that have none.
+    class iterator
+    {
+    public:
+        iterator(
+            const DigraphVertex<VertexInfo, EdgeInfo, Allocator>* vertex,
+            const DigraphVertex<VertexInfo, EdgeInfo, Allocator>* lastVertex);
+
+        const DigraphEdge<EdgeInfo>& operator*() const;
+        const DigraphEdge<EdgeInfo>* operator->() const;
+        iterator& operator++();
+        bool operator==(const iterator& i) const;
+        bool operator!=(const iterator& i) const;
+
+    private:
+        void skipEmptyVertices();
+
+    private:
+        const DigraphVertex<VertexInfo, EdgeInfo, Allocator>* vertex_;
+        const DigraphVertex<VertexInfo, EdgeInfo, Allocator>* lastVertex_;
+        const DigraphEdge<EdgeInfo>* edge_;
+    };
+
+public:
+    DigraphAllEdges(
+        const DigraphVertex<VertexInfo, EdgeInfo, Allocator>* firstVertex,
+        const DigraphVertex<VertexInfo, EdgeInfo, Allocator>* lastVertex,
+        int edgeCount);
+
+    iterator begin() const;
+    iterator end() const;
+    int size() const;
+    bool empty() const;
+
+private:
+    const DigraphVertex<VertexInfo, EdgeInfo, Allocator>* firstVertex_;
+    const DigraphVertex<VertexInfo, EdgeInfo, Allocator>* lastVertex_;
+    int edgeCount_;
 };
 
 
 
 // Digraph is a class template that represents a directed graph implemented
-// using adjacency lists.  It takes two type parameters:
+// using adjacency lists.  It takes three type parameters:
 //
 // * VertexInfo, which specifies the kind of object stored for each vertex
 // * EdgeInfo, which specifies the kind of object stored for each edge
+// * Allocator, which specifies how the Digraph allocates memory, and
+//   defaults to std::allocator
 //
-// You'll need to implement the member functions declared here; each has a
-// comment detailing how it is intended to work.
+// Every array a Digraph keeps (its vertices, each vertex's spilled edges
+// and predecessors, and its index table) is allocated by its Allocator,
+// rebound to the right type.  Giving it an ArenaAllocator (see
+// MonotonicArena.hpp) builds the whole graph in one arena, so that
+// throwing it away costs almost nothing beyond destroying its vertex and
+// edge information, and the arena's memory can be released all at once;
+// a PoolAllocator (see NodePool.hpp) recycles the small arrays of a graph
+// that keeps changing.  An allocator's value_type doesn't matter, so an
+// ArenaAllocator<char>, say, is as good as any.
 //
 // Each vertex in a Digraph is identified uniquely by a "vertex number".
 // Vertex numbers are not necessarily sequential and they are not necessarily
 // zero- or one-based.
-
-template <typename VertexInfo, typename EdgeInfo>
+//
+// Internally, each vertex number is translated once, through a flat,
+// open-addressing hash table (see FlatHashMap.hpp), into a dense "index"
+// between 0 and vertexCount() - 1, and everything else (vertex storage,
+// edge targets, and the bookkeeping arrays used by the algorithms) is a
+// plain array indexed by it.  Removing a vertex moves the vertex with the
+// highest index into the hole it leaves, so the indexes of the remaining
+// vertices stay dense but aren't stable across removals.  Adding and
+// removing vertices takes constant time apart from the edges involved,
+// and vertices() lists them in index order, which is insertion order until
+// the first removal, and deterministic either way.
+//
+// Only outgoing edges are stored unless indexIncomingEdges() is called, at
+// which point each vertex also keeps track of its predecessors from then
+// on.  That makes removing a vertex cost time proportional to the edges
+// around it rather than to the size of the whole graph, and it makes
+// incoming edges as cheap to visit as outgoing ones, at the cost of one
+// more int per edge and a little more work when edges are added.
+
+template <typename VertexInfo, typename EdgeInfo, typename Allocator = std::allocator<char>>
 class Digraph
 {
 public:
@@ -97,12 +221,22 @@ public:
     // contains no vertices and no edges.
     Digraph();
 
+    // This constructor initializes a new, empty Digraph that allocates
+    // all of its memory with the given allocator.
+    explicit Digraph(const Allocator& allocator);
+
     // The copy constructor initializes a new Digraph to be a deep copy
     // of another one (i.e., any change to the copy will not affect the
     // original).
     Digraph(const Digraph& d);
 
-    // The destructor deallocates any memory associated with the Digraph.
+    // The move constructor initializes a new Digraph by taking the
+    // contents of another one, without copying any of its vertices or
+    // edges, and leaves the other one empty.
+    Digraph(Digraph&& d) noexcept;
+
+    // The destructor deallocates any memory associated with the Digraph,
+    // by way of its Allocator.
     ~Digraph();
 
     // The assignment operator assigns the contents of the given Digraph
@@ -111,8 +245,13 @@ public:
     // "this" Digraph afterward will not affect the other).
     Digraph& operator=(const Digraph& d);
 
+    // The move assignment operator replaces the contents of "this"
+    // Digraph by taking the contents of the given one, without copying
+    // any of its vertices or edges, and leaves the other one empty.
+    Digraph& operator=(Digraph&& d) noexcept;
+
     // vertices() returns a std::vector containing the vertex numbers of
-    // every vertex in this Digraph.
+    // every vertex in this Digraph, in index order.
     std::vector<int> vertices() const;
 
     // edges() returns a std::vector of std::pairs, in which each pair
@@ -120,6 +259,12 @@ public:
     // Digraph.  All edges are included in the std::vector.
     std::vector<std::pair<int, int>> edges() const;
 
+    // allEdges() returns a view of every edge in this Digraph, in the same
+    // order as edges(), without copying anything; each one is a
+    // DigraphEdge, with its "from" and "to" vertex numbers and its
+    // EdgeInfo.  The view is valid until the Digraph is next changed.
+    DigraphAllEdges<VertexInfo, EdgeInfo, Allocator> allEdges() const;
+
     // This overload of edges() returns a std::vector of std::pairs, in
     // which each pair contains the "from" and "to" vertex numbers of an
     // edge in this Digraph.  Only edges outgoing from the given vertex
@@ -127,18 +272,23 @@ public:
     // not exist, a DigraphException is thrown instead.
     std::vector<std::pair<int, int>> edges(int vertex) const;
 
+    // outEdges() returns a view of the edges outgoing from the given
+    // vertex number, in the same order as edges(vertex), without copying
+    // anything.  The view is valid until the Digraph is next changed.  If
+    // the vertex does not exist, a DigraphException is thrown instead.
+    DigraphEdgeRange<EdgeInfo> outEdges(int vertex) const;
+
     // vertexInfo() returns the VertexInfo object belonging to the vertex
-    // with the given vertex number.  If that vertex does not exist, a
-    // DigraphException is thrown instead.
-    //typename DigraphVertex<VertexInfo, EdgeInfo>::
-    VertexInfo vertexInfo(int vertex) const;
+    // with the given vertex number, by reference rather than as a copy;
+    // the reference is valid until the Digraph is next changed.  If that
+    // vertex does not exist, a DigraphException is thrown instead.
+    const VertexInfo& vertexInfo(int vertex) const;
 
     // edgeInfo() returns the EdgeInfo object belonging to the edge
-    // with the given "from" and "to" vertex numbers.  If either of those
-    // vertices does not exist *or* if the edge does not exist, a
-    // DigraphException is thrown instead.
-    //typename DigraphEdge<EdgeInfo>::
-    EdgeInfo edgeInfo(int fromVertex, int toVertex) const;
+    // with the given "from" and "to" vertex numbers, by reference, like
+    // vertexInfo().  If either of those vertices does not exist *or* if
+    // the edge does not exist, a DigraphException is thrown instead.
+    const EdgeInfo& edgeInfo(int fromVertex, int toVertex) const;
 
     // addVertex() adds a vertex to the Digraph with the given vertex
     // number and VertexInfo object.  If there is already a vertex in
@@ -146,6 +296,16 @@ public:
     // thrown instead.
     void addVertex(int vertex, const VertexInfo& vinfo);
 
+    // This overload of addVertex() moves the given VertexInfo object into
+    // the Digraph instead of copying it.
+    void addVertex(int vertex, VertexInfo&& vinfo);
+
+    // emplaceVertex() is like addVertex(), except that the new vertex's
+    // VertexInfo object is constructed in place from the given arguments,
+    // as if by VertexInfo(args...).
+    template <typename... Args>
+    void emplaceVertex(int vertex, Args&&... args);
+
     // addEdge() adds an edge to the Digraph pointing from the given
     // "from" vertex number to the given "to" vertex number, and
     // associates with the given EdgeInfo object with it.  If one
@@ -153,10 +313,51 @@ public:
     // present in the graph, a DigraphException is thrown instead.
     void addEdge(int fromVertex, int toVertex, const EdgeInfo& einfo);
 
+    // This overload of addEdge() moves the given EdgeInfo object into the
+    // Digraph instead of copying it.
+    void addEdge(int fromVertex, int toVertex, EdgeInfo&& einfo);
+
+    // emplaceEdge() is like addEdge(), except that the new edge's EdgeInfo
+    // object is constructed in place from the given arguments, as if by
+    // EdgeInfo(args...).
+    template <typename... Args>
+    void emplaceEdge(int fromVertex, int toVertex, Args&&... args);
+
+    // reserve() makes room for the given total number of vertices, so
+    // that adding them one at a time or in bulk doesn't have to grow the
+    // Digraph's vertex storage (or rehash its index table) along the way.
+    void reserve(int vertexCount);
+
+    // addVertices() adds every vertex in the given range, each element of
+    // which is a std::pair (or std::tuple) of a vertex number and its
+    // VertexInfo.  The vertex numbers are sorted and checked once, up
+    // front, rather than one at a time.  If any of them already exists
+    // in the Digraph or appears more than once in the range, a single
+    // DigraphException listing all of them is thrown, and no vertices are
+    // added at all; likewise, if constructing any VertexInfo throws, the
+    // vertices added before it are removed again.  When the range is an
+    // rvalue, each VertexInfo is moved out of it rather than copied, so a
+    // failed batch may leave some of them moved from.
+    template <typename VertexRange>
+    void addVertices(VertexRange&& vertices);
+
+    // addEdges() adds every edge in the given range, each element of
+    // which is a std::tuple of a "from" vertex number, a "to" vertex
+    // number and an EdgeInfo, in the order they appear.  If any of them
+    // refers to a vertex that doesn't exist, a single DigraphException
+    // listing all such vertices is thrown; otherwise, if any edge already
+    // exists in the Digraph or appears more than once in the range, a
+    // single DigraphException listing all of them is thrown.  Either way,
+    // no edges are added at all.  When the range is an rvalue, each
+    // EdgeInfo is moved out of it rather than copied.
+    template <typename EdgeRange>
+    void addEdges(EdgeRange&& edges);
+
     // removeVertex() removes the vertex (and all of its incoming
     // and outgoing edges) with the given vertex number from the
     // Digraph.  If the vertex does not exist already, a DigraphException
-    // is thrown instead.
+    // is thrown instead.  Without an incoming edge index, finding the
+    // incoming edges means scanning every edge in the graph.
     void removeVertex(int vertex);
 
     // removeEdge() removes the edge pointing from the given "from"
@@ -166,6 +367,24 @@ public:
     // thrown instead.
     void removeEdge(int fromVertex, int toVertex);
 
+    // indexIncomingEdges() builds an index of every vertex's incoming
+    // edges, in time proportional to the number of edges, and keeps it
+    // up to date through every later change to the Digraph (including
+    // copies of it).  Calling it again has no effect.
+    void indexIncomingEdges();
+
+    // incomingEdgesIndexed() returns true if indexIncomingEdges() has
+    // been called on this Digraph.
+    bool incomingEdgesIndexed() const;
+
+    // incomingEdges() returns a std::vector of std::pairs, in which each
+    // pair contains the "from" and "to" vertex numbers of an edge pointing
+    // to the given vertex number, in no particular order.  If the vertex
+    // does not exist, a DigraphException is thrown instead.  This takes
+    // time proportional to the number of those edges when they're indexed,
+    // or to the number of edges in the graph when they're not.
+    std::vector<std::pair<int, int>> incomingEdges(int vertex) const;
+
     // vertexCount() returns the number of vertices in the graph.
     int vertexCount() const;
 
@@ -184,6 +403,12 @@ public:
     // false otherwise.
     bool isStronglyConnected() const;
 
+    // strongComponents() divides the Digraph into its strongly connected
+    // components, in time proportional to the number of vertices plus
+    // the number of edges (see StrongComponents.hpp).  The component of
+    // each vertex is listed by its dense index (see toIndex()).
+    StrongComponents strongComponents() const;
+
     // findShortestPaths() takes a start vertex number and a function
     // that takes an EdgeInfo object and determines an edge weight.
     // It uses Dijkstra's Shortest Path Algorithm to determine the
@@ -196,683 +421,1178 @@ public:
     // the value is simply a copy of the key.
     std::map<int, int> findShortestPaths(
         int startVertex,
-        std::function<double(const EdgeInfo&)> edgeWeightFunc) const
-    {
-        std::map<int, bool> visited; //visited kv
-    std::map<int, double> best; // dv best option so far
-    std::map<int,int> pv; //predecessors 
-    std::cout<<startVertex<<std::endl;
-    //EdgeInfo ed;
-    /*
-    for(auto& e: di_map.at(startVertex).edges)
-    {
-        std::cout<<edgeWeightFunc(e.einfo)<<std::endl;
-
-    }
-    //EdgeInfo _ed=di_map.at(startVertex).edges;
-
-    //vertxx=rmap.vertices();
-    */
-    std::priority_queue<std::pair<int, double>, std::vector<std::pair<int, int>>, weight> pq;
-    for(auto v: keys)
-    {
-        //std::cout<<v<<std::endl;
-        visited.insert(std::make_pair(v, false));
-        best.insert(std::make_pair(v, 99999));
-        pv.insert(std::make_pair(v, NULL));
-
-        //kdv.push_back(std::make_pair(v, std::make_pair(9999, false)));
-        //pv.push_back(v, NULL);
-    }
-    pv[0]=0;
-    best[0]=0;
-    std::pair<int, double> option;
-    option.first=startVertex;
-    option.second=0;
-    pq.push(option);
-    std::vector<std::pair<int, int>> vertexEdges;
-    while(!pq.empty())
-    {
-        int v = pq.top().first;
-        pq.pop();
-        if(visited.at(v)==false)
-        {
-            //std::cout<<v<<std::endl;
-            visited.at(v)=true;
-            //std::cout<<visited.at(v)<<std::endl;
-            double weigh;
-            for(auto edge:di_map.at(v).edges)
-            {
-                weigh= edgeWeightFunc(edge.einfo);
-                //std::cout<<weigh<<std::endl;
-                    for(auto vx:keys)
-                    {
-                        if(edge.toVertex==vx && visited.at(vx)==false)
-                        {
-                            //std::cout<<vx<<std::endl;
-                            int new_loc=vx;
-                            //std::cout<<new_loc<<std::endl;
-                            if(best.at(new_loc)>weigh)
-                            {
-                                //std::cout<<new_loc<<std::endl;
-
-                                //std::cout<<best.at(new_loc);
-
-                                best.at(new_loc)=weigh;
-                                //std::cout<<best.at(new_loc);
-                                pv.at(new_loc)=v;
-                                //std::cout<<best.at(new_loc);
-                                //std::cout<<pv.at(new_loc);
-
-                                option.first=new_loc;
-                                //std::cout<<option.first<<std::endl;
-                                option.second=best.at(new_loc);
-                                pq.push(option);
-                            }
-                        }
-                    }
+        std::function<double(const EdgeInfo&)> edgeWeightFunc) const;
+
+    // This overload of findShortestPaths() takes the edge weight function
+    // as any callable object (such as a lambda or a function object)
+    // instead of a std::function, so the compiler can inline the weight
+    // computation into the search rather than making an indirect call for
+    // every edge.  The std::function overload remains for callers that
+    // need type erasure.
+    template <typename WeightFunc>
+    std::map<int, int> findShortestPaths(
+        int startVertex, WeightFunc&& edgeWeightFunc) const;
+
+    // findShortestPath() finds the shortest path from one start vertex
+    // number to one end vertex number, using the same kind of edge weight
+    // function as findShortestPaths().  Unlike findShortestPaths(), it
+    // stops searching as soon as the path to the end vertex is known,
+    // which is much sooner when the two are near each other.  The path's
+    // vertices, the EdgeInfo of each edge along it, and its total cost
+    // are returned; if the end vertex isn't reachable, the path is empty
+    // and its cost is infinity.  If either vertex does not exist, a
+    // DigraphException is thrown instead.
+    ShortestPath<EdgeInfo> findShortestPath(
+        int startVertex, int endVertex,
+        std::function<double(const EdgeInfo&)> edgeWeightFunc) const;
+
+    // This overload of findShortestPath() takes the edge weight function
+    // as any callable object, for the same reason as findShortestPaths().
+    template <typename WeightFunc>
+    ShortestPath<EdgeInfo> findShortestPath(
+        int startVertex, int endVertex, WeightFunc&& edgeWeightFunc) const;
+
+    // This overload of findShortestPath() searches in the given
+    // SearchWorkspace instead of allocating its own.  Callers that find
+    // many paths can keep one workspace for all of them, so that each
+    // search costs time proportional to the part of the graph it visits,
+    // rather than to the size of the whole graph.
+    template <typename WeightFunc>
+    ShortestPath<EdgeInfo> findShortestPath(
+        int startVertex, int endVertex, WeightFunc&& edgeWeightFunc,
+        SearchWorkspace& workspace) const;
+
+    // freeze() returns a read-only CompactDigraph containing the same
+    // vertices and edges as this Digraph, laid out contiguously so that
+    // traversals are cache-friendly.  The vertices are given indexes in
+    // the same order that vertices() returns them.  Later changes to
+    // this Digraph don't affect the CompactDigraph, and vice versa.
+    CompactDigraph<VertexInfo, EdgeInfo> freeze() const;
+
+    // toIndex() returns the dense index (between 0 and vertexCount() - 1)
+    // currently assigned to the given vertex number.  If the vertex does
+    // not exist, a DigraphException is thrown instead.
+    int toIndex(int vertex) const;
 
-            }
-        }
-    }
-    
-    return pv;
+    // toVertexNumber() returns the vertex number of the vertex with the
+    // given dense index.  If there is no such index, a DigraphException
+    // is thrown instead.
+    int toVertexNumber(int index) const;
 
-    }
-    struct weight
-    {
-    public:
-        bool operator()(std::pair<int, double> n1, std::pair<int, double> n2)
-        {
-            
-            return n1.second<n2.second;
-        }
+    // forEachOutEdge() calls visit(toIndex, einfo) for each edge outgoing
+    // from the vertex with the given dense index.  This is how the
+    // algorithms in ShortestPathSearch.hpp traverse a Digraph.
+    template <typename Visit>
+    void forEachOutEdge(int index, Visit&& visit) const;
+
+    // forEachInEdge() calls visit(fromIndex, einfo) for each edge pointing
+    // to the vertex with the given dense index, which is how a search
+    // runs backward over a Digraph.  It's only cheap when the incoming
+    // edges are indexed; otherwise, it scans every edge in the graph.
+    template <typename Visit>
+    void forEachInEdge(int index, Visit&& visit) const;
+
+private:
+    // describeAll() makes the reason for a DigraphException about the
+    // given items, such as "vertex already exists: 3" when there's one,
+    // or "vertices already exist: 3, 8" when there are several.  Only
+    // the first few items are listed.
+    static std::string describeAll(
+        const std::string& one, const std::string& many,
+        const std::vector<std::string>& items);
+
+    // findEdge() returns an iterator to the edge from the vertex with
+    // the given index to the vertex with the other given index, or the
+    // end of the first vertex's edge list if there is no such edge.
+    typename DigraphEdgeList<EdgeInfo, Allocator>::const_iterator findEdge(
+        int fromIndex, int targetIndex) const;
+
+    // newVertex() returns a vertex with no edges, whose VertexInfo is
+    // constructed from the given arguments, and which allocates with the
+    // Digraph's allocator.
+    template <typename... Args>
+    DigraphVertex<VertexInfo, EdgeInfo, Allocator> newVertex(Args&&... args) const;
+
+    // appendVertex() stores the given vertex at the next index, with the
+    // given vertex number, and only then enters it in the index table.  If
+    // storing it throws, the Digraph is left as it was, so a vertex number
+    // is never left indexing a slot that doesn't exist.
+    void appendVertex(int vertex, DigraphVertex<VertexInfo, EdgeInfo, Allocator>&& slot);
+
+    // forwardElement() returns the given part of an element of a range
+    // of the given type, as an rvalue if the range is one, so that it can
+    // be moved out of it.
+    template <typename Range, typename T>
+    static typename std::conditional<
+        std::is_lvalue_reference<Range>::value, T&, T&&>::type forwardElement(T& part);
+
+    // unlinkPredecessor() removes one index from the predecessors of the
+    // vertex with the given index, and relinkPredecessor() replaces one
+    // with another.  Both are used only while incoming edges are indexed.
+    void unlinkPredecessor(int targetIndex, int fromIndex);
+    void relinkPredecessor(int targetIndex, int oldFromIndex, int newFromIndex);
+
+    // removeIndexedVertex() and removeUnindexedVertex() remove every edge
+    // into or out of the vertex with the given index, and retarget the
+    // edges that point to the vertex with the last index to the given one,
+    // so that removeVertex() can then move the last vertex there.
+    void removeIndexedVertex(int index, int last);
+    void removeUnindexedVertex(int index, int last);
 
-    };
-/* 
-	struct EdgeInfo
-	{
-		EdgeInfo key;
-	};
-	struct VertexInfo
-	{
-		VertexInfo key;
-	};
-*/	
 private:
-    //DigraphVertex<VertexInfo,EdgeInfo> vertx;
-    //DigraphEdge<VertexInfo> edge;
-    //DigraphEdge
-
-    //std::list<int> vertx;
-    //std::Vector<Trip> trip;
-    std::vector<int> keys;
-    int num_vertex, num_edge;
-    //std::map<DigraphVertex<VertexInfo, EdgeInfo>, int> Di_map;
-    std::map<int, DigraphVertex<VertexInfo, EdgeInfo>> di_map;
-    //std::map<int, std::set<std::string>> map2;
-	//typename DigraphEdge<EdgeInfo>::EdgeInfo edge;
-	//typename DigraphVertex<VertexInfo, EdgeInfo>::VertexInfo vertex;
-
-    // Add whatever member variables you think you need here.  One
-    // possibility is a std::map where the keys are vertex numbers
-    // and the values are DigraphVertex<VertexInfo, EdgeInfo> objects.
-
-
-    // You can also feel free to add any additional member functions
-    // you'd like (public or private), so long as you don't remove or
-    // change the signatures of the ones that already exist.
+    std::vector<
+        DigraphVertex<VertexInfo, EdgeInfo, Allocator>,
+        ReboundAllocator<Allocator, DigraphVertex<VertexInfo, EdgeInfo, Allocator>>> vertexSlots_;
+
+    std::vector<int, ReboundAllocator<Allocator, int>> vertexNumbers_;
+    FlatHashMap<int, int, std::hash<int>, Allocator> indexes_;
+    int edgeTotal_;
+    bool incomingIndexed_;
 };
 
 
 
-// You'll need to define the member functions of your Digraph class
-// template here.
-template <typename VertexInfo, typename EdgeInfo>
-Digraph<VertexInfo, EdgeInfo>::Digraph()
+template <typename EdgeInfo>
+DigraphEdgeRange<EdgeInfo>::DigraphEdgeRange(iterator begin, iterator end)
+    : begin_{begin}, end_{end}
 {
-    num_vertex=0;
-    num_edge=0;
+}
+
+
+template <typename EdgeInfo>
+typename DigraphEdgeRange<EdgeInfo>::iterator DigraphEdgeRange<EdgeInfo>::begin() const
+{
+    return begin_;
+}
 
+
+template <typename EdgeInfo>
+typename DigraphEdgeRange<EdgeInfo>::iterator DigraphEdgeRange<EdgeInfo>::end() const
+{
+    return end_;
 }
 
 
-template <typename VertexInfo, typename EdgeInfo>
-Digraph<VertexInfo, EdgeInfo>::Digraph(const Digraph& d)
+template <typename EdgeInfo>
+int DigraphEdgeRange<EdgeInfo>::size() const
 {
-    di_map=d.di_map;
-    /*
-    Digraph D_map;
+    return static_cast<int>(end_ - begin_);
+}
+
 
-    for(auto& item: d)
+template <typename EdgeInfo>
+bool DigraphEdgeRange<EdgeInfo>::empty() const
+{
+    return begin_ == end_;
+}
+
+
+
+template <typename VertexInfo, typename EdgeInfo, typename Allocator>
+DigraphAllEdges<VertexInfo, EdgeInfo, Allocator>::iterator::iterator(
+    const DigraphVertex<VertexInfo, EdgeInfo, Allocator>* vertex,
+    const DigraphVertex<VertexInfo, EdgeInfo, Allocator>* lastVertex)
+    : vertex_{vertex}, lastVertex_{lastVertex}, edge_{nullptr}
+{
+    skipEmptyVertices();
+}
+
+
+template <typename VertexInfo, typename EdgeInfo, typename Allocator>
+const DigraphEdge<EdgeInfo>& DigraphAllEdges<VertexInfo, EdgeInfo, Allocator>::iterator::operator*() const
+{
+    return *edge_;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo, typename Allocator>
+const DigraphEdge<EdgeInfo>* DigraphAllEdges<VertexInfo, EdgeInfo, Allocator>::iterator::operator->() const
+{
+    return edge_;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo, typename Allocator>
+typename DigraphAllEdges<VertexInfo, EdgeInfo, Allocator>::iterator&
+DigraphAllEdges<VertexInfo, EdgeInfo, Allocator>::iterator::operator++()
+{
+    ++edge_;
+
+    if (edge_ == vertex_->edges.end())
     {
-        VertexInfo v;
-        EdgeInfo e;
-        D_map.make_pair(item.first, )
+        ++vertex_;
+        skipEmptyVertices();
     }
-    */
+
+    return *this;
+}
 
 
+template <typename VertexInfo, typename EdgeInfo, typename Allocator>
+bool DigraphAllEdges<VertexInfo, EdgeInfo, Allocator>::iterator::operator==(const iterator& i) const
+{
+    return vertex_ == i.vertex_ && edge_ == i.edge_;
 }
 
 
-template <typename VertexInfo, typename EdgeInfo>
-Digraph<VertexInfo, EdgeInfo>::~Digraph()
-{}
+template <typename VertexInfo, typename EdgeInfo, typename Allocator>
+bool DigraphAllEdges<VertexInfo, EdgeInfo, Allocator>::iterator::operator!=(const iterator& i) const
+{
+    return !(*this == i);
+}
 
-template <typename VertexInfo, typename EdgeInfo>
-Digraph<VertexInfo, EdgeInfo>& Digraph<VertexInfo, EdgeInfo>::operator=(const Digraph& d)
+
+template <typename VertexInfo, typename EdgeInfo, typename Allocator>
+void DigraphAllEdges<VertexInfo, EdgeInfo, Allocator>::iterator::skipEmptyVertices()
 {
-    return *this;
+    while (vertex_ != lastVertex_ && vertex_->edges.empty())
+    {
+        ++vertex_;
+    }
 
+    edge_ = vertex_ != lastVertex_ ? vertex_->edges.begin() : nullptr;
 }
 
 
-template <typename VertexInfo, typename EdgeInfo>
-std::vector<int> Digraph<VertexInfo, EdgeInfo>::vertices() const
+template <typename VertexInfo, typename EdgeInfo, typename Allocator>
+DigraphAllEdges<VertexInfo, EdgeInfo, Allocator>::DigraphAllEdges(
+    const DigraphVertex<VertexInfo, EdgeInfo, Allocator>* firstVertex,
+    const DigraphVertex<VertexInfo, EdgeInfo, Allocator>* lastVertex,
+    int edgeCount)
+    : firstVertex_{firstVertex}, lastVertex_{lastVertex}, edgeCount_{edgeCount}
 {
-    return keys;
 }
 
 
-template <typename VertexInfo, typename EdgeInfo>
-std::vector<std::pair<int,int>> Digraph<VertexInfo, EdgeInfo>::edges() const
+template <typename VertexInfo, typename EdgeInfo, typename Allocator>
+typename DigraphAllEdges<VertexInfo, EdgeInfo, Allocator>::iterator
+DigraphAllEdges<VertexInfo, EdgeInfo, Allocator>::begin() const
 {
-	std::vector<std::pair<int, int>> vect;
-	for (auto& vx : di_map)
-	{
-		for (auto& ex : vx.second.edges)
-		{
-			//std::cout<<"from: "<<ex.fromVertex<<" to vertex: "<<ex.toVertex<<std::endl;
-        	//std::cout<<"m: "<<ex.einfo.miles<<"  mph: "<<ex.einfo.milesPerHour<<std::endl;
-        	vect.push_back(std::make_pair(ex.fromVertex,ex.toVertex));
+    return iterator{firstVertex_, lastVertex_};
+}
 
-		}
-	}
-    return vect;
-    //std::vector<std::pair<int, int>> all_edge;
-    //for(auto& vertx:keys)
-    //{
-    /*
-	for (int i=0; i<keys.size();i++)
-	{
+
+template <typename VertexInfo, typename EdgeInfo, typename Allocator>
+typename DigraphAllEdges<VertexInfo, EdgeInfo, Allocator>::iterator
+DigraphAllEdges<VertexInfo, EdgeInfo, Allocator>::end() const
+{
+    return iterator{lastVertex_, lastVertex_};
+}
 
 
-        std::cout<<"vertex: "<<di_map[i].vinfo<<std::endl;
-        for (auto& edge : di_map[vertx].edges)
-        {
-            all_edge.push_back(std::make_pair(edge.fromVertex, edge.toVertex));
-        }
-    }
-    return all_edge;
-    */
-    
+template <typename VertexInfo, typename EdgeInfo, typename Allocator>
+int DigraphAllEdges<VertexInfo, EdgeInfo, Allocator>::size() const
+{
+    return edgeCount_;
 }
 
 
-template <typename VertexInfo, typename EdgeInfo>
-std::vector<std::pair<int, int>> Digraph<VertexInfo, EdgeInfo>::edges(int vertex) const
+template <typename VertexInfo, typename EdgeInfo, typename Allocator>
+bool DigraphAllEdges<VertexInfo, EdgeInfo, Allocator>::empty() const
 {
-	/*
-	for (auto& edge : di_map[fromVertex].edges)
+    return edgeCount_ == 0;
+}
+
+
+
+template <typename VertexInfo, typename EdgeInfo, typename Allocator>
+Digraph<VertexInfo, EdgeInfo, Allocator>::Digraph()
+    : Digraph{Allocator{}}
+{
+}
+
+
+template <typename VertexInfo, typename EdgeInfo, typename Allocator>
+Digraph<VertexInfo, EdgeInfo, Allocator>::Digraph(const Allocator& allocator)
+    : vertexSlots_(allocator), vertexNumbers_(allocator), indexes_{allocator},
+      edgeTotal_{0}, incomingIndexed_{false}
+{
+}
+
+
+template <typename VertexInfo, typename EdgeInfo, typename Allocator>
+Digraph<VertexInfo, EdgeInfo, Allocator>::Digraph(const Digraph& d)
+    : vertexSlots_{d.vertexSlots_},
+      vertexNumbers_{d.vertexNumbers_},
+      indexes_{d.indexes_},
+      edgeTotal_{d.edgeTotal_},
+      incomingIndexed_{d.incomingIndexed_}
+{
+}
+
+
+template <typename VertexInfo, typename EdgeInfo, typename Allocator>
+Digraph<VertexInfo, EdgeInfo, Allocator>::Digraph(Digraph&& d) noexcept
+    : vertexSlots_{std::move(d.vertexSlots_)},
+      vertexNumbers_{std::move(d.vertexNumbers_)},
+      indexes_{std::move(d.indexes_)},
+      edgeTotal_{d.edgeTotal_},
+      incomingIndexed_{d.incomingIndexed_}
+{
+    d.vertexSlots_.clear();
+    d.vertexNumbers_.clear();
+    d.edgeTotal_ = 0;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo, typename Allocator>
+Digraph<VertexInfo, EdgeInfo, Allocator>::~Digraph()
+{
+}
+
+
+template <typename VertexInfo, typename EdgeInfo, typename Allocator>
+Digraph<VertexInfo, EdgeInfo, Allocator>& Digraph<VertexInfo, EdgeInfo, Allocator>::operator=(const Digraph& d)
+{
+    if (this != &d)
     {
-        std::cout<<"from: "<<edge.fromVertex<<" to vertex: "<<edge.toVertex<<std::endl;
-        std::cout<<"m: "<<edge.einfo.miles<<"  mph: "<<edge.einfo.milesPerHour<<std::endl;
+        vertexSlots_ = d.vertexSlots_;
+        vertexNumbers_ = d.vertexNumbers_;
+        indexes_ = d.indexes_;
+        edgeTotal_ = d.edgeTotal_;
+        incomingIndexed_ = d.incomingIndexed_;
     }
-*/
-    //std::cout<<"vertex: "<<vertex<<std::endl;
-    std::vector<std::pair<int, int>> edge_items;
-    try{
-    //for(auto& k:keys)
-    //{
-        //if(k==vertex)
-        //{
-            
-            for (auto& edge : di_map.at(vertex).edges)
-            {
-        //std::cout<<edge.toVertex<<std::endl;
-        //std::cout<<"vertex: "<<edge.first<<std::endl;
-        //if(edge.first==vertex)
-        //{
-        //  std::cout<<edge.second.edges.fromVertex<<std::endl;
-            //edge_items.push_back(std::make_pair(edge.second.edges.fromVertex,
-                //edge.second.edges.toVertex));
-        //}
-        //std::cout<<"from: "<<edge.fromVertex<<" to vertex: "<<edge.toVertex<<std::endl;
-        //std::cout<<"m: "<<edge.einfo.miles<<"  mph: "<<edge.einfo.milesPerHour<<std::endl;
-                edge_items.push_back(std::make_pair(edge.fromVertex,edge.toVertex));
-            }
-            return edge_items;
 
-        }
-    //}
-//}
-    
-    //std::cout<<e.reason()<<std::endl;
-    catch(...) 
-    {
-        //std::cout<<"out of range"<<std::endl;
-        DigraphException e("index does not exist");
-        std::cout<<e.reason()<<std::endl;
+    return *this;
+}
 
+
+template <typename VertexInfo, typename EdgeInfo, typename Allocator>
+Digraph<VertexInfo, EdgeInfo, Allocator>& Digraph<VertexInfo, EdgeInfo, Allocator>::operator=(
+    Digraph&& d) noexcept
+{
+    if (this != &d)
+    {
+        vertexSlots_ = std::move(d.vertexSlots_);
+        vertexNumbers_ = std::move(d.vertexNumbers_);
+        indexes_ = std::move(d.indexes_);
+        edgeTotal_ = d.edgeTotal_;
+        incomingIndexed_ = d.incomingIndexed_;
+
+        d.vertexSlots_.clear();
+        d.vertexNumbers_.clear();
+        d.edgeTotal_ = 0;
     }
-    return edge_items;
 
+    return *this;
 }
 
 
-template <typename VertexInfo, typename EdgeInfo>
-//typename DigraphVertex<VertexInfo, EdgeInfo>::VertexInfo 
-//typename DigraphVertex<VertexInfo, EdgeInfo>::
-//typename Digraph<VertexInfo, EdgeInfo>::
-VertexInfo Digraph<VertexInfo, EdgeInfo>::vertexInfo(int vertex) const
+template <typename VertexInfo, typename EdgeInfo, typename Allocator>
+std::vector<int> Digraph<VertexInfo, EdgeInfo, Allocator>::vertices() const
 {
-    VertexInfo vfo;
-    try
+    return std::vector<int>(vertexNumbers_.begin(), vertexNumbers_.end());
+}
+
+
+template <typename VertexInfo, typename EdgeInfo, typename Allocator>
+std::vector<std::pair<int, int>> Digraph<VertexInfo, EdgeInfo, Allocator>::edges() const
+{
+    std::vector<std::pair<int, int>> result;
+    result.reserve(edgeTotal_);
+
+    for (const DigraphVertex<VertexInfo, EdgeInfo, Allocator>& dv : vertexSlots_)
     {
-        vfo=di_map.at(vertex).vinfo;
-        return vfo;
+        for (const DigraphEdge<EdgeInfo>& edge : dv.edges)
+        {
+            result.emplace_back(edge.fromVertex, edge.toVertex);
+        }
     }
-    catch(...) 
+
+    return result;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo, typename Allocator>
+std::vector<std::pair<int, int>> Digraph<VertexInfo, EdgeInfo, Allocator>::edges(int vertex) const
+{
+    const DigraphVertex<VertexInfo, EdgeInfo, Allocator>& dv = vertexSlots_[toIndex(vertex)];
+
+    std::vector<std::pair<int, int>> result;
+    result.reserve(dv.edges.size());
+
+    for (const DigraphEdge<EdgeInfo>& edge : dv.edges)
     {
-        //std::cout<<"out of range"<<std::endl;
-        DigraphException e("index does not exist in vertexInfo");
-        std::cout<<e.reason()<<std::endl;
+        result.emplace_back(edge.fromVertex, edge.toVertex);
+    }
+
+    return result;
+}
+
 
+template <typename VertexInfo, typename EdgeInfo, typename Allocator>
+DigraphAllEdges<VertexInfo, EdgeInfo, Allocator> Digraph<VertexInfo, EdgeInfo, Allocator>::allEdges() const
+{
+    return DigraphAllEdges<VertexInfo, EdgeInfo, Allocator>{
+        vertexSlots_.data(), vertexSlots_.data() + vertexSlots_.size(), edgeTotal_};
+}
+
+
+template <typename VertexInfo, typename EdgeInfo, typename Allocator>
+DigraphEdgeRange<EdgeInfo> Digraph<VertexInfo, EdgeInfo, Allocator>::outEdges(int vertex) const
+{
+    const DigraphEdgeList<EdgeInfo, Allocator>& edges = vertexSlots_[toIndex(vertex)].edges;
+    return DigraphEdgeRange<EdgeInfo>{edges.begin(), edges.end()};
+}
+
+
+template <typename VertexInfo, typename EdgeInfo, typename Allocator>
+const VertexInfo& Digraph<VertexInfo, EdgeInfo, Allocator>::vertexInfo(int vertex) const
+{
+    return vertexSlots_[toIndex(vertex)].vinfo;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo, typename Allocator>
+const EdgeInfo& Digraph<VertexInfo, EdgeInfo, Allocator>::edgeInfo(int fromVertex, int toVertex) const
+{
+    int fromIndex = toIndex(fromVertex);
+    auto found = findEdge(fromIndex, toIndex(toVertex));
+
+    if (found == vertexSlots_[fromIndex].edges.end())
+    {
+        throw DigraphException{"edge does not exist"};
     }
-	return vfo;
-    //std::cout<<di_map[vertex].vinfo<<std::endl;
-    //return di_map[vertex];
+
+    return found->einfo;
 }
 
 
+template <typename VertexInfo, typename EdgeInfo, typename Allocator>
+void Digraph<VertexInfo, EdgeInfo, Allocator>::addVertex(int vertex, const VertexInfo& vinfo)
+{
+    emplaceVertex(vertex, vinfo);
+}
+
+
+template <typename VertexInfo, typename EdgeInfo, typename Allocator>
+void Digraph<VertexInfo, EdgeInfo, Allocator>::addVertex(int vertex, VertexInfo&& vinfo)
+{
+    emplaceVertex(vertex, std::move(vinfo));
+}
+
 
-template <typename VertexInfo, typename EdgeInfo>
-//typename DigraphEdge<EdgeInfo>::EdgeInfo 
-//typename DigraphEdge<EdgeInfo>::
-//typename Digraph<VertexInfo, EdgeInfo>::
-EdgeInfo Digraph<VertexInfo, EdgeInfo>::edgeInfo(int fromVertex, int toVertex) const
+template <typename VertexInfo, typename EdgeInfo, typename Allocator>
+template <typename... Args>
+void Digraph<VertexInfo, EdgeInfo, Allocator>::emplaceVertex(int vertex, Args&&... args)
 {
-    //for (auto& edge : di_map[fromVertex].edges)
-    EdgeInfo ed;
-    DigraphException e("index does not exist in edgeInfo");
-try{
-    for (auto& edge : di_map.at(fromVertex).edges)
+    if (indexes_.contains(vertex))
     {
-        if(edge.toVertex==toVertex)
-        {
-            return edge.einfo;
-        }
+        throw DigraphException{"vertex already exists"};
     }
-    throw(e);
+
+    appendVertex(vertex, newVertex(std::forward<Args>(args)...));
+}
+
+
+template <typename VertexInfo, typename EdgeInfo, typename Allocator>
+void Digraph<VertexInfo, EdgeInfo, Allocator>::addEdge(int fromVertex, int toVertex, const EdgeInfo& einfo)
+{
+    emplaceEdge(fromVertex, toVertex, einfo);
 }
-    catch(...) 
+
+
+template <typename VertexInfo, typename EdgeInfo, typename Allocator>
+void Digraph<VertexInfo, EdgeInfo, Allocator>::addEdge(int fromVertex, int toVertex, EdgeInfo&& einfo)
+{
+    emplaceEdge(fromVertex, toVertex, std::move(einfo));
+}
+
+
+template <typename VertexInfo, typename EdgeInfo, typename Allocator>
+template <typename... Args>
+void Digraph<VertexInfo, EdgeInfo, Allocator>::emplaceEdge(int fromVertex, int toVertex, Args&&... args)
+{
+    int fromIndex = toIndex(fromVertex);
+    int targetIndex = toIndex(toVertex);
+
+    DigraphEdgeList<EdgeInfo, Allocator>& edges = vertexSlots_[fromIndex].edges;
+
+    if (findEdge(fromIndex, targetIndex) != edges.end())
     {
-        //std::cout<<"out of range"<<std::endl;
-        //DigraphException e("index does not exist in edgeInfo");
-        std::cout<<e.reason()<<std::endl;
+        throw DigraphException{"edge already exists"};
+    }
+
+    edges.push_back(
+        DigraphEdge<EdgeInfo>{
+            fromVertex, toVertex, targetIndex, EdgeInfo(std::forward<Args>(args)...)});
 
+    ++edgeTotal_;
+
+    if (incomingIndexed_)
+    {
+        vertexSlots_[targetIndex].predecessors.push_back(fromIndex);
     }
-    return ed;
-    
 }
 
 
+template <typename VertexInfo, typename EdgeInfo, typename Allocator>
+void Digraph<VertexInfo, EdgeInfo, Allocator>::reserve(int vertexCount)
+{
+    vertexSlots_.reserve(vertexCount);
+    vertexNumbers_.reserve(vertexCount);
+    indexes_.reserve(vertexCount);
+}
+
 
-template <typename VertexInfo, typename EdgeInfo>
-void Digraph<VertexInfo, EdgeInfo>::addVertex(int vertex, const VertexInfo&vinfo)
+template <typename VertexInfo, typename EdgeInfo, typename Allocator>
+template <typename VertexRange>
+void Digraph<VertexInfo, EdgeInfo, Allocator>::addVertices(VertexRange&& vertices)
 {
-    //Digraph.map_loc.insert(std::pair<int, set<std::string>> (vertex, vinfo));
-    //std::set<std::string> myset.insert(vinfo);
-    //std::set<std::string> myset;
-    //myset.insert(vinfo);
-    //Di_map.insert(std::make_pair())
-    //vertx{vinfo};
-    //map_loc.insert(std::make_pair(vinfo, vertex));
-    //di_map.insert(std::make_pair(vertex, std::make_pair(vinfo)))
-    
-    //Digraph.map_loc[vertex].insert(myset));
-    //std::cout<<"vertex: "<<vertex<<std::endl;
-    //std::cout<<"vertexinfo: "<<vinfo<<std::endl;
-    //EdgeInfo ed(RoadSegment{4,2});
-    //std::cout<<"vertex add: "<<vertex<<std::endl;
-    DigraphException e("vertex already exists");
-    //vertx.push_back(vertex);
-    
+    std::vector<int> numbers;
 
-    std::list<DigraphEdge<EdgeInfo>> ed;
-    DigraphVertex<VertexInfo, EdgeInfo> vx{vinfo, ed};
+    for (const auto& vertex : vertices)
+    {
+        numbers.push_back(std::get<0>(vertex));
+    }
 
-    //std::cout<<ed.miles<<"    "<<ed.milesPerHour<<std::endl;
-    //for(auto v: vertx)
-    //for (int v: vertx)
-try{
-    for(auto v: keys)
+    std::sort(numbers.begin(), numbers.end());
+
+    std::vector<std::string> duplicates;
+
+    for (unsigned int i = 0; i < numbers.size(); ++i)
     {
-        //std::cout<<"v: "<<v<<std::endl;
-        //std::cout<<"vinfo: "<<di_map[i].vinfo<<std::endl;
-        //std::cout<<"vinfo0: "<<di_map[0].vinfo<<std::endl;
+        bool repeated = i > 0 && numbers[i] == numbers[i - 1];
+        bool present = indexes_.contains(numbers[i]);
+
+        // Each duplicated vertex number is listed once, no matter how
+        // many times it appears.
+        bool listed = repeated && (present || (i > 1 && numbers[i] == numbers[i - 2]));
 
-        //std::cout<<"vinfop: "<<vinfo<<std::endl;
-        if(v==vertex)
+        if ((repeated || present) && !listed)
         {
-            //std::cout<<"---------there is a repeat of vertex!"<<std::endl;
-            throw(e);
+            duplicates.push_back(std::to_string(numbers[i]));
         }
     }
-    //std::cout<<"executed"<<std::endl;
 
-    keys.push_back(vertex);
-    di_map.insert(std::make_pair(vertex, vx));
-    num_vertex++;
-    
-}
-    catch(...)
+    if (!duplicates.empty())
     {
-        std::cout<<e.reason()<<std::endl;
-        return;
+        throw DigraphException{
+            describeAll("vertex already exists", "vertices already exist", duplicates)};
     }
-    //std::cout<<"------->"<<vertex<<std::endl;
-    //std::cout<<"getting stored: "<<std::endl;
 
-    
-    //di_map.emplace(vertex, vinfo, ed);
+    reserve(vertexCount() + static_cast<int>(numbers.size()));
 
+    // If constructing a VertexInfo throws partway through, the vertices
+    // added before it are removed again, so that a failed batch adds
+    // nothing, just as a failed check does.
 
+    int firstIndex = vertexCount();
 
-    //std::cout<<"vertex: "<<vertex<<std::endl;
-    /*   
-    for(typename std::map<int, DigraphVertex<VertexInfo, EdgeInfo>>::iterator it=di_map.begin(); 
-        it!=di_map.end(); ++it)
+    try
+    {
+        for (auto& vertex : vertices)
+        {
+            appendVertex(
+                std::get<0>(vertex), newVertex(forwardElement<VertexRange>(std::get<1>(vertex))));
+        }
+    }
+    catch (...)
     {
-        //int first=it->first;
-        //std::set<std::string> second=it->second;
-        std::cout<<it->first<<std::endl;
+        while (vertexCount() > firstIndex)
+        {
+            indexes_.erase(vertexNumbers_.back());
+            vertexNumbers_.pop_back();
+            vertexSlots_.pop_back();
+        }
 
-        //<<it->second<<std::endl;
-        //std::cout<<it->second<<std:endl;
+        throw;
     }
-    */
-    //std::cout<<vertex<<"    "<<di_map[vertex].vinfo<<std::endl;
-    
-    
-    //std::cout<<"addVertex"<<std::endl;
 }
 
 
-template <typename VertexInfo, typename EdgeInfo>
-void Digraph<VertexInfo, EdgeInfo>::addEdge(int fromVertex, int toVertex, const EdgeInfo& einfo)
+template <typename VertexInfo, typename EdgeInfo, typename Allocator>
+template <typename EdgeRange>
+void Digraph<VertexInfo, EdgeInfo, Allocator>::addEdges(EdgeRange&& edges)
 {
-    DigraphEdge<EdgeInfo> ed{fromVertex, toVertex, einfo};
-    DigraphException e("vertex does not exists");
-    DigraphException v("vertex destination already exists");
-    //di_map.edges.empalce(ed);
-    /*
-    for(int i=0; i<vertx.size();i++)
+    // Each edge is translated to a pair of indexes, in range order, then
+    // a sorted copy of the pairs reveals the duplicates within the range.
+
+    std::vector<std::pair<int, int>> pending;
+    std::vector<std::string> missing;
+
+    auto lookUp =
+        [&](int vertex)
+        {
+            const int* found = indexes_.find(vertex);
+
+            if (found == nullptr)
+            {
+                missing.push_back(std::to_string(vertex));
+                return -1;
+            }
+
+            return *found;
+        };
+
+    for (const auto& edge : edges)
+    {
+        int fromIndex = lookUp(std::get<0>(edge));
+        int targetIndex = lookUp(std::get<1>(edge));
+        pending.emplace_back(fromIndex, targetIndex);
+    }
+
+    if (!missing.empty())
+    {
+        std::sort(missing.begin(), missing.end());
+        missing.erase(std::unique(missing.begin(), missing.end()), missing.end());
+
+        throw DigraphException{
+            describeAll("vertex does not exist", "vertices do not exist", missing)};
+    }
+
+    std::vector<std::pair<int, int>> sorted = pending;
+    std::sort(sorted.begin(), sorted.end());
+
+    std::vector<std::string> duplicates;
+
+    for (unsigned int i = 0; i < sorted.size(); ++i)
+    {
+        int fromIndex = sorted[i].first;
+        int targetIndex = sorted[i].second;
+
+        bool repeated = i > 0 && sorted[i] == sorted[i - 1];
+        bool present = findEdge(fromIndex, targetIndex) != vertexSlots_[fromIndex].edges.end();
+        bool listed = repeated && (present || (i > 1 && sorted[i] == sorted[i - 2]));
+
+        if ((repeated || present) && !listed)
+        {
+            duplicates.push_back(
+                std::to_string(vertexNumbers_[fromIndex]) + "->"
+                + std::to_string(vertexNumbers_[targetIndex]));
+        }
+    }
+
+    if (!duplicates.empty())
     {
-        di_map[vertx[i]].edges.push_back(ed);
-        //std::cout<<di_map[vertx[i]].edges.fromVertex<<std::endl;
+        throw DigraphException{
+            describeAll("edge already exists", "edges already exist", duplicates)};
     }
-*/
 
-    //std::cout<<di_map[fromVertex].edges.toVertex<<std::endl;
-    //for (EdgeInfo& edge : di_map[fromVertex].edges)
-    //std::cout<<"    -   -   -   -   -   "<<std::endl;
-try{
-    for (auto& edge : di_map[fromVertex].edges)
+    int e = 0;
+
+    for (auto& edge : edges)
     {
-        if(edge.toVertex==toVertex)
+        vertexSlots_[pending[e].first].edges.push_back(
+            DigraphEdge<EdgeInfo>{
+                std::get<0>(edge), std::get<1>(edge), pending[e].second,
+                forwardElement<EdgeRange>(std::get<2>(edge))});
+
+        if (incomingIndexed_)
         {
-            //std::cout<<"there is a repeat of edges!"<<std::endl;
-            throw(v);
-            //return;
+            vertexSlots_[pending[e].second].predecessors.push_back(pending[e].first);
         }
-        //else
-            //edge.push_back(ed);
-            //di_map[fromVertex].edges.push_back(ed); 
 
-        //std::cout<<edge.fromVertex<<" to vertex: "<<edge.toVertex<<std::endl;
-        //std::cout<<"m: "<<edge.einfo.miles<<"  mph: "<<edge.einfo.milesPerHour<<std::endl;
+        ++e;
     }
-    //std::cout<<"-------->"<<fromVertex<<std::endl;
-    di_map[fromVertex].edges.push_back(ed); 
-    num_edge++;
+
+    edgeTotal_ += e;
 }
-    catch(std::out_of_range)
+
+
+template <typename VertexInfo, typename EdgeInfo, typename Allocator>
+void Digraph<VertexInfo, EdgeInfo, Allocator>::removeVertex(int vertex)
+{
+    int index = toIndex(vertex);
+    int last = vertexCount() - 1;
+
+    if (incomingIndexed_)
     {
-        std::cout<<e.reason()<<std::endl;
-        return;
+        removeIndexedVertex(index, last);
     }
-    catch(DigraphException& v)
+    else
+    {
+        removeUnindexedVertex(index, last);
+    }
+
+    if (index != last)
+    {
+        vertexSlots_[index] = std::move(vertexSlots_[last]);
+        vertexNumbers_[index] = vertexNumbers_[last];
+        *indexes_.find(vertexNumbers_[index]) = index;
+    }
+
+    vertexSlots_.pop_back();
+    vertexNumbers_.pop_back();
+    indexes_.erase(vertex);
+}
+
+
+template <typename VertexInfo, typename EdgeInfo, typename Allocator>
+void Digraph<VertexInfo, EdgeInfo, Allocator>::removeEdge(int fromVertex, int toVertex)
+{
+    int fromIndex = toIndex(fromVertex);
+    auto found = findEdge(fromIndex, toIndex(toVertex));
+
+    DigraphEdgeList<EdgeInfo, Allocator>& edges = vertexSlots_[fromIndex].edges;
+
+    if (found == edges.end())
+    {
+        throw DigraphException{"edge does not exist"};
+    }
+
+    if (incomingIndexed_)
+    {
+        unlinkPredecessor(found->toIndex, fromIndex);
+    }
+
+    edges.erase(found);
+    --edgeTotal_;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo, typename Allocator>
+void Digraph<VertexInfo, EdgeInfo, Allocator>::indexIncomingEdges()
+{
+    if (incomingIndexed_)
     {
-        std::cout<<v.reason()<<std::endl;
         return;
     }
-    //std::cout<<"loc_before: "<<di_map[0].vinfo<<std::endl;
-    //di_map.removeVertex(0);
-    //std::cout<<"loc_0: "<<di_map[0].vinfo<<std::endl;
-/*
-    for (auto& edge : di_map[fromVertex].edges)
-    {
-        std::cout<<"from: "<<edge.fromVertex<<" to vertex: "<<edge.toVertex<<std::endl;
-        std::cout<<"m: "<<edge.einfo.miles<<"  mph: "<<edge.einfo.milesPerHour<<std::endl;
-    }
-
-    for(typename std::map<int, DigraphVertex<VertexInfo, EdgeInfo>>::iterator it=di_map.begin(); 
-        it!=di_map.end(); ++it)
-    {
-        
-        //for(typename DigraphVertex<VertexInfo, EdgeInfo>::iterator it2=di_map.begin();
-        //    it2!=di_map.end(); ++it2)
-        //{
-            //it->second=ed;
-        
-        
-        //int first=it->first;
-        //std::set<std::string> second=it->second;
-        //std::cout<<it->first<<std::endl;
-        it->second.edges.push_back(ed);
-        //std::cout<<di_map.edges.fromVertex<<std::endl;
-        //std::cout<<it->second.edges.fromVertex<<std::endl;
-
-        // {ed};
-        //<<it->second<<std::endl;
-        //std::cout<<it->second<<std:endl;
-       //}
-    }
-    std::cout<<di_map[0].edges.fromVertex<<std::endl;
-    
-    //edge{toVertex, fromVertex, einfo};
-    //std::cout<<"to: "<<fromVertex<<" from: "<<toVertex<<std::endl;
-    //std::cout<<"edgeinfo: "<<einfo.miles<<" "<<einfo.milesPerHour<<std::endl;
-
-    //std::cout<<"addEdge"<<std::endl;
-*/
-}
-
-
-template <typename VertexInfo, typename EdgeInfo>
-void Digraph<VertexInfo, EdgeInfo>::removeVertex(int vertex)
-{
-    //std::cout<<"find: "<<di_map[vertex].vinfo<<std::endl;
-    //if(di_map.find(vertex)<0)
-    // if(di_map.find(vertex)==di_map.end())
-    // {
-    //     //std::cout<<"not exists!"<<std::endl;
-    //     return;
-    // }
-    //int i=0;
-//for(typename std::map<int, DigraphVertex<VertexInfo, EdgeInfo>>::iterator it=di_map.begin(); it!=di_map.end(); ++it)
-    DigraphException e("vertex does not exist to be removed");
-try{
-    for(std::vector<int>::iterator it=keys.begin();it!=keys.end(); ++it)
-    {
-        //i++
-        if(*it==vertex)
+
+    for (int i = 0; i < vertexCount(); ++i)
+    {
+        for (const DigraphEdge<EdgeInfo>& edge : vertexSlots_[i].edges)
         {
-            keys.erase(it);
-            di_map.erase(vertex);
-            return;
+            vertexSlots_[edge.toIndex].predecessors.push_back(i);
         }
     }
-    throw(e);
+
+    incomingIndexed_ = true;
 }
-catch(...)
+
+
+template <typename VertexInfo, typename EdgeInfo, typename Allocator>
+bool Digraph<VertexInfo, EdgeInfo, Allocator>::incomingEdgesIndexed() const
 {
-    std::cout<<e.reason()<<std::endl;
-    return;
+    return incomingIndexed_;
 }
-    
-    //keys.erase(keys.begin()+vertex);
-    //std::cout<<"after find: "<<di_map[vertex].vinfo<<std::endl;
 
-    //std::cout<<"after find: "<<di_map[50].vinfo<<std::endl;
 
-    num_vertex--;
+template <typename VertexInfo, typename EdgeInfo, typename Allocator>
+std::vector<std::pair<int, int>> Digraph<VertexInfo, EdgeInfo, Allocator>::incomingEdges(int vertex) const
+{
+    std::vector<std::pair<int, int>> result;
+
+    forEachInEdge(
+        toIndex(vertex),
+        [&](int fromIndex, const EdgeInfo&)
+        {
+            result.emplace_back(vertexNumbers_[fromIndex], vertex);
+        });
+
+    return result;
 }
 
 
-template <typename VertexInfo, typename EdgeInfo>
-void Digraph<VertexInfo, EdgeInfo>::removeEdge(int fromVertex, int toVertex)
+template <typename VertexInfo, typename EdgeInfo, typename Allocator>
+int Digraph<VertexInfo, EdgeInfo, Allocator>::vertexCount() const
 {
-    /*
-    std::cout<<"----->"<<fromVertex<<std::endl;
-    //int i=0;
-    for (auto& edge : di_map[fromVertex].edges)
-    {
-        std::cout<<"before from: "<<edge.fromVertex<<" to vertex: "<<edge.toVertex<<std::endl;
-        std::cout<<"m: "<<edge.einfo.miles<<"  mph: "<<edge.einfo.milesPerHour<<std::endl;
-    }
-*/
-    DigraphException e("edge does not exist");
-    //DigraphException o("vertex does not exist");
-try{
-    for (auto& edge : di_map[fromVertex].edges)
+    return static_cast<int>(vertexSlots_.size());
+}
+
+
+template <typename VertexInfo, typename EdgeInfo, typename Allocator>
+int Digraph<VertexInfo, EdgeInfo, Allocator>::edgeCount() const
+{
+    return edgeTotal_;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo, typename Allocator>
+int Digraph<VertexInfo, EdgeInfo, Allocator>::edgeCount(int vertex) const
+{
+    return static_cast<int>(vertexSlots_[toIndex(vertex)].edges.size());
+}
+
+
+template <typename VertexInfo, typename EdgeInfo, typename Allocator>
+bool Digraph<VertexInfo, EdgeInfo, Allocator>::isStronglyConnected() const
+{
+    // A graph with no vertices has no components, so it's not considered
+    // strongly connected.
+    return strongComponents().componentCount == 1;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo, typename Allocator>
+StrongComponents Digraph<VertexInfo, EdgeInfo, Allocator>::strongComponents() const
+{
+    return findStrongComponents(*this);
+}
+
+
+template <typename VertexInfo, typename EdgeInfo, typename Allocator>
+std::map<int, int> Digraph<VertexInfo, EdgeInfo, Allocator>::findShortestPaths(
+    int startVertex,
+    std::function<double(const EdgeInfo&)> edgeWeightFunc) const
+{
+    ShortestPathSearch search;
+    search.run(*this, toIndex(startVertex), edgeWeightFunc);
+    return search.predecessorMap(*this);
+}
+
+
+template <typename VertexInfo, typename EdgeInfo, typename Allocator>
+template <typename WeightFunc>
+std::map<int, int> Digraph<VertexInfo, EdgeInfo, Allocator>::findShortestPaths(
+    int startVertex, WeightFunc&& edgeWeightFunc) const
+{
+    ShortestPathSearch search;
+    search.run(*this, toIndex(startVertex), edgeWeightFunc);
+    return search.predecessorMap(*this);
+}
+
+
+template <typename VertexInfo, typename EdgeInfo, typename Allocator>
+ShortestPath<EdgeInfo> Digraph<VertexInfo, EdgeInfo, Allocator>::findShortestPath(
+    int startVertex, int endVertex,
+    std::function<double(const EdgeInfo&)> edgeWeightFunc) const
+{
+    int endIndex = toIndex(endVertex);
+
+    ShortestPathSearch search;
+    search.run(*this, toIndex(startVertex), edgeWeightFunc, endIndex);
+    return search.pathTo<EdgeInfo>(*this, endIndex);
+}
+
+
+template <typename VertexInfo, typename EdgeInfo, typename Allocator>
+template <typename WeightFunc>
+ShortestPath<EdgeInfo> Digraph<VertexInfo, EdgeInfo, Allocator>::findShortestPath(
+    int startVertex, int endVertex, WeightFunc&& edgeWeightFunc) const
+{
+    SearchWorkspace workspace;
+    return findShortestPath(startVertex, endVertex, edgeWeightFunc, workspace);
+}
+
+
+template <typename VertexInfo, typename EdgeInfo, typename Allocator>
+template <typename WeightFunc>
+ShortestPath<EdgeInfo> Digraph<VertexInfo, EdgeInfo, Allocator>::findShortestPath(
+    int startVertex, int endVertex, WeightFunc&& edgeWeightFunc,
+    SearchWorkspace& workspace) const
+{
+    int endIndex = toIndex(endVertex);
+
+    ShortestPathSearch search{workspace};
+    search.run(*this, toIndex(startVertex), edgeWeightFunc, endIndex);
+    return search.pathTo<EdgeInfo>(*this, endIndex);
+}
+
+
+template <typename VertexInfo, typename EdgeInfo, typename Allocator>
+CompactDigraph<VertexInfo, EdgeInfo> Digraph<VertexInfo, EdgeInfo, Allocator>::freeze() const
+{
+    std::vector<VertexInfo> vertexInfos;
+    std::vector<int> offsets{0};
+    std::vector<int> targets;
+    std::vector<EdgeInfo> edgeInfos;
+
+    vertexInfos.reserve(vertexCount());
+    offsets.reserve(vertexCount() + 1);
+    targets.reserve(edgeTotal_);
+    edgeInfos.reserve(edgeTotal_);
+
+    for (const DigraphVertex<VertexInfo, EdgeInfo, Allocator>& dv : vertexSlots_)
     {
-        if(edge.toVertex==toVertex)
+        vertexInfos.push_back(dv.vinfo);
+
+        for (const DigraphEdge<EdgeInfo>& edge : dv.edges)
         {
-            //std::cout<<"found the vertex!"<<std::endl;
-            edge.toVertex=di_map.erase(toVertex);
-            num_edge--;
-            return;
-            //edge.remove(toVertex);
-            //di_map.erase(edge);
-            //di_map[fromVertex].erase(edge);
+            targets.push_back(edge.toIndex);
+            edgeInfos.push_back(edge.einfo);
         }
-        //std::cout<<"from: "<<edge.fromVertex<<" to vertex: "<<edge.toVertex<<std::endl;
-        //std::cout<<"m: "<<edge.einfo.miles<<"  mph: "<<edge.einfo.milesPerHour<<std::endl;
+
+        offsets.push_back(static_cast<int>(targets.size()));
     }
-    throw(e);
+
+    return CompactDigraph<VertexInfo, EdgeInfo>{
+        vertices(), std::move(vertexInfos), std::move(offsets),
+        std::move(targets), std::move(edgeInfos)};
 }
-    // catch(std::out_of_range)
-    // {
-    //     std::cout<<o.reason()<<std::endl;
-    //     return;
-    // }
-    catch(DigraphException e)
+
+
+template <typename VertexInfo, typename EdgeInfo, typename Allocator>
+int Digraph<VertexInfo, EdgeInfo, Allocator>::toIndex(int vertex) const
+{
+    const int* found = indexes_.find(vertex);
+
+    if (found == nullptr)
     {
-        std::cout<<e.reason()<<std::endl;
+        throw DigraphException{"vertex does not exist"};
+    }
+
+    return *found;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo, typename Allocator>
+int Digraph<VertexInfo, EdgeInfo, Allocator>::toVertexNumber(int index) const
+{
+    if (index < 0 || index >= vertexCount())
+    {
+        throw DigraphException{"index does not exist"};
+    }
+
+    return vertexNumbers_[index];
+}
+
+
+template <typename VertexInfo, typename EdgeInfo, typename Allocator>
+template <typename Visit>
+void Digraph<VertexInfo, EdgeInfo, Allocator>::forEachOutEdge(int index, Visit&& visit) const
+{
+    for (const DigraphEdge<EdgeInfo>& edge : vertexSlots_[index].edges)
+    {
+        visit(edge.toIndex, edge.einfo);
+    }
+}
+
+
+template <typename VertexInfo, typename EdgeInfo, typename Allocator>
+template <typename Visit>
+void Digraph<VertexInfo, EdgeInfo, Allocator>::forEachInEdge(int index, Visit&& visit) const
+{
+    if (incomingIndexed_)
+    {
+        for (int fromIndex : vertexSlots_[index].predecessors)
+        {
+            visit(fromIndex, findEdge(fromIndex, index)->einfo);
+        }
+
         return;
     }
-    
-    //di_map[fromVertex].edges.find(toVertex);
-    //std::cout<<"map at ver/edge: "<<di_map[fromVertex].edges[toVertex]<<std::endl;
-/*
-    for (auto& edge : di_map[fromVertex].edges)
+
+    for (int fromIndex = 0; fromIndex < vertexCount(); ++fromIndex)
     {
-        std::cout<<"after from: "<<edge.fromVertex<<" to vertex: "<<edge.toVertex<<std::endl;
-        std::cout<<"m: "<<edge.einfo.miles<<"  mph: "<<edge.einfo.milesPerHour<<std::endl;
+        for (const DigraphEdge<EdgeInfo>& edge : vertexSlots_[fromIndex].edges)
+        {
+            if (edge.toIndex == index)
+            {
+                visit(fromIndex, edge.einfo);
+            }
+        }
     }
-    */
 }
 
-//void removeEdge(int fromVertex, int toVertex)
-//{
 
-//}
+template <typename VertexInfo, typename EdgeInfo, typename Allocator>
+std::string Digraph<VertexInfo, EdgeInfo, Allocator>::describeAll(
+    const std::string& one, const std::string& many,
+    const std::vector<std::string>& items)
+{
+    const unsigned int listLimit = 10;
+
+    std::string reason = (items.size() == 1 ? one : many) + ": ";
+
+    for (unsigned int i = 0; i < items.size() && i < listLimit; ++i)
+    {
+        reason += (i > 0 ? ", " : "") + items[i];
+    }
+
+    if (items.size() > listLimit)
+    {
+        reason += ", and " + std::to_string(items.size() - listLimit) + " more";
+    }
+
+    return reason;
+}
 
 
-template <typename VertexInfo, typename EdgeInfo>
-int Digraph<VertexInfo, EdgeInfo>::vertexCount() const
+template <typename VertexInfo, typename EdgeInfo, typename Allocator>
+typename DigraphEdgeList<EdgeInfo, Allocator>::const_iterator Digraph<VertexInfo, EdgeInfo, Allocator>::findEdge(
+    int fromIndex, int targetIndex) const
 {
-    return num_vertex;
+    const DigraphEdgeList<EdgeInfo, Allocator>& edges = vertexSlots_[fromIndex].edges;
+
+    for (auto e = edges.begin(); e != edges.end(); ++e)
+    {
+        if (e->toIndex == targetIndex)
+        {
+            return e;
+        }
+    }
+
+    return edges.end();
 }
 
 
-template <typename VertexInfo, typename EdgeInfo>
-int Digraph<VertexInfo, EdgeInfo>::edgeCount() const
+template <typename VertexInfo, typename EdgeInfo, typename Allocator>
+template <typename... Args>
+DigraphVertex<VertexInfo, EdgeInfo, Allocator> Digraph<VertexInfo, EdgeInfo, Allocator>::newVertex(
+    Args&&... args) const
 {
-    return num_edge;
+    Allocator allocator{vertexSlots_.get_allocator()};
+
+    return DigraphVertex<VertexInfo, EdgeInfo, Allocator>{
+        VertexInfo(std::forward<Args>(args)...),
+        DigraphEdgeList<EdgeInfo, Allocator>(allocator),
+        std::vector<int, ReboundAllocator<Allocator, int>>(allocator)};
 }
 
 
-template <typename VertexInfo, typename EdgeInfo>
-int Digraph<VertexInfo, EdgeInfo>::edgeCount(int vertex) const
+template <typename VertexInfo, typename EdgeInfo, typename Allocator>
+void Digraph<VertexInfo, EdgeInfo, Allocator>::appendVertex(
+    int vertex, DigraphVertex<VertexInfo, EdgeInfo, Allocator>&& slot)
 {
-    int edge_count=0;
-    for (auto& edge : di_map.at(vertex).edges)
+    int index = vertexCount();
+
+    vertexSlots_.push_back(std::move(slot));
+
+    try
+    {
+        vertexNumbers_.push_back(vertex);
+        indexes_.insert(vertex, index);
+    }
+    catch (...)
     {
-        edge_count++;
+        if (static_cast<int>(vertexNumbers_.size()) > index)
+        {
+            vertexNumbers_.pop_back();
+        }
+
+        vertexSlots_.pop_back();
+        throw;
     }
-    return edge_count++;
 }
 
 
+template <typename VertexInfo, typename EdgeInfo, typename Allocator>
+template <typename Range, typename T>
+typename std::conditional<
+    std::is_lvalue_reference<Range>::value, T&, T&&>::type
+Digraph<VertexInfo, EdgeInfo, Allocator>::forwardElement(T& part)
+{
+    return static_cast<
+        typename std::conditional<std::is_lvalue_reference<Range>::value, T&, T&&>::type>(part);
+}
 
-template <typename VertexInfo, typename EdgeInfo>
-bool Digraph<VertexInfo, EdgeInfo>::isStronglyConnected() const
+
+template <typename VertexInfo, typename EdgeInfo, typename Allocator>
+void Digraph<VertexInfo, EdgeInfo, Allocator>::unlinkPredecessor(int targetIndex, int fromIndex)
 {
-    if(keys.size()<1)
-        return false;
-    std::map<int, bool> visited;
-    std::vector<int> stack;
-    for(auto v: keys)
+    std::vector<int, ReboundAllocator<Allocator, int>>& predecessors = vertexSlots_[targetIndex].predecessors;
+
+    auto found = std::find(predecessors.begin(), predecessors.end(), fromIndex);
+    *found = predecessors.back();
+    predecessors.pop_back();
+}
+
+
+template <typename VertexInfo, typename EdgeInfo, typename Allocator>
+void Digraph<VertexInfo, EdgeInfo, Allocator>::relinkPredecessor(
+    int targetIndex, int oldFromIndex, int newFromIndex)
+{
+    std::vector<int, ReboundAllocator<Allocator, int>>& predecessors = vertexSlots_[targetIndex].predecessors;
+    *std::find(predecessors.begin(), predecessors.end(), oldFromIndex) = newFromIndex;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo, typename Allocator>
+void Digraph<VertexInfo, EdgeInfo, Allocator>::removeIndexedVertex(int index, int last)
+{
+    DigraphVertex<VertexInfo, EdgeInfo, Allocator>& removed = vertexSlots_[index];
+
+    // Outgoing edges go away with the vertex, but their targets have to
+    // forget about it; incoming edges are found through its predecessors.
+    // A self-loop is both, and goes away with the outgoing edges.
+
+    edgeTotal_ -= static_cast<int>(removed.edges.size());
+
+    for (const DigraphEdge<EdgeInfo>& edge : removed.edges)
     {
-        visited.insert(std::make_pair(v, false));
-        
+        if (edge.toIndex != index)
+        {
+            unlinkPredecessor(edge.toIndex, index);
+        }
     }
-    stack.push_back(keys[0]);
-    while(!stack.empty())
+
+    for (int fromIndex : removed.predecessors)
     {
-        int loc=stack.back();
-        stack.pop_back();
-        if(visited.at(loc)==false)
+        if (fromIndex != index)
         {
-            visited.at(loc)=true;
-            for(auto edge: di_map.at(loc).edges)
+            vertexSlots_[fromIndex].edges.erase(findEdge(fromIndex, index));
+            --edgeTotal_;
+        }
+    }
+
+    if (index == last)
+    {
+        return;
+    }
+
+    // The last vertex is about to move into the removed vertex's index, so
+    // its outgoing edges' targets have to list it by its new index, and its
+    // incoming edges have to point there.  Its own self-loop, if it has one,
+    // is handled by the first of these.
+
+    DigraphVertex<VertexInfo, EdgeInfo, Allocator>& moved = vertexSlots_[last];
+
+    for (DigraphEdge<EdgeInfo>& edge : moved.edges)
+    {
+        relinkPredecessor(edge.toIndex, last, index);
+
+        if (edge.toIndex == last)
+        {
+            edge.toIndex = index;
+        }
+    }
+
+    for (int fromIndex : moved.predecessors)
+    {
+        if (fromIndex != index)
+        {
+            for (DigraphEdge<EdgeInfo>& edge : vertexSlots_[fromIndex].edges)
             {
-                for(auto v: keys)
+                if (edge.toIndex == last)
                 {
-                    if(edge.toVertex==v && visited.at(v)==false)
-                    {
-                        int new_v=v;
-                        stack.push_back(new_v);
-                    }
+                    edge.toIndex = index;
+                    break;
                 }
             }
         }
     }
-    //bool connected=false;
-    int i=0;
-    for(auto v: visited)
+}
+
+
+template <typename VertexInfo, typename EdgeInfo, typename Allocator>
+void Digraph<VertexInfo, EdgeInfo, Allocator>::removeUnindexedVertex(int index, int last)
+{
+    // Outgoing edges go away with the vertex; incoming edges have to be
+    // found by scanning every other vertex's edges.  While we're at it,
+    // edges pointing to the last vertex are retargeted to the index it's
+    // about to be moved into.
+
+    edgeTotal_ -= static_cast<int>(vertexSlots_[index].edges.size());
+
+    for (int i = 0; i <= last; ++i)
     {
-        i++;
-        if(v.second==false&&i==(visited.size()-1))
+        if (i == index)
         {
-            //std::cout<<"fasle"<<std::endl;
-            return false;
+            continue;
         }
-    }
-    return true;
 
+        DigraphEdgeList<EdgeInfo, Allocator>& edges = vertexSlots_[i].edges;
 
+        for (auto e = edges.begin(); e != edges.end(); )
+        {
+            if (e->toIndex == index)
+            {
+                e = edges.erase(e);
+                --edgeTotal_;
+            }
+            else
+            {
+                if (e->toIndex == last)
+                {
+                    e->toIndex = index;
+                }
 
+                ++e;
+            }
+        }
+    }
 }
-//template<typename VertexInfo, typename EdgeInfo>
-//std::map<int, int> findShortestPaths(int startVertex,std::function<double(const EdgeInfo&)> edgeWeightFunc) //const
-//{
-    
-//}
 
 
 
@@ -0,0 +1,32 @@
+// DigraphException.hpp
+//
+// ICS 46 Spring 2016
+// Project #4: Rock and Roll Stops the Traffic
+//
+// DigraphExceptions are thrown from some of the member functions in the
+// Digraph and CompactDigraph class templates, so that exception is
+// declared in its own header, so it will be available to any code that
+// includes either of them.
+
+#ifndef DIGRAPHEXCEPTION_HPP
+#define DIGRAPHEXCEPTION_HPP
+
+#include <string>
+
+
+
+class DigraphException
+{
+public:
+    DigraphException(const std::string& reason): reason_{reason} { }
+
+    std::string reason() const { return reason_; }
+
+private:
+    std::string reason_;
+};
+
+
+
+#endif // DIGRAPHEXCEPTION_HPP
+
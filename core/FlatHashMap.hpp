@@ -0,0 +1,343 @@
+// FlatHashMap.hpp
+//
+// ICS 46 Spring 2016
+// Project #4: Rock and Roll Stops the Traffic
+//
+// A FlatHashMap is a hash table that maps keys to values, like a
+// std::unordered_map, but stores its entries inline in a single array
+// rather than in separately allocated nodes.  Collisions are resolved by
+// linear probing, so a lookup usually reads one or two adjacent slots of
+// that array instead of following a chain of pointers.  It's what Digraph
+// and CompactDigraph use to translate vertex numbers into dense indexes.
+//
+// Erasing a key shifts any later entries of the same probe sequence back
+// into the hole it leaves (rather than marking the slot as deleted), so a
+// table whose keys are constantly added and erased never fills up with
+// dead slots.
+//
+// Keys and values must be default-constructible and copyable.  Unlike a
+// std::unordered_map, a FlatHashMap hands out pointers to its values, not
+// iterators; those pointers are invalidated by any insertion or erasure.
+// Its table is allocated by the given Allocator, rebound to its slots.
+
+#ifndef FLATHASHMAP_HPP
+#define FLATHASHMAP_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+
+
+template <
+    typename Key, typename Value, typename Hash = std::hash<Key>,
+    typename Allocator = std::allocator<std::pair<const Key, Value>>>
+class FlatHashMap
+{
+public:
+    // The default constructor initializes an empty FlatHashMap, which
+    // allocates nothing until something is inserted into it.
+    FlatHashMap();
+
+    // This constructor initializes an empty FlatHashMap that allocates
+    // its table with the given allocator.
+    explicit FlatHashMap(const Allocator& allocator);
+
+    // A FlatHashMap can be copied, and moving one takes its table without
+    // copying it, leaving the other empty.
+    FlatHashMap(const FlatHashMap& m) = default;
+    FlatHashMap(FlatHashMap&& m) noexcept;
+    FlatHashMap& operator=(const FlatHashMap& m) = default;
+    FlatHashMap& operator=(FlatHashMap&& m) noexcept;
+
+    // size() returns the number of keys in the map, and empty() returns
+    // true if there are none.
+    std::size_t size() const;
+    bool empty() const;
+
+    // reserve() makes room for the given number of keys, so that
+    // inserting that many doesn't have to grow the table along the way.
+    void reserve(std::size_t count);
+
+    // insert() adds the given key with the given value and returns true,
+    // unless the key is already in the map, in which case it changes
+    // nothing and returns false.
+    bool insert(const Key& key, const Value& value);
+
+    // find() returns a pointer to the value associated with the given
+    // key, or nullptr if the key isn't in the map.
+    Value* find(const Key& key);
+    const Value* find(const Key& key) const;
+
+    // contains() returns true if the given key is in the map.
+    bool contains(const Key& key) const;
+
+    // erase() removes the given key (and its value) from the map and
+    // returns true, or returns false if the key isn't in the map.
+    bool erase(const Key& key);
+
+    // clear() removes every key from the map, keeping its capacity.
+    void clear();
+
+private:
+    struct Slot
+    {
+        Key key;
+        Value value;
+        bool occupied;
+    };
+
+    // home() returns the slot where the probe sequence for the given key
+    // begins.  The hash is scrambled by a multiplication first, since
+    // std::hash is often the identity on integers, and consecutive keys
+    // would otherwise fill runs of consecutive slots.
+    std::size_t home(const Key& key) const;
+
+    // locate() returns the slot holding the given key, or the empty slot
+    // where its probe sequence ends if the key isn't in the map.
+    std::size_t locate(const Key& key) const;
+
+    void rehash(std::size_t capacity);
+
+private:
+    using SlotAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Slot>;
+
+    std::vector<Slot, SlotAllocator> slots_;
+    std::size_t size_;
+    std::size_t mask_;
+    int shift_;
+};
+
+
+
+template <typename Key, typename Value, typename Hash, typename Allocator>
+FlatHashMap<Key, Value, Hash, Allocator>::FlatHashMap()
+    : FlatHashMap{Allocator{}}
+{
+}
+
+
+template <typename Key, typename Value, typename Hash, typename Allocator>
+FlatHashMap<Key, Value, Hash, Allocator>::FlatHashMap(const Allocator& allocator)
+    : slots_{SlotAllocator{allocator}}, size_{0}, mask_{0}, shift_{0}
+{
+}
+
+
+template <typename Key, typename Value, typename Hash, typename Allocator>
+FlatHashMap<Key, Value, Hash, Allocator>::FlatHashMap(FlatHashMap&& m) noexcept
+    : slots_{std::move(m.slots_)}, size_{m.size_}, mask_{m.mask_}, shift_{m.shift_}
+{
+    m.slots_.clear();
+    m.size_ = 0;
+}
+
+
+template <typename Key, typename Value, typename Hash, typename Allocator>
+FlatHashMap<Key, Value, Hash, Allocator>& FlatHashMap<Key, Value, Hash, Allocator>::operator=(
+    FlatHashMap&& m) noexcept
+{
+    if (this != &m)
+    {
+        slots_ = std::move(m.slots_);
+        size_ = m.size_;
+        mask_ = m.mask_;
+        shift_ = m.shift_;
+
+        m.slots_.clear();
+        m.size_ = 0;
+    }
+
+    return *this;
+}
+
+
+template <typename Key, typename Value, typename Hash, typename Allocator>
+std::size_t FlatHashMap<Key, Value, Hash, Allocator>::size() const
+{
+    return size_;
+}
+
+
+template <typename Key, typename Value, typename Hash, typename Allocator>
+bool FlatHashMap<Key, Value, Hash, Allocator>::empty() const
+{
+    return size_ == 0;
+}
+
+
+template <typename Key, typename Value, typename Hash, typename Allocator>
+void FlatHashMap<Key, Value, Hash, Allocator>::reserve(std::size_t count)
+{
+    // The table is kept no more than three-quarters full, since linear
+    // probing slows down sharply beyond that.
+
+    std::size_t capacity = slots_.empty() ? 8 : slots_.size();
+
+    while (capacity / 4 * 3 < count)
+    {
+        capacity *= 2;
+    }
+
+    if (capacity > slots_.size())
+    {
+        rehash(capacity);
+    }
+}
+
+
+template <typename Key, typename Value, typename Hash, typename Allocator>
+bool FlatHashMap<Key, Value, Hash, Allocator>::insert(const Key& key, const Value& value)
+{
+    reserve(size_ + 1);
+
+    std::size_t s = locate(key);
+
+    if (slots_[s].occupied)
+    {
+        return false;
+    }
+
+    slots_[s] = Slot{key, value, true};
+    ++size_;
+    return true;
+}
+
+
+template <typename Key, typename Value, typename Hash, typename Allocator>
+Value* FlatHashMap<Key, Value, Hash, Allocator>::find(const Key& key)
+{
+    if (slots_.empty())
+    {
+        return nullptr;
+    }
+
+    Slot& slot = slots_[locate(key)];
+    return slot.occupied ? &slot.value : nullptr;
+}
+
+
+template <typename Key, typename Value, typename Hash, typename Allocator>
+const Value* FlatHashMap<Key, Value, Hash, Allocator>::find(const Key& key) const
+{
+    if (slots_.empty())
+    {
+        return nullptr;
+    }
+
+    const Slot& slot = slots_[locate(key)];
+    return slot.occupied ? &slot.value : nullptr;
+}
+
+
+template <typename Key, typename Value, typename Hash, typename Allocator>
+bool FlatHashMap<Key, Value, Hash, Allocator>::contains(const Key& key) const
+{
+    return find(key) != nullptr;
+}
+
+
+template <typename Key, typename Value, typename Hash, typename Allocator>
+bool FlatHashMap<Key, Value, Hash, Allocator>::erase(const Key& key)
+{
+    if (slots_.empty())
+    {
+        return false;
+    }
+
+    std::size_t hole = locate(key);
+
+    if (!slots_[hole].occupied)
+    {
+        return false;
+    }
+
+    // Each later entry in the same run of occupied slots moves back into
+    // the hole if the hole lies between its home slot and where it is
+    // now; otherwise, moving it would put it before its home slot, where
+    // lookups would never find it.
+
+    for (std::size_t s = (hole + 1) & mask_; slots_[s].occupied; s = (s + 1) & mask_)
+    {
+        std::size_t h = home(slots_[s].key);
+
+        if (((hole - h) & mask_) < ((s - h) & mask_))
+        {
+            slots_[hole] = slots_[s];
+            hole = s;
+        }
+    }
+
+    slots_[hole].occupied = false;
+    --size_;
+    return true;
+}
+
+
+template <typename Key, typename Value, typename Hash, typename Allocator>
+void FlatHashMap<Key, Value, Hash, Allocator>::clear()
+{
+    for (Slot& slot : slots_)
+    {
+        slot.occupied = false;
+    }
+
+    size_ = 0;
+}
+
+
+template <typename Key, typename Value, typename Hash, typename Allocator>
+std::size_t FlatHashMap<Key, Value, Hash, Allocator>::home(const Key& key) const
+{
+    std::uint64_t scrambled =
+        static_cast<std::uint64_t>(Hash{}(key)) * 0x9E3779B97F4A7C15ull;
+
+    return static_cast<std::size_t>(scrambled >> shift_);
+}
+
+
+template <typename Key, typename Value, typename Hash, typename Allocator>
+std::size_t FlatHashMap<Key, Value, Hash, Allocator>::locate(const Key& key) const
+{
+    std::size_t s = home(key);
+
+    while (slots_[s].occupied && !(slots_[s].key == key))
+    {
+        s = (s + 1) & mask_;
+    }
+
+    return s;
+}
+
+
+template <typename Key, typename Value, typename Hash, typename Allocator>
+void FlatHashMap<Key, Value, Hash, Allocator>::rehash(std::size_t capacity)
+{
+    std::vector<Slot, SlotAllocator> old(
+        capacity, Slot{Key{}, Value{}, false}, slots_.get_allocator());
+    old.swap(slots_);
+
+    mask_ = capacity - 1;
+    shift_ = 64;
+
+    for (std::size_t c = capacity; c > 1; c /= 2)
+    {
+        --shift_;
+    }
+
+    for (const Slot& slot : old)
+    {
+        if (slot.occupied)
+        {
+            slots_[locate(slot.key)] = slot;
+        }
+    }
+}
+
+
+
+#endif // FLATHASHMAP_HPP
+
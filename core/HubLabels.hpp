@@ -0,0 +1,564 @@
+// HubLabels.hpp
+//
+// ICS 46 Spring 2016
+// Project #4: Rock and Roll Stops the Traffic
+//
+// HubLabels answer distance queries on a graph without searching it at
+// all.  Every vertex v has a forward label, listing "hubs" h with the
+// distance from v to each, and a backward label, listing hubs with the
+// distance from each to v, chosen so that for any two vertices s and t,
+// some hub on a shortest path from s to t appears in both the forward
+// label of s and the backward label of t.  The distance from s to t is
+// then the smallest sum of the two distances over the hubs the labels
+// share, which is found by merging the two labels, since each is sorted
+// by hub.
+//
+// The labels are computed by pruned landmark labeling: the vertices are
+// taken in order of importance, most important first, and from each one a
+// Dijkstra search is run forward (adding it to the backward labels of the
+// vertices it reaches) and another backward (adding it to their forward
+// labels).  Each search is pruned at any vertex whose distance the labels
+// computed so far already give, so later, less important vertices are
+// added to fewer and fewer labels.  The better the order, the shorter the
+// labels; the ranks of a ContractionHierarchy, highest first, are a good
+// one.
+//
+// Hubs are identified by their position in that order, and each label is
+// stored compactly in two flat arrays: the hubs as a sequence of bytes,
+// each the difference from the hub before it written in the LEB128
+// variable-length form (seven bits per byte, with the high bit set on
+// every byte but the last), which takes one or two bytes for most hubs
+// rather than four; and the distances as doubles, so they're exact.  A
+// query decodes the hubs as it merges them.  The arrays are the same in
+// memory as on disk, so, like a CompactDigraph's, they can be borrowed
+// from a memory-mapped file and queried in place.  Loading them checks
+// only the sizes of the arrays; each query checks that the two labels it
+// reads lie within the arrays, and never reads past the end of either, so
+// corrupt labels may give wrong distances, but never read out of bounds.
+// verify() decodes every label to find any such corruption.
+//
+// The graph can be of any type that provides these member functions:
+//
+// * int vertexCount() const, returning the number of dense indexes
+// * forEachOutEdge(int index, Visit visit) const, calling visit(toIndex,
+//   einfo) for each edge outgoing from the vertex with the given index
+// * forEachInEdge(int index, Visit visit) const, calling visit(fromIndex,
+//   einfo) for each edge pointing to the vertex with the given index
+
+#ifndef HUBLABELS_HPP
+#define HUBLABELS_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+#include "DigraphException.hpp"
+#include "SearchWorkspace.hpp"
+#include "SharedArray.hpp"
+
+
+
+// A HubLabelArrays holds one direction's labels: for the vertex with index
+// i, its entries are entries labelOffsets[i] through labelOffsets[i + 1] - 1
+// of distances, and its encoded hubs are bytes hubOffsets[i] through
+// hubOffsets[i + 1] - 1 of hubBytes.
+
+struct HubLabelArrays
+{
+    SharedArray<std::uint64_t> labelOffsets;
+    SharedArray<std::uint64_t> hubOffsets;
+    SharedArray<unsigned char> hubBytes;
+    SharedArray<double> distances;
+};
+
+
+
+class HubLabels
+{
+public:
+    // The default constructor initializes empty labels, for no vertices.
+    HubLabels();
+
+    // This constructor initializes labels from their arrays, forward and
+    // backward.  If the arrays' sizes don't agree, a DigraphException is
+    // thrown; the labels themselves are checked by verify().
+    HubLabels(HubLabelArrays forward, HubLabelArrays backward);
+
+    // build() computes the labels of the given graph, whose edge weights
+    // are determined by calling weightFunc on each edge's EdgeInfo and
+    // must not be negative, taking the vertices in the given order, which
+    // lists every vertex index once, most important first.  If the order
+    // isn't a permutation of the indexes, a DigraphException is thrown.
+    template <typename Graph, typename WeightFunc>
+    static HubLabels build(
+        const Graph& graph, WeightFunc&& weightFunc, const std::vector<int>& order);
+
+    // verify() decodes every label, throwing a DigraphException if any
+    // label's offsets are out of order, its hubs are out of range, its
+    // encoded hubs don't match its distances, or any of its distances is
+    // negative or NaN.
+    void verify() const;
+
+    // vertexCount() returns the number of vertices, and entryCount() the
+    // total number of entries in all of their labels, in both directions.
+    int vertexCount() const;
+    std::uint64_t entryCount() const;
+
+    // distance() returns the distance from the vertex with the given start
+    // index to the one with the given end index, or infinity if there is
+    // no path.  If either label lies outside its arrays, a
+    // DigraphException is thrown.
+    double distance(int startIndex, int endIndex) const;
+
+    // These functions return the arrays of each direction, in the form the
+    // constructor takes them, so they can be saved.
+    const HubLabelArrays& forwardArrays() const;
+    const HubLabelArrays& backwardArrays() const;
+
+private:
+    // A LabelReader walks through one label, decoding its hubs.
+    class LabelReader
+    {
+    public:
+        LabelReader(const HubLabelArrays& arrays, int index);
+
+        bool done() const;
+        std::int64_t hub() const;
+        double distance() const;
+        void next();
+
+    private:
+        void decode();
+
+    private:
+        const unsigned char* bytes_;
+        const unsigned char* bytesEnd_;
+        const double* distance_;
+        const double* distancesEnd_;
+        std::int64_t hub_;
+    };
+
+    // A LabelBuilder collects the labels of one direction while they're
+    // being computed, both in their final encoded form and as plain
+    // entries that the pruning queries can read quickly.
+    struct LabelBuilder
+    {
+        explicit LabelBuilder(int vertexCount);
+
+        void add(int index, int hub, double distance);
+        HubLabelArrays finish();
+
+        std::vector<std::vector<std::pair<int, double>>> entries;
+        std::vector<std::vector<unsigned char>> hubBytes;
+    };
+
+    // prunedSearch() runs one of the pruned searches from the vertex at
+    // the given position of the order: forward, adding it to backward
+    // labels (reached), or backward, adding it to forward labels.  rootHubs
+    // holds, for each hub, the root's distance to or from it, according to
+    // the root's own label in the other direction.
+    template <typename Graph, typename WeightFunc>
+    static void prunedSearch(
+        const Graph& graph, WeightFunc& weightFunc, bool forward,
+        int root, int position, const std::vector<double>& rootHubs,
+        LabelBuilder& reached, SearchWorkspace& workspace);
+
+    static void checkArrays(const HubLabelArrays& arrays, int vertexCount);
+    static void verifyArrays(const HubLabelArrays& arrays, int vertexCount);
+
+private:
+    HubLabelArrays forward_;
+    HubLabelArrays backward_;
+};
+
+
+
+inline HubLabels::HubLabels()
+    : forward_{std::vector<std::uint64_t>{0}, std::vector<std::uint64_t>{0}, {}, {}},
+      backward_{std::vector<std::uint64_t>{0}, std::vector<std::uint64_t>{0}, {}, {}}
+{
+}
+
+
+inline HubLabels::HubLabels(HubLabelArrays forward, HubLabelArrays backward)
+    : forward_{std::move(forward)}, backward_{std::move(backward)}
+{
+    if (forward_.labelOffsets.empty()
+        || forward_.labelOffsets.size() != backward_.labelOffsets.size())
+    {
+        throw DigraphException{"inconsistent hub label arrays"};
+    }
+
+    checkArrays(forward_, vertexCount());
+    checkArrays(backward_, vertexCount());
+}
+
+
+inline void HubLabels::verify() const
+{
+    verifyArrays(forward_, vertexCount());
+    verifyArrays(backward_, vertexCount());
+}
+
+
+template <typename Graph, typename WeightFunc>
+HubLabels HubLabels::build(
+    const Graph& graph, WeightFunc&& weightFunc, const std::vector<int>& order)
+{
+    int vertexCount = graph.vertexCount();
+    std::vector<char> seen(vertexCount, 0);
+
+    if (static_cast<int>(order.size()) != vertexCount)
+    {
+        throw DigraphException{"hub order must list every vertex once"};
+    }
+
+    for (int index : order)
+    {
+        if (index < 0 || index >= vertexCount || seen[index])
+        {
+            throw DigraphException{"hub order must list every vertex once"};
+        }
+
+        seen[index] = 1;
+    }
+
+    LabelBuilder forward{vertexCount};
+    LabelBuilder backward{vertexCount};
+
+    SearchWorkspace workspace;
+
+    // The root's own labels are spread into arrays indexed by hub, so that
+    // each pruning query costs one pass over the other vertex's label.
+    const double infinity = std::numeric_limits<double>::infinity();
+    std::vector<double> rootForward(vertexCount, infinity);
+    std::vector<double> rootBackward(vertexCount, infinity);
+
+    for (int position = 0; position < vertexCount; ++position)
+    {
+        int root = order[position];
+
+        for (const std::pair<int, double>& entry : forward.entries[root])
+        {
+            rootForward[entry.first] = entry.second;
+        }
+
+        for (const std::pair<int, double>& entry : backward.entries[root])
+        {
+            rootBackward[entry.first] = entry.second;
+        }
+
+        prunedSearch(graph, weightFunc, true, root, position, rootForward, backward, workspace);
+        prunedSearch(graph, weightFunc, false, root, position, rootBackward, forward, workspace);
+
+        for (const std::pair<int, double>& entry : forward.entries[root])
+        {
+            rootForward[entry.first] = infinity;
+        }
+
+        for (const std::pair<int, double>& entry : backward.entries[root])
+        {
+            rootBackward[entry.first] = infinity;
+        }
+    }
+
+    return HubLabels{forward.finish(), backward.finish()};
+}
+
+
+inline int HubLabels::vertexCount() const
+{
+    return static_cast<int>(forward_.labelOffsets.size()) - 1;
+}
+
+
+inline std::uint64_t HubLabels::entryCount() const
+{
+    return forward_.distances.size() + backward_.distances.size();
+}
+
+
+inline double HubLabels::distance(int startIndex, int endIndex) const
+{
+    LabelReader from{forward_, startIndex};
+    LabelReader to{backward_, endIndex};
+
+    double best = std::numeric_limits<double>::infinity();
+
+    while (!from.done() && !to.done())
+    {
+        if (from.hub() < to.hub())
+        {
+            from.next();
+        }
+        else if (to.hub() < from.hub())
+        {
+            to.next();
+        }
+        else
+        {
+            best = std::min(best, from.distance() + to.distance());
+            from.next();
+            to.next();
+        }
+    }
+
+    return best;
+}
+
+
+inline const HubLabelArrays& HubLabels::forwardArrays() const
+{
+    return forward_;
+}
+
+
+inline const HubLabelArrays& HubLabels::backwardArrays() const
+{
+    return backward_;
+}
+
+
+template <typename Graph, typename WeightFunc>
+void HubLabels::prunedSearch(
+    const Graph& graph, WeightFunc& weightFunc, bool forward,
+    int root, int position, const std::vector<double>& rootHubs,
+    LabelBuilder& reached, SearchWorkspace& workspace)
+{
+    IndexedDaryHeap<4>& heap = workspace.heap();
+
+    workspace.reset(graph.vertexCount());
+    workspace.setEntry(root, 0.0, -1);
+    heap.push(root, 0.0);
+
+    while (!heap.empty())
+    {
+        double base = heap.topKey();
+        int v = heap.pop();
+
+        // If the labels so far already give a path from the root to v (or
+        // from v to the root) that's no longer, so does every vertex
+        // beyond v, and the search needn't go any further this way.
+
+        bool covered = false;
+
+        for (const std::pair<int, double>& entry : reached.entries[v])
+        {
+            if (rootHubs[entry.first] + entry.second <= base)
+            {
+                covered = true;
+                break;
+            }
+        }
+
+        if (covered)
+        {
+            continue;
+        }
+
+        reached.add(v, position, base);
+
+        auto relax =
+            [&](int w, const auto& einfo)
+            {
+                double candidate = base + weightFunc(einfo);
+
+                if (candidate < workspace.distance(w))
+                {
+                    workspace.setEntry(w, candidate, v);
+                    heap.pushOrDecrease(w, candidate);
+                }
+            };
+
+        if (forward)
+        {
+            graph.forEachOutEdge(v, relax);
+        }
+        else
+        {
+            graph.forEachInEdge(v, relax);
+        }
+    }
+}
+
+
+inline void HubLabels::checkArrays(const HubLabelArrays& arrays, int vertexCount)
+{
+    if (arrays.labelOffsets.size() != static_cast<std::size_t>(vertexCount) + 1
+        || arrays.hubOffsets.size() != static_cast<std::size_t>(vertexCount) + 1
+        || arrays.labelOffsets.front() != 0 || arrays.hubOffsets.front() != 0
+        || arrays.labelOffsets.back() != arrays.distances.size()
+        || arrays.hubOffsets.back() != arrays.hubBytes.size())
+    {
+        throw DigraphException{"inconsistent hub label arrays"};
+    }
+}
+
+
+inline void HubLabels::verifyArrays(const HubLabelArrays& arrays, int vertexCount)
+{
+    for (int v = 0; v < vertexCount; ++v)
+    {
+        // The reader checks the label's offsets, and decoding the label
+        // checks that its hubs and distances line up: the reader finds a
+        // hub for every distance, and never one beyond the last vertex.
+
+        std::uint64_t count = 0;
+
+        for (LabelReader reader{arrays, v}; !reader.done(); reader.next())
+        {
+            if (reader.hub() >= vertexCount || !(reader.distance() >= 0.0))
+            {
+                throw DigraphException{"hub label entry out of range"};
+            }
+
+            ++count;
+        }
+
+        if (count != arrays.labelOffsets[v + 1] - arrays.labelOffsets[v])
+        {
+            throw DigraphException{"hub label bytes do not match its distances"};
+        }
+    }
+}
+
+
+
+inline HubLabels::LabelReader::LabelReader(const HubLabelArrays& arrays, int index)
+{
+    std::uint64_t hubBegin = arrays.hubOffsets[index];
+    std::uint64_t hubEnd = arrays.hubOffsets[index + 1];
+    std::uint64_t labelBegin = arrays.labelOffsets[index];
+    std::uint64_t labelEnd = arrays.labelOffsets[index + 1];
+
+    // The offsets aren't checked when the labels are loaded, so they're
+    // checked here instead, which costs a few comparisons per query.
+    if (hubBegin > hubEnd || hubEnd > arrays.hubBytes.size()
+        || labelBegin > labelEnd || labelEnd > arrays.distances.size())
+    {
+        throw DigraphException{"hub label offsets out of order"};
+    }
+
+    bytes_ = arrays.hubBytes.data() + hubBegin;
+    bytesEnd_ = arrays.hubBytes.data() + hubEnd;
+    distance_ = arrays.distances.data() + labelBegin;
+    distancesEnd_ = arrays.distances.data() + labelEnd;
+    hub_ = -1;
+
+    decode();
+}
+
+
+inline bool HubLabels::LabelReader::done() const
+{
+    return hub_ < 0;
+}
+
+
+inline std::int64_t HubLabels::LabelReader::hub() const
+{
+    return hub_;
+}
+
+
+inline double HubLabels::LabelReader::distance() const
+{
+    return *distance_;
+}
+
+
+inline void HubLabels::LabelReader::next()
+{
+    ++distance_;
+    decode();
+}
+
+
+inline void HubLabels::LabelReader::decode()
+{
+    // Each hub is stored as its difference from the one before it, less
+    // one, since the hubs are strictly increasing; the first is stored as
+    // if the one before it were -1.  A label that runs out of bytes or
+    // distances (or ends in the middle of a hub) is done.
+
+    if (bytes_ == bytesEnd_ || distance_ == distancesEnd_)
+    {
+        hub_ = -1;
+        return;
+    }
+
+    std::uint64_t gap = 0;
+    int shift = 0;
+    unsigned char byte;
+
+    do
+    {
+        if (bytes_ == bytesEnd_ || shift > 35)
+        {
+            hub_ = -1;
+            return;
+        }
+
+        byte = *bytes_++;
+        gap |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+        shift += 7;
+    }
+    while (byte & 0x80);
+
+    hub_ += static_cast<std::int64_t>(gap) + 1;
+}
+
+
+
+inline HubLabels::LabelBuilder::LabelBuilder(int vertexCount)
+    : entries(vertexCount), hubBytes(vertexCount)
+{
+}
+
+
+inline void HubLabels::LabelBuilder::add(int index, int hub, double distance)
+{
+    std::uint64_t gap = entries[index].empty()
+        ? hub : hub - entries[index].back().first - 1;
+
+    do
+    {
+        unsigned char byte = gap & 0x7f;
+        gap >>= 7;
+        hubBytes[index].push_back(gap != 0 ? (byte | 0x80) : byte);
+    }
+    while (gap != 0);
+
+    entries[index].emplace_back(hub, distance);
+}
+
+
+inline HubLabelArrays HubLabels::LabelBuilder::finish()
+{
+    std::vector<std::uint64_t> labelOffsets{0};
+    std::vector<std::uint64_t> hubOffsets{0};
+    std::vector<unsigned char> bytes;
+    std::vector<double> distances;
+
+    for (unsigned int v = 0; v < entries.size(); ++v)
+    {
+        for (const std::pair<int, double>& entry : entries[v])
+        {
+            distances.push_back(entry.second);
+        }
+
+        bytes.insert(bytes.end(), hubBytes[v].begin(), hubBytes[v].end());
+
+        labelOffsets.push_back(distances.size());
+        hubOffsets.push_back(bytes.size());
+    }
+
+    return HubLabelArrays{
+        std::move(labelOffsets), std::move(hubOffsets), std::move(bytes), std::move(distances)};
+}
+
+
+
+#endif // HUBLABELS_HPP
+
@@ -0,0 +1,286 @@
+// IndexedDaryHeap.hpp
+//
+// ICS 46 Spring 2016
+// Project #4: Rock and Roll Stops the Traffic
+//
+// An IndexedDaryHeap is a min-heap of "items" (integers between 0 and some
+// fixed capacity, such as the dense vertex indexes of a Digraph), each with
+// a double key.  Unlike std::priority_queue, it knows where each item lives
+// in the heap, so an item's key can be decreased in place instead of
+// pushing a duplicate, which keeps the heap no larger than the number of
+// items in it.  Each node has Arity children; a 4-ary heap is shallower
+// than a binary one and its children share a cache line, which makes it a
+// good fit for Dijkstra's algorithm, where decreaseKey() is much more
+// common than pop().
+
+#ifndef INDEXEDDARYHEAP_HPP
+#define INDEXEDDARYHEAP_HPP
+
+#include <vector>
+
+
+
+template <int Arity = 4>
+class IndexedDaryHeap
+{
+    static_assert(Arity >= 2, "a heap needs at least two children per node");
+
+public:
+    // The default constructor initializes an empty heap with a capacity
+    // of zero items.
+    IndexedDaryHeap();
+
+    // reserveItems() makes room for items 0 through itemCount - 1.  It
+    // never shrinks the capacity and leaves the heap's contents alone.
+    void reserveItems(int itemCount);
+
+    // empty() returns true if there are no items in the heap.
+    bool empty() const;
+
+    // size() returns the number of items in the heap.
+    int size() const;
+
+    // contains() returns true if the given item is in the heap.
+    bool contains(int item) const;
+
+    // push() adds an item that is not already in the heap.
+    void push(int item, double key);
+
+    // decreaseKey() lowers the key of an item that is already in the heap.
+    // The new key must not be larger than the current one.
+    void decreaseKey(int item, double key);
+
+    // pushOrDecrease() pushes the item if it's not in the heap, or lowers
+    // its key if it is and the new key is smaller.  It returns true if the
+    // heap changed.
+    bool pushOrDecrease(int item, double key);
+
+    // top() and topKey() return the item with the smallest key, and that
+    // key.  The heap must not be empty.
+    int top() const;
+    double topKey() const;
+
+    // pop() removes the item with the smallest key and returns it.  The
+    // heap must not be empty.
+    int pop();
+
+    // clear() removes every item from the heap, in time proportional to
+    // the number of items in it rather than to its capacity.
+    void clear();
+
+private:
+    void siftUp(int position);
+    void siftDown(int position);
+    void place(int position, double key, int item);
+
+private:
+    std::vector<double> keys_;
+    std::vector<int> items_;
+    std::vector<int> positions_;
+};
+
+
+
+template <int Arity>
+IndexedDaryHeap<Arity>::IndexedDaryHeap()
+{
+}
+
+
+template <int Arity>
+void IndexedDaryHeap<Arity>::reserveItems(int itemCount)
+{
+    if (itemCount > static_cast<int>(positions_.size()))
+    {
+        positions_.resize(itemCount, -1);
+    }
+}
+
+
+template <int Arity>
+bool IndexedDaryHeap<Arity>::empty() const
+{
+    return items_.empty();
+}
+
+
+template <int Arity>
+int IndexedDaryHeap<Arity>::size() const
+{
+    return static_cast<int>(items_.size());
+}
+
+
+template <int Arity>
+bool IndexedDaryHeap<Arity>::contains(int item) const
+{
+    return positions_[item] >= 0;
+}
+
+
+template <int Arity>
+void IndexedDaryHeap<Arity>::push(int item, double key)
+{
+    keys_.push_back(key);
+    items_.push_back(item);
+    positions_[item] = size() - 1;
+    siftUp(size() - 1);
+}
+
+
+template <int Arity>
+void IndexedDaryHeap<Arity>::decreaseKey(int item, double key)
+{
+    int position = positions_[item];
+    keys_[position] = key;
+    siftUp(position);
+}
+
+
+template <int Arity>
+bool IndexedDaryHeap<Arity>::pushOrDecrease(int item, double key)
+{
+    int position = positions_[item];
+
+    if (position < 0)
+    {
+        push(item, key);
+        return true;
+    }
+    else if (key < keys_[position])
+    {
+        keys_[position] = key;
+        siftUp(position);
+        return true;
+    }
+    else
+    {
+        return false;
+    }
+}
+
+
+template <int Arity>
+int IndexedDaryHeap<Arity>::top() const
+{
+    return items_.front();
+}
+
+
+template <int Arity>
+double IndexedDaryHeap<Arity>::topKey() const
+{
+    return keys_.front();
+}
+
+
+template <int Arity>
+int IndexedDaryHeap<Arity>::pop()
+{
+    int item = items_.front();
+    positions_[item] = -1;
+
+    double lastKey = keys_.back();
+    int lastItem = items_.back();
+
+    keys_.pop_back();
+    items_.pop_back();
+
+    if (!items_.empty())
+    {
+        place(0, lastKey, lastItem);
+        siftDown(0);
+    }
+
+    return item;
+}
+
+
+template <int Arity>
+void IndexedDaryHeap<Arity>::clear()
+{
+    for (int item : items_)
+    {
+        positions_[item] = -1;
+    }
+
+    keys_.clear();
+    items_.clear();
+}
+
+
+template <int Arity>
+void IndexedDaryHeap<Arity>::siftUp(int position)
+{
+    double key = keys_[position];
+    int item = items_[position];
+
+    while (position > 0)
+    {
+        int parent = (position - 1) / Arity;
+
+        if (!(key < keys_[parent]))
+        {
+            break;
+        }
+
+        place(position, keys_[parent], items_[parent]);
+        position = parent;
+    }
+
+    place(position, key, item);
+}
+
+
+template <int Arity>
+void IndexedDaryHeap<Arity>::siftDown(int position)
+{
+    double key = keys_[position];
+    int item = items_[position];
+    int count = size();
+
+    while (true)
+    {
+        int first = position * Arity + 1;
+
+        if (first >= count)
+        {
+            break;
+        }
+
+        int last = first + Arity < count ? first + Arity : count;
+        int smallest = first;
+
+        for (int child = first + 1; child < last; ++child)
+        {
+            if (keys_[child] < keys_[smallest])
+            {
+                smallest = child;
+            }
+        }
+
+        if (!(keys_[smallest] < key))
+        {
+            break;
+        }
+
+        place(position, keys_[smallest], items_[smallest]);
+        position = smallest;
+    }
+
+    place(position, key, item);
+}
+
+
+template <int Arity>
+void IndexedDaryHeap<Arity>::place(int position, double key, int item)
+{
+    keys_[position] = key;
+    items_[position] = item;
+    positions_[item] = position;
+}
+
+
+
+#endif // INDEXEDDARYHEAP_HPP
+
@@ -0,0 +1,618 @@
+// LandmarkTable.hpp
+//
+// ICS 46 Spring 2016
+// Project #4: Rock and Roll Stops the Traffic
+//
+// A LandmarkTable gives an A* search (see ShortestPathSearch::runToward())
+// a sense of direction on a graph that has no geometry, using the "ALT"
+// technique (A*, landmarks and the triangle inequality).  A handful of
+// vertices are chosen as landmarks, and the table records the distance
+// from each landmark to every vertex and from every vertex to each
+// landmark.  For any landmark L, the triangle inequality then bounds the
+// distance from a vertex v to a target t from below in two ways:
+//
+//     d(v, t) >= d(L, t) - d(L, v)
+//     d(v, t) >= d(v, L) - d(t, L)
+//
+// and the largest of these bounds over all the landmarks is a consistent
+// heuristic.  The bounds are best when the landmarks lie "behind" the
+// vertices as seen from the targets, i.e., near the edges of the graph,
+// which is what the selection strategies aim for:
+//
+// * Farthest picks each landmark as far as possible from the ones chosen
+//   before it.
+// * Avoid grows a shortest path tree from a randomly chosen root, weighs
+//   each vertex by how poorly the landmarks chosen so far bound its
+//   distance from the root, and picks a leaf of the subtree that's weighed
+//   most heavily without already containing a landmark, so each landmark
+//   covers the region the others cover worst.
+//
+// The bounds remain valid as long as no edge becomes lighter than it was
+// when the table was built, since every distance can then only grow.  When
+// some edges do get lighter, multiplying the bounds by the smallest ratio
+// of an edge's new weight to its old one keeps them valid, which is what
+// Bound's scale is for.
+//
+// The distances are kept in two flat arrays, one row of landmarkCount()
+// values per vertex, so that the bound for one vertex reads two short
+// rows.  Like a CompactDigraph's arrays, they can be borrowed from a
+// memory-mapped file.
+//
+// The graph can be of any type that provides these member functions:
+//
+// * int vertexCount() const, returning the number of dense indexes
+// * forEachOutEdge(int index, Visit visit) const, calling visit(toIndex,
+//   einfo) for each edge outgoing from the vertex with the given index
+// * forEachInEdge(int index, Visit visit) const, calling visit(fromIndex,
+//   einfo) for each edge pointing to the vertex with the given index
+
+#ifndef LANDMARKTABLE_HPP
+#define LANDMARKTABLE_HPP
+
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <utility>
+#include <vector>
+#include "DigraphException.hpp"
+#include "SharedArray.hpp"
+#include "ShortestPathSearch.hpp"
+
+
+
+enum class LandmarkSelection
+{
+    Farthest,
+    Avoid
+};
+
+
+
+class LandmarkTable
+{
+public:
+    // A Bound is the heuristic for an A* search toward one target vertex:
+    // given a vertex index, it returns the table's lower bound on the
+    // distance from that vertex to the target, multiplied by a scale
+    // between zero and one.
+    class Bound
+    {
+    public:
+        Bound(const LandmarkTable& table, int targetIndex, double scale = 1.0);
+
+        double operator()(int index) const;
+
+    private:
+        const LandmarkTable* table_;
+        int targetIndex_;
+        double scale_;
+    };
+
+public:
+    // The default constructor initializes an empty table, with no
+    // vertices and no landmarks.
+    LandmarkTable();
+
+    // This constructor initializes a table for a graph with the given
+    // number of vertices from its arrays: the index of each landmark, and
+    // the distances from and to the landmarks, one row per vertex.  If
+    // the arrays' sizes don't agree, or a landmark is out of range, a
+    // DigraphException is thrown.  The distances themselves aren't
+    // checked, since that would take time proportional to the size of the
+    // table every time one is loaded, and still couldn't show that they're
+    // the graph's true distances; a table whose arrays came from outside
+    // the program, such as from a file, is trusted to have been built
+    // from the same weights.
+    LandmarkTable(
+        int vertexCount, SharedArray<int> landmarks,
+        SharedArray<double> fromLandmarks, SharedArray<double> toLandmarks);
+
+    // build() chooses up to landmarkCount landmarks in the given graph
+    // with the given strategy and computes their distances.  Edge weights
+    // are determined by calling weightFunc on each edge's EdgeInfo, and
+    // must not be negative.
+    template <typename Graph, typename WeightFunc>
+    static LandmarkTable build(
+        const Graph& graph, WeightFunc&& weightFunc, int landmarkCount,
+        LandmarkSelection selection = LandmarkSelection::Avoid);
+
+    // verify() checks every distance in the table, throwing a
+    // DigraphException if any is negative or NaN.  A distance that's too
+    // large can't be told apart from a true one without searching the
+    // graph again, so it doesn't show that the bounds are lower bounds.
+    void verify() const;
+
+    // vertexCount() returns the number of vertices, and landmarkCount()
+    // the number of landmarks.
+    int vertexCount() const;
+    int landmarkCount() const;
+
+    // landmark() returns the index of the given landmark.
+    int landmark(int which) const;
+
+    // fromLandmark() returns the distance from the given landmark to the
+    // vertex with the given index, and toLandmark() the distance from the
+    // vertex to the landmark; either is infinity if there is no path.
+    double fromLandmark(int which, int index) const;
+    double toLandmark(int which, int index) const;
+
+    // lowerBound() returns the table's lower bound on the distance from
+    // the vertex with index fromIndex to the one with index toIndex.
+    double lowerBound(int fromIndex, int toIndex) const;
+
+    // These functions return the table's arrays, in the form the
+    // constructor takes them, so they can be saved.
+    const SharedArray<int>& landmarkArray() const;
+    const SharedArray<double>& fromLandmarkArray() const;
+    const SharedArray<double>& toLandmarkArray() const;
+
+private:
+    // A ReverseView presents a graph with its edges turned around, so
+    // that a search on it finds the distances to a vertex rather than
+    // from it.
+    template <typename Graph>
+    class ReverseView
+    {
+    public:
+        explicit ReverseView(const Graph& graph)
+            : graph_{&graph}
+        {
+        }
+
+        int vertexCount() const
+        {
+            return graph_->vertexCount();
+        }
+
+        template <typename Visit>
+        void forEachOutEdge(int index, Visit&& visit) const
+        {
+            graph_->forEachInEdge(index, visit);
+        }
+
+    private:
+        const Graph* graph_;
+    };
+
+    // chooseAvoid() returns the next landmark chosen by the Avoid
+    // strategy, given the distances from and to the landmarks chosen so
+    // far (one column per landmark), or -1 if every vertex is a landmark.
+    template <typename Graph, typename WeightFunc>
+    static int chooseAvoid(
+        const Graph& graph, WeightFunc& weightFunc, std::mt19937& random,
+        const std::vector<int>& landmarks,
+        const std::vector<std::vector<double>>& from,
+        const std::vector<std::vector<double>>& to);
+
+    // chooseFarthest() returns the next landmark chosen by the Farthest
+    // strategy, or -1 if every vertex is a landmark.
+    template <typename Graph, typename WeightFunc>
+    static int chooseFarthest(
+        const Graph& graph, WeightFunc& weightFunc,
+        const std::vector<int>& landmarks,
+        const std::vector<std::vector<double>>& from);
+
+    // boundFrom() returns the lower bound on the distance from the vertex
+    // with index v to the one with index t given by the distances from
+    // and to the landmarks, each given as one column per landmark.
+    static double boundFrom(
+        const std::vector<std::vector<double>>& from,
+        const std::vector<std::vector<double>>& to, int v, int t);
+
+    static bool isLandmark(const std::vector<int>& landmarks, int index);
+
+private:
+    int vertexCount_;
+    SharedArray<int> landmarks_;
+    SharedArray<double> fromLandmarks_;
+    SharedArray<double> toLandmarks_;
+};
+
+
+
+inline LandmarkTable::Bound::Bound(const LandmarkTable& table, int targetIndex, double scale)
+    : table_{&table}, targetIndex_{targetIndex}, scale_{scale}
+{
+}
+
+
+inline double LandmarkTable::Bound::operator()(int index) const
+{
+    return table_->lowerBound(index, targetIndex_) * scale_;
+}
+
+
+
+inline LandmarkTable::LandmarkTable()
+    : vertexCount_{0}
+{
+}
+
+
+inline LandmarkTable::LandmarkTable(
+    int vertexCount, SharedArray<int> landmarks,
+    SharedArray<double> fromLandmarks, SharedArray<double> toLandmarks)
+    : vertexCount_{vertexCount},
+      landmarks_{std::move(landmarks)},
+      fromLandmarks_{std::move(fromLandmarks)},
+      toLandmarks_{std::move(toLandmarks)}
+{
+    std::size_t cells = static_cast<std::size_t>(vertexCount_) * landmarks_.size();
+
+    if (vertexCount_ < 0 || fromLandmarks_.size() != cells || toLandmarks_.size() != cells)
+    {
+        throw DigraphException{"inconsistent landmark table arrays"};
+    }
+
+    for (int landmark : landmarks_)
+    {
+        if (landmark < 0 || landmark >= vertexCount_)
+        {
+            throw DigraphException{"landmark out of range"};
+        }
+    }
+}
+
+
+template <typename Graph, typename WeightFunc>
+LandmarkTable LandmarkTable::build(
+    const Graph& graph, WeightFunc&& weightFunc, int landmarkCount,
+    LandmarkSelection selection)
+{
+    int vertexCount = graph.vertexCount();
+
+    // While the landmarks are being chosen, their distances are kept one
+    // column per landmark, which is how they're computed; they're turned
+    // into rows once they're all known.
+
+    std::vector<int> landmarks;
+    std::vector<std::vector<double>> from;
+    std::vector<std::vector<double>> to;
+
+    std::mt19937 random{static_cast<unsigned int>(vertexCount)};
+    ShortestPathSearch search;
+    ReverseView<Graph> reverse{graph};
+
+    while (static_cast<int>(landmarks.size()) < landmarkCount)
+    {
+        int next = selection == LandmarkSelection::Avoid
+            ? chooseAvoid(graph, weightFunc, random, landmarks, from, to)
+            : chooseFarthest(graph, weightFunc, landmarks, from);
+
+        if (next < 0)
+        {
+            break;
+        }
+
+        landmarks.push_back(next);
+        from.emplace_back(vertexCount);
+        to.emplace_back(vertexCount);
+
+        search.run(graph, next, weightFunc);
+
+        for (int v = 0; v < vertexCount; ++v)
+        {
+            from.back()[v] = search.distance(v);
+        }
+
+        search.run(reverse, next, weightFunc);
+
+        for (int v = 0; v < vertexCount; ++v)
+        {
+            to.back()[v] = search.distance(v);
+        }
+    }
+
+    int count = static_cast<int>(landmarks.size());
+    std::vector<double> fromRows(static_cast<std::size_t>(vertexCount) * count);
+    std::vector<double> toRows(static_cast<std::size_t>(vertexCount) * count);
+
+    for (int v = 0; v < vertexCount; ++v)
+    {
+        for (int l = 0; l < count; ++l)
+        {
+            fromRows[static_cast<std::size_t>(v) * count + l] = from[l][v];
+            toRows[static_cast<std::size_t>(v) * count + l] = to[l][v];
+        }
+    }
+
+    return LandmarkTable{vertexCount, std::move(landmarks), std::move(fromRows), std::move(toRows)};
+}
+
+
+inline void LandmarkTable::verify() const
+{
+    for (std::size_t i = 0; i < fromLandmarks_.size(); ++i)
+    {
+        if (!(fromLandmarks_[i] >= 0.0) || !(toLandmarks_[i] >= 0.0))
+        {
+            throw DigraphException{"landmark distance out of range"};
+        }
+    }
+}
+
+
+inline int LandmarkTable::vertexCount() const
+{
+    return vertexCount_;
+}
+
+
+inline int LandmarkTable::landmarkCount() const
+{
+    return static_cast<int>(landmarks_.size());
+}
+
+
+inline int LandmarkTable::landmark(int which) const
+{
+    return landmarks_[which];
+}
+
+
+inline double LandmarkTable::fromLandmark(int which, int index) const
+{
+    return fromLandmarks_[static_cast<std::size_t>(index) * landmarkCount() + which];
+}
+
+
+inline double LandmarkTable::toLandmark(int which, int index) const
+{
+    return toLandmarks_[static_cast<std::size_t>(index) * landmarkCount() + which];
+}
+
+
+inline double LandmarkTable::lowerBound(int fromIndex, int toIndex) const
+{
+    const std::size_t count = landmarks_.size();
+
+    const double* fromV = fromLandmarks_.data() + fromIndex * count;
+    const double* fromT = fromLandmarks_.data() + toIndex * count;
+    const double* toV = toLandmarks_.data() + fromIndex * count;
+    const double* toT = toLandmarks_.data() + toIndex * count;
+
+    // A landmark that can't reach (or be reached from) one of the two
+    // vertices says nothing about the distance between them, and its
+    // infinite distances would otherwise turn into NaNs.
+
+    const double infinity = std::numeric_limits<double>::infinity();
+    double bound = 0.0;
+
+    for (std::size_t l = 0; l < count; ++l)
+    {
+        if (fromT[l] < infinity && fromV[l] < infinity)
+        {
+            bound = std::max(bound, fromT[l] - fromV[l]);
+        }
+
+        if (toV[l] < infinity && toT[l] < infinity)
+        {
+            bound = std::max(bound, toV[l] - toT[l]);
+        }
+    }
+
+    return bound;
+}
+
+
+inline const SharedArray<int>& LandmarkTable::landmarkArray() const
+{
+    return landmarks_;
+}
+
+
+inline const SharedArray<double>& LandmarkTable::fromLandmarkArray() const
+{
+    return fromLandmarks_;
+}
+
+
+inline const SharedArray<double>& LandmarkTable::toLandmarkArray() const
+{
+    return toLandmarks_;
+}
+
+
+template <typename Graph, typename WeightFunc>
+int LandmarkTable::chooseAvoid(
+    const Graph& graph, WeightFunc& weightFunc, std::mt19937& random,
+    const std::vector<int>& landmarks,
+    const std::vector<std::vector<double>>& from,
+    const std::vector<std::vector<double>>& to)
+{
+    int vertexCount = graph.vertexCount();
+
+    if (static_cast<int>(landmarks.size()) >= vertexCount)
+    {
+        return -1;
+    }
+
+    int root = std::uniform_int_distribution<int>{0, vertexCount - 1}(random);
+
+    // The search records the order it settles the vertices in, so their
+    // subtrees can be summed from the leaves up by walking it backward.
+
+    std::vector<int> order;
+    ShortestPathSearch search;
+
+    search.runUntil(
+        graph, root, weightFunc,
+        [&](int settled)
+        {
+            order.push_back(settled);
+            return false;
+        });
+
+    std::vector<double> sizes(vertexCount, 0.0);
+    std::vector<char> covered(vertexCount, 0);
+
+    for (int v : order)
+    {
+        sizes[v] = search.distance(v) - boundFrom(from, to, root, v);
+        covered[v] = isLandmark(landmarks, v);
+    }
+
+    for (auto i = order.rbegin(); i != order.rend(); ++i)
+    {
+        int parent = search.predecessor(*i);
+
+        if (covered[*i])
+        {
+            sizes[*i] = 0.0;
+        }
+
+        if (parent >= 0)
+        {
+            covered[parent] |= covered[*i];
+            sizes[parent] += sizes[*i];
+        }
+    }
+
+    // The descent starts at the heaviest uncovered vertex and follows the
+    // heaviest child at each step, so it needs each vertex's children.
+
+    int heaviest = -1;
+
+    for (int v : order)
+    {
+        if (!covered[v] && (heaviest < 0 || sizes[v] > sizes[heaviest]))
+        {
+            heaviest = v;
+        }
+    }
+
+    if (heaviest < 0)
+    {
+        // The whole tree is covered, so the root can't reach anything
+        // new; any vertex that isn't already a landmark will do.
+        for (int v = 0; v < vertexCount; ++v)
+        {
+            if (!isLandmark(landmarks, v))
+            {
+                return v;
+            }
+        }
+
+        return -1;
+    }
+
+    std::vector<int> heaviestChild(vertexCount, -1);
+
+    for (int v : order)
+    {
+        int parent = search.predecessor(v);
+
+        if (parent >= 0 && !covered[v]
+            && (heaviestChild[parent] < 0 || sizes[v] > sizes[heaviestChild[parent]]))
+        {
+            heaviestChild[parent] = v;
+        }
+    }
+
+    int leaf = heaviest;
+
+    while (heaviestChild[leaf] >= 0)
+    {
+        leaf = heaviestChild[leaf];
+    }
+
+    return leaf;
+}
+
+
+template <typename Graph, typename WeightFunc>
+int LandmarkTable::chooseFarthest(
+    const Graph& graph, WeightFunc& weightFunc,
+    const std::vector<int>& landmarks,
+    const std::vector<std::vector<double>>& from)
+{
+    int vertexCount = graph.vertexCount();
+
+    if (static_cast<int>(landmarks.size()) >= vertexCount)
+    {
+        return -1;
+    }
+
+    // The first landmark is the vertex farthest from the one with index
+    // zero; each one after that is the vertex farthest from its nearest
+    // landmark, which is infinitely far if no landmark can reach it.
+
+    if (landmarks.empty())
+    {
+        ShortestPathSearch search;
+        search.run(graph, 0, weightFunc);
+
+        int farthest = 0;
+
+        for (int v = 0; v < vertexCount; ++v)
+        {
+            if (search.reached(v) && search.distance(v) > search.distance(farthest))
+            {
+                farthest = v;
+            }
+        }
+
+        return farthest;
+    }
+
+    int farthest = -1;
+    double farthestDistance = -1.0;
+
+    for (int v = 0; v < vertexCount; ++v)
+    {
+        if (isLandmark(landmarks, v))
+        {
+            continue;
+        }
+
+        double nearest = std::numeric_limits<double>::infinity();
+
+        for (const std::vector<double>& column : from)
+        {
+            nearest = std::min(nearest, column[v]);
+        }
+
+        if (nearest > farthestDistance)
+        {
+            farthest = v;
+            farthestDistance = nearest;
+        }
+    }
+
+    return farthest;
+}
+
+
+inline double LandmarkTable::boundFrom(
+    const std::vector<std::vector<double>>& from,
+    const std::vector<std::vector<double>>& to, int v, int t)
+{
+    const double infinity = std::numeric_limits<double>::infinity();
+    double bound = 0.0;
+
+    for (unsigned int l = 0; l < from.size(); ++l)
+    {
+        if (from[l][t] < infinity && from[l][v] < infinity)
+        {
+            bound = std::max(bound, from[l][t] - from[l][v]);
+        }
+
+        if (to[l][v] < infinity && to[l][t] < infinity)
+        {
+            bound = std::max(bound, to[l][v] - to[l][t]);
+        }
+    }
+
+    return bound;
+}
+
+
+inline bool LandmarkTable::isLandmark(const std::vector<int>& landmarks, int index)
+{
+    return std::find(landmarks.begin(), landmarks.end(), index) != landmarks.end();
+}
+
+
+
+#endif // LANDMARKTABLE_HPP
+
@@ -0,0 +1,219 @@
+// MonotonicArena.hpp
+//
+// ICS 46 Spring 2016
+// Project #4: Rock and Roll Stops the Traffic
+//
+// A MonotonicArena hands out memory by bumping a pointer through large
+// chunks that it allocates as it goes, and never takes any of it back
+// individually; everything is released at once, when the arena is
+// released or destroyed.  That makes allocation nearly free and
+// deallocation entirely free, which suits a data structure that is built,
+// used and then thrown away as a whole, like a what-if Digraph built for
+// a single request.
+//
+// An ArenaAllocator is a standard allocator that allocates from a
+// MonotonicArena, so it can be given to a Digraph (or any standard
+// container) as its Allocator.  The arena must outlive everything that
+// allocates from it, and releasing the arena while objects in it are
+// still in use leaves them dangling.
+
+#ifndef MONOTONICARENA_HPP
+#define MONOTONICARENA_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+
+
+class MonotonicArena
+{
+public:
+    // The constructor initializes an arena that allocates memory in
+    // chunks of at least the given size.  Nothing is allocated until the
+    // first request.
+    explicit MonotonicArena(std::size_t chunkSize = 1 << 16);
+
+    // An arena can't be copied, since the memory it hands out belongs to
+    // it alone.
+    MonotonicArena(const MonotonicArena&) = delete;
+    MonotonicArena& operator=(const MonotonicArena&) = delete;
+
+    // The destructor releases all of the arena's memory.
+    ~MonotonicArena();
+
+    // allocate() returns a block of the given size, aligned to the given
+    // alignment (which must be a power of two).
+    void* allocate(std::size_t size, std::size_t alignment);
+
+    // release() frees every block the arena has handed out, at a cost
+    // proportional to the number of chunks rather than blocks, and lets
+    // the arena be used again.
+    void release();
+
+    // bytesAllocated() returns the total size of the chunks the arena
+    // currently holds.
+    std::size_t bytesAllocated() const;
+
+private:
+    std::size_t chunkSize_;
+    std::vector<void*> chunks_;
+    std::uintptr_t next_;
+    std::uintptr_t end_;
+    std::size_t bytesAllocated_;
+};
+
+
+
+template <typename T>
+class ArenaAllocator
+{
+public:
+    using value_type = T;
+
+    // Containers that are moved take their allocators along with them,
+    // so moving a whole Digraph never copies its contents.
+    using propagate_on_container_move_assignment = std::true_type;
+
+    // The constructor initializes an allocator that allocates from the
+    // given arena.
+    explicit ArenaAllocator(MonotonicArena& arena) noexcept;
+
+    // This constructor converts an allocator for one type into an
+    // allocator for another that shares its arena.
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& a) noexcept;
+
+    // allocate() returns room for count objects of type T from the arena,
+    // and deallocate() does nothing, since the arena frees everything
+    // at once.
+    T* allocate(std::size_t count);
+    void deallocate(T* p, std::size_t count) noexcept;
+
+    // arena() returns the arena this allocator allocates from.
+    MonotonicArena& arena() const noexcept;
+
+private:
+    MonotonicArena* arena_;
+};
+
+
+template <typename T, typename U>
+bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) noexcept;
+
+template <typename T, typename U>
+bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) noexcept;
+
+
+
+inline MonotonicArena::MonotonicArena(std::size_t chunkSize)
+    : chunkSize_{chunkSize}, next_{0}, end_{0}, bytesAllocated_{0}
+{
+}
+
+
+inline MonotonicArena::~MonotonicArena()
+{
+    release();
+}
+
+
+inline void* MonotonicArena::allocate(std::size_t size, std::size_t alignment)
+{
+    std::uintptr_t start = (next_ + alignment - 1) & ~static_cast<std::uintptr_t>(alignment - 1);
+
+    if (next_ == 0 || start + size > end_)
+    {
+        // Requests bigger than a chunk get a chunk of their own, so a
+        // large one never wastes the rest of a normal chunk.
+        std::size_t chunkSize = size + alignment > chunkSize_ ? size + alignment : chunkSize_;
+        void* chunk = ::operator new(chunkSize);
+
+        chunks_.push_back(chunk);
+        bytesAllocated_ += chunkSize;
+
+        next_ = reinterpret_cast<std::uintptr_t>(chunk);
+        end_ = next_ + chunkSize;
+        start = (next_ + alignment - 1) & ~static_cast<std::uintptr_t>(alignment - 1);
+    }
+
+    next_ = start + size;
+    return reinterpret_cast<void*>(start);
+}
+
+
+inline void MonotonicArena::release()
+{
+    for (void* chunk : chunks_)
+    {
+        ::operator delete(chunk);
+    }
+
+    chunks_.clear();
+    next_ = 0;
+    end_ = 0;
+    bytesAllocated_ = 0;
+}
+
+
+inline std::size_t MonotonicArena::bytesAllocated() const
+{
+    return bytesAllocated_;
+}
+
+
+
+template <typename T>
+ArenaAllocator<T>::ArenaAllocator(MonotonicArena& arena) noexcept
+    : arena_{&arena}
+{
+}
+
+
+template <typename T>
+template <typename U>
+ArenaAllocator<T>::ArenaAllocator(const ArenaAllocator<U>& a) noexcept
+    : arena_{&a.arena()}
+{
+}
+
+
+template <typename T>
+T* ArenaAllocator<T>::allocate(std::size_t count)
+{
+    return static_cast<T*>(arena_->allocate(count * sizeof(T), alignof(T)));
+}
+
+
+template <typename T>
+void ArenaAllocator<T>::deallocate(T*, std::size_t) noexcept
+{
+}
+
+
+template <typename T>
+MonotonicArena& ArenaAllocator<T>::arena() const noexcept
+{
+    return *arena_;
+}
+
+
+template <typename T, typename U>
+bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) noexcept
+{
+    return &a.arena() == &b.arena();
+}
+
+
+template <typename T, typename U>
+bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) noexcept
+{
+    return !(a == b);
+}
+
+
+
+#endif // MONOTONICARENA_HPP
+
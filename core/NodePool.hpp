@@ -0,0 +1,267 @@
+// NodePool.hpp
+//
+// ICS 46 Spring 2016
+// Project #4: Rock and Roll Stops the Traffic
+//
+// A NodePool hands out fixed-size blocks of memory ("nodes"), carving them
+// out of large chunks and keeping the ones given back on a free list, so
+// allocating or freeing a node takes a couple of pointer moves instead of
+// a trip through malloc.  Unlike a MonotonicArena, it reuses freed nodes,
+// so it suits a data structure that keeps changing, such as a Digraph
+// whose edges are constantly added and removed.  All of its memory is
+// released at once when it's released or destroyed.
+//
+// A PoolAllocator is a standard allocator that takes each request that
+// fits in one of its pool's nodes from the pool, and passes any larger
+// one (such as a whole std::vector's array) on to operator new.
+
+#ifndef NODEPOOL_HPP
+#define NODEPOOL_HPP
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+
+
+class NodePool
+{
+public:
+    // The constructor initializes a pool of nodes of (at least) the given
+    // size, allocated the given number at a time.  Nothing is allocated
+    // until the first request.
+    explicit NodePool(std::size_t nodeSize, std::size_t nodesPerChunk = 1024);
+
+    // A pool can't be copied, since the memory it hands out belongs to
+    // it alone.
+    NodePool(const NodePool&) = delete;
+    NodePool& operator=(const NodePool&) = delete;
+
+    // The destructor releases all of the pool's memory.
+    ~NodePool();
+
+    // nodeSize() returns the size of each node, which is the size given
+    // to the constructor, rounded up so that every node is suitably
+    // aligned for any type.
+    std::size_t nodeSize() const;
+
+    // allocate() returns a node, and deallocate() gives one back to the
+    // pool, where the next allocate() will find it.
+    void* allocate();
+    void deallocate(void* node);
+
+    // release() frees every node the pool has handed out, at a cost
+    // proportional to the number of chunks rather than nodes, and lets
+    // the pool be used again.
+    void release();
+
+private:
+    // A free node holds a pointer to the next one.
+    struct FreeNode
+    {
+        FreeNode* next;
+    };
+
+    void addChunk();
+
+private:
+    std::size_t nodeSize_;
+    std::size_t nodesPerChunk_;
+    std::vector<void*> chunks_;
+    FreeNode* free_;
+};
+
+
+
+template <typename T>
+class PoolAllocator
+{
+public:
+    using value_type = T;
+
+    // Containers that are moved take their allocators along with them,
+    // so moving a whole Digraph never copies its contents.
+    using propagate_on_container_move_assignment = std::true_type;
+
+    // The constructor initializes an allocator that allocates from the
+    // given pool.
+    explicit PoolAllocator(NodePool& pool) noexcept;
+
+    // This constructor converts an allocator for one type into an
+    // allocator for another that shares its pool.
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U>& a) noexcept;
+
+    // allocate() returns room for count objects of type T, from the pool
+    // if they fit in a node, and deallocate() gives it back to wherever
+    // it came from.
+    T* allocate(std::size_t count);
+    void deallocate(T* p, std::size_t count) noexcept;
+
+    // pool() returns the pool this allocator allocates from.
+    NodePool& pool() const noexcept;
+
+private:
+    bool fits(std::size_t count) const noexcept;
+
+private:
+    NodePool* pool_;
+};
+
+
+template <typename T, typename U>
+bool operator==(const PoolAllocator<T>& a, const PoolAllocator<U>& b) noexcept;
+
+template <typename T, typename U>
+bool operator!=(const PoolAllocator<T>& a, const PoolAllocator<U>& b) noexcept;
+
+
+
+inline NodePool::NodePool(std::size_t nodeSize, std::size_t nodesPerChunk)
+    : nodeSize_{nodeSize}, nodesPerChunk_{nodesPerChunk}, free_{nullptr}
+{
+    const std::size_t alignment = alignof(std::max_align_t);
+
+    if (nodeSize_ < sizeof(FreeNode))
+    {
+        nodeSize_ = sizeof(FreeNode);
+    }
+
+    nodeSize_ = (nodeSize_ + alignment - 1) / alignment * alignment;
+}
+
+
+inline NodePool::~NodePool()
+{
+    release();
+}
+
+
+inline std::size_t NodePool::nodeSize() const
+{
+    return nodeSize_;
+}
+
+
+inline void* NodePool::allocate()
+{
+    if (free_ == nullptr)
+    {
+        addChunk();
+    }
+
+    FreeNode* node = free_;
+    free_ = node->next;
+    return node;
+}
+
+
+inline void NodePool::deallocate(void* node)
+{
+    FreeNode* freed = static_cast<FreeNode*>(node);
+    freed->next = free_;
+    free_ = freed;
+}
+
+
+inline void NodePool::release()
+{
+    for (void* chunk : chunks_)
+    {
+        ::operator delete(chunk);
+    }
+
+    chunks_.clear();
+    free_ = nullptr;
+}
+
+
+inline void NodePool::addChunk()
+{
+    char* chunk = static_cast<char*>(::operator new(nodeSize_ * nodesPerChunk_));
+    chunks_.push_back(chunk);
+
+    // The nodes are pushed onto the free list backward, so that they're
+    // handed out in address order.
+
+    for (std::size_t i = nodesPerChunk_; i > 0; --i)
+    {
+        deallocate(chunk + (i - 1) * nodeSize_);
+    }
+}
+
+
+
+template <typename T>
+PoolAllocator<T>::PoolAllocator(NodePool& pool) noexcept
+    : pool_{&pool}
+{
+}
+
+
+template <typename T>
+template <typename U>
+PoolAllocator<T>::PoolAllocator(const PoolAllocator<U>& a) noexcept
+    : pool_{&a.pool()}
+{
+}
+
+
+template <typename T>
+T* PoolAllocator<T>::allocate(std::size_t count)
+{
+    if (fits(count))
+    {
+        return static_cast<T*>(pool_->allocate());
+    }
+
+    return static_cast<T*>(::operator new(count * sizeof(T)));
+}
+
+
+template <typename T>
+void PoolAllocator<T>::deallocate(T* p, std::size_t count) noexcept
+{
+    if (fits(count))
+    {
+        pool_->deallocate(p);
+    }
+    else
+    {
+        ::operator delete(p);
+    }
+}
+
+
+template <typename T>
+NodePool& PoolAllocator<T>::pool() const noexcept
+{
+    return *pool_;
+}
+
+
+template <typename T>
+bool PoolAllocator<T>::fits(std::size_t count) const noexcept
+{
+    return count * sizeof(T) <= pool_->nodeSize() && alignof(T) <= alignof(std::max_align_t);
+}
+
+
+template <typename T, typename U>
+bool operator==(const PoolAllocator<T>& a, const PoolAllocator<U>& b) noexcept
+{
+    return &a.pool() == &b.pool();
+}
+
+
+template <typename T, typename U>
+bool operator!=(const PoolAllocator<T>& a, const PoolAllocator<U>& b) noexcept
+{
+    return !(a == b);
+}
+
+
+
+#endif // NODEPOOL_HPP
+
@@ -0,0 +1,162 @@
+// SearchWorkspace.hpp
+//
+// ICS 46 Spring 2016
+// Project #4: Rock and Roll Stops the Traffic
+//
+// A SearchWorkspace holds the memory a shortest path search works in: a
+// tentative distance and a predecessor for each dense vertex index, and
+// the heap of vertices waiting to be settled.  It's meant to be kept and
+// reused from one search to the next.
+//
+// Rather than refilling every distance and predecessor before each search,
+// which would cost time proportional to the size of the graph even when
+// the search only visits a handful of vertices, each entry is stamped with
+// the "epoch" (the number of the search) that last wrote it.  reset()
+// starts a new epoch, which makes every entry with an older stamp read as
+// unreached, so it costs constant time, and a search only ever writes the
+// entries of vertices it actually touches.
+
+#ifndef SEARCHWORKSPACE_HPP
+#define SEARCHWORKSPACE_HPP
+
+#include <limits>
+#include <vector>
+#include "IndexedDaryHeap.hpp"
+
+
+
+class SearchWorkspace
+{
+public:
+    // The default constructor initializes a workspace with room for no
+    // vertices; reset() makes room as needed.
+    SearchWorkspace();
+
+    // reset() prepares the workspace for a new search over a graph with
+    // the given number of vertices, forgetting the results of the last
+    // one.  It takes constant time unless the workspace has to grow (or,
+    // once every four billion or so searches, when the epoch counter
+    // wraps around and the stamps have to be cleared).
+    void reset(int vertexCount);
+
+    // vertexCount() returns the vertex count given to the last reset().
+    int vertexCount() const;
+
+    // touched() returns true if the entry for the given index has been
+    // written since the last reset().
+    bool touched(int index) const;
+
+    // distance() returns the tentative distance to the vertex with the
+    // given index, or infinity if it hasn't been touched.
+    double distance(int index) const;
+
+    // predecessor() returns the predecessor of the vertex with the given
+    // index, or -1 if it hasn't been touched.
+    int predecessor(int index) const;
+
+    // setEntry() records the distance and predecessor of the vertex with
+    // the given index.
+    void setEntry(int index, double distance, int predecessor);
+
+    // heap() returns the heap of vertices waiting to be settled, which
+    // reset() empties.
+    IndexedDaryHeap<4>& heap();
+
+private:
+    // Keeping the three fields of an entry together means that the stamp
+    // check and the distance it guards are read from the same cache line.
+    struct Entry
+    {
+        double distance;
+        int predecessor;
+        unsigned int stamp;
+    };
+
+    std::vector<Entry> entries_;
+    IndexedDaryHeap<4> heap_;
+    unsigned int epoch_;
+    int vertexCount_;
+};
+
+
+
+inline SearchWorkspace::SearchWorkspace()
+    : epoch_{0}, vertexCount_{0}
+{
+}
+
+
+inline void SearchWorkspace::reset(int vertexCount)
+{
+    if (vertexCount > static_cast<int>(entries_.size()))
+    {
+        entries_.resize(vertexCount, Entry{0.0, -1, 0});
+    }
+
+    ++epoch_;
+
+    if (epoch_ == 0)
+    {
+        for (Entry& entry : entries_)
+        {
+            entry.stamp = 0;
+        }
+
+        epoch_ = 1;
+    }
+
+    heap_.clear();
+    heap_.reserveItems(vertexCount);
+    vertexCount_ = vertexCount;
+}
+
+
+inline int SearchWorkspace::vertexCount() const
+{
+    return vertexCount_;
+}
+
+
+inline bool SearchWorkspace::touched(int index) const
+{
+    return entries_[index].stamp == epoch_;
+}
+
+
+inline double SearchWorkspace::distance(int index) const
+{
+    const Entry& entry = entries_[index];
+
+    if (entry.stamp == epoch_)
+    {
+        return entry.distance;
+    }
+    else
+    {
+        return std::numeric_limits<double>::infinity();
+    }
+}
+
+
+inline int SearchWorkspace::predecessor(int index) const
+{
+    const Entry& entry = entries_[index];
+    return entry.stamp == epoch_ ? entry.predecessor : -1;
+}
+
+
+inline void SearchWorkspace::setEntry(int index, double distance, int predecessor)
+{
+    entries_[index] = Entry{distance, predecessor, epoch_};
+}
+
+
+inline IndexedDaryHeap<4>& SearchWorkspace::heap()
+{
+    return heap_;
+}
+
+
+
+#endif // SEARCHWORKSPACE_HPP
+
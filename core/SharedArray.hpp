@@ -0,0 +1,257 @@
+// SharedArray.hpp
+//
+// ICS 46 Spring 2016
+// Project #4: Rock and Roll Stops the Traffic
+//
+// A SharedArray is a read-mostly array of values that either owns its
+// elements (in a std::vector) or borrows them from memory that belongs to
+// something else, such as a file mapped into memory.  A borrowing
+// SharedArray holds a std::shared_ptr to the owner of that memory, so the
+// memory stays valid for as long as any SharedArray borrowing it exists;
+// several processes mapping the same file then share the same pages.
+//
+// Reading from a SharedArray looks the same either way.  Writing to an
+// element of a borrowing SharedArray first copies all of its elements into
+// a std::vector of its own (i.e., copy-on-write), since borrowed memory is
+// never modified.
+
+#ifndef SHAREDARRAY_HPP
+#define SHAREDARRAY_HPP
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+
+template <typename T>
+class SharedArray
+{
+public:
+    // The default constructor initializes an empty SharedArray.
+    SharedArray();
+
+    // This constructor initializes a SharedArray that owns the given
+    // elements.  It's deliberately not explicit, so a std::vector can be
+    // passed wherever a SharedArray is expected.
+    SharedArray(std::vector<T> elements);
+
+    // This constructor initializes a SharedArray that borrows size
+    // elements starting at data, which remain valid as long as owner
+    // exists.  Only trivially copyable types can be borrowed this way,
+    // since their elements are simply bytes in someone else's memory.
+    SharedArray(const T* data, std::size_t size, std::shared_ptr<const void> owner);
+
+    SharedArray(const SharedArray& s);
+    SharedArray(SharedArray&& s) noexcept;
+
+    SharedArray& operator=(const SharedArray& s);
+    SharedArray& operator=(SharedArray&& s) noexcept;
+
+    // size() and empty() return the number of elements, and whether there
+    // are none.
+    std::size_t size() const;
+    bool empty() const;
+
+    // data(), begin() and end() give read-only access to the elements.
+    const T* data() const;
+    const T* begin() const;
+    const T* end() const;
+
+    // operator[], front() and back() return elements by position.
+    const T& operator[](std::size_t position) const;
+    const T& front() const;
+    const T& back() const;
+
+    // borrowed() returns true if the elements belong to someone else.
+    bool borrowed() const;
+
+    // mutableAt() returns a modifiable reference to the element at the
+    // given position, first copying the elements if they're borrowed.
+    T& mutableAt(std::size_t position);
+
+private:
+    void resetToOwned();
+
+private:
+    std::vector<T> owned_;
+    std::shared_ptr<const void> owner_;
+    const T* data_;
+    std::size_t size_;
+};
+
+
+
+template <typename T>
+SharedArray<T>::SharedArray()
+    : data_{nullptr}, size_{0}
+{
+}
+
+
+template <typename T>
+SharedArray<T>::SharedArray(std::vector<T> elements)
+    : owned_{std::move(elements)}
+{
+    resetToOwned();
+}
+
+
+template <typename T>
+SharedArray<T>::SharedArray(
+    const T* data, std::size_t size, std::shared_ptr<const void> owner)
+    : owner_{std::move(owner)}, data_{data}, size_{size}
+{
+    static_assert(
+        std::is_trivially_copyable<T>::value,
+        "only trivially copyable elements can be borrowed");
+}
+
+
+template <typename T>
+SharedArray<T>::SharedArray(const SharedArray& s)
+    : owned_{s.owned_}, owner_{s.owner_}, data_{s.data_}, size_{s.size_}
+{
+    if (!owner_)
+    {
+        resetToOwned();
+    }
+}
+
+
+template <typename T>
+SharedArray<T>::SharedArray(SharedArray&& s) noexcept
+    : owned_{std::move(s.owned_)}, owner_{std::move(s.owner_)},
+      data_{s.data_}, size_{s.size_}
+{
+    // Moving a std::vector keeps its elements where they are, so data_
+    // remains valid either way.
+    s.owned_.clear();
+    s.owner_.reset();
+    s.data_ = nullptr;
+    s.size_ = 0;
+}
+
+
+template <typename T>
+SharedArray<T>& SharedArray<T>::operator=(const SharedArray& s)
+{
+    if (this != &s)
+    {
+        *this = SharedArray{s};
+    }
+
+    return *this;
+}
+
+
+template <typename T>
+SharedArray<T>& SharedArray<T>::operator=(SharedArray&& s) noexcept
+{
+    if (this != &s)
+    {
+        owned_ = std::move(s.owned_);
+        owner_ = std::move(s.owner_);
+        data_ = s.data_;
+        size_ = s.size_;
+
+        s.owned_.clear();
+        s.owner_.reset();
+        s.data_ = nullptr;
+        s.size_ = 0;
+    }
+
+    return *this;
+}
+
+
+template <typename T>
+std::size_t SharedArray<T>::size() const
+{
+    return size_;
+}
+
+
+template <typename T>
+bool SharedArray<T>::empty() const
+{
+    return size_ == 0;
+}
+
+
+template <typename T>
+const T* SharedArray<T>::data() const
+{
+    return data_;
+}
+
+
+template <typename T>
+const T* SharedArray<T>::begin() const
+{
+    return data_;
+}
+
+
+template <typename T>
+const T* SharedArray<T>::end() const
+{
+    return data_ + size_;
+}
+
+
+template <typename T>
+const T& SharedArray<T>::operator[](std::size_t position) const
+{
+    return data_[position];
+}
+
+
+template <typename T>
+const T& SharedArray<T>::front() const
+{
+    return data_[0];
+}
+
+
+template <typename T>
+const T& SharedArray<T>::back() const
+{
+    return data_[size_ - 1];
+}
+
+
+template <typename T>
+bool SharedArray<T>::borrowed() const
+{
+    return static_cast<bool>(owner_);
+}
+
+
+template <typename T>
+T& SharedArray<T>::mutableAt(std::size_t position)
+{
+    if (owner_)
+    {
+        owned_.assign(data_, data_ + size_);
+        owner_.reset();
+        resetToOwned();
+    }
+
+    return owned_[position];
+}
+
+
+template <typename T>
+void SharedArray<T>::resetToOwned()
+{
+    data_ = owned_.data();
+    size_ = owned_.size();
+}
+
+
+
+#endif // SHAREDARRAY_HPP
+
@@ -0,0 +1,349 @@
+// ShortestPathSearch.hpp
+//
+// ICS 46 Spring 2016
+// Project #4: Rock and Roll Stops the Traffic
+//
+// A ShortestPathSearch runs Dijkstra's Shortest Path Algorithm over the
+// dense vertex indexes of a graph, keeping its results in flat arrays
+// indexed the same way.  It's the engine behind findShortestPaths() in
+// both Digraph and CompactDigraph, and it can be used directly by code
+// that wants distances, or that wants to avoid building a std::map.
+//
+// The graph can be of any type that provides these member functions:
+//
+// * int vertexCount() const, returning the number of dense indexes
+// * forEachOutEdge(int index, Visit visit) const, calling visit(toIndex,
+//   einfo) for each edge outgoing from the vertex with the given index
+//
+// The search is a template on the type of the weight function, so when
+// it's given a lambda or a function object, the weight computation can
+// be inlined into the relaxation loop.
+//
+// A search toward a single target can also be run as an A* search, given
+// a heuristic that bounds from below the distance from each vertex to the
+// target.  The vertices are then settled in order of their distance from
+// the start plus their bound, which draws the search toward the target
+// instead of letting it spread out evenly in every direction.
+//
+// A search keeps its distances, predecessors and heap in a SearchWorkspace,
+// which it either owns or borrows from its caller.  Either way, starting
+// a new run costs constant time rather than time proportional to the size
+// of the graph, so a ShortestPathSearch (or a SearchWorkspace) that is
+// kept across many short searches makes each of them cheap.
+
+#ifndef SHORTESTPATHSEARCH_HPP
+#define SHORTESTPATHSEARCH_HPP
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <vector>
+#include "SearchWorkspace.hpp"
+
+
+
+// A ShortestPath describes one path found by a search: the vertex numbers
+// along it (starting with the start vertex and ending with the end vertex),
+// the EdgeInfo of each edge between consecutive vertices (so there is one
+// fewer of these than there are vertices), and its total cost.  If there
+// is no path, vertices and edges are empty and totalCost is infinity.
+
+template <typename EdgeInfo>
+struct ShortestPath
+{
+    std::vector<int> vertices;
+    std::vector<EdgeInfo> edges;
+    double totalCost;
+};
+
+
+
+class ShortestPathSearch
+{
+public:
+    // The default constructor initializes a search that owns its own
+    // SearchWorkspace.
+    ShortestPathSearch();
+
+    // This constructor initializes a search that works in the given
+    // SearchWorkspace, which must outlive it.  The workspace holds the
+    // results of the search's last run, until the next one.
+    explicit ShortestPathSearch(SearchWorkspace& workspace);
+
+    // A search can't be copied, since it may be borrowing its workspace.
+    ShortestPathSearch(const ShortestPathSearch&) = delete;
+    ShortestPathSearch& operator=(const ShortestPathSearch&) = delete;
+
+    // run() finds the shortest paths from the vertex with the given
+    // index to every vertex reachable from it, replacing the results of
+    // any previous run.  Edge weights are determined by calling
+    // weightFunc on each edge's EdgeInfo, and must not be negative.
+    //
+    // If a target index is given, the search stops as soon as the
+    // shortest path to the target is known, so only the results for
+    // settled vertices (which include the target and every vertex on its
+    // path) are final.
+    template <typename Graph, typename WeightFunc>
+    void run(
+        const Graph& graph, int startIndex, WeightFunc&& weightFunc,
+        int targetIndex = -1);
+
+    // runUntil() is like run(), except that it calls shouldStop with the
+    // index of each vertex as it's settled, and stops the search as soon
+    // as shouldStop returns true.  This allows a search to stop once a
+    // whole set of targets has been settled.
+    template <typename Graph, typename WeightFunc, typename StopFunc>
+    void runUntil(
+        const Graph& graph, int startIndex, WeightFunc&& weightFunc,
+        StopFunc&& shouldStop);
+
+    // runToward() finds the shortest path from the vertex with the given
+    // start index to the vertex with the given target index using A*,
+    // replacing the results of any previous run.  heuristic(index) must
+    // return a lower bound on the distance from the vertex with the given
+    // index to the target that is consistent: for every edge from v to w,
+    // heuristic(v) can exceed heuristic(w) by no more than the edge's
+    // weight.  A heuristic that always returns zero makes this the same
+    // as run() with a target.  As with run(), only the results for
+    // settled vertices are final.
+    template <typename Graph, typename WeightFunc, typename Heuristic>
+    void runToward(
+        const Graph& graph, int startIndex, int targetIndex,
+        WeightFunc&& weightFunc, Heuristic&& heuristic);
+
+    // settledCount() returns the number of vertices whose shortest paths
+    // were settled by the last run, which is a measure of how much work
+    // it did.
+    int settledCount() const;
+
+    // reached() returns true if the vertex with the given index was
+    // reached by the last run.
+    bool reached(int index) const;
+
+    // distance() returns the length of the shortest path to the vertex
+    // with the given index, or infinity if it wasn't reached.
+    double distance(int index) const;
+
+    // predecessor() returns the index of the vertex before the given one
+    // on its shortest path, or -1 if it has none (because it's the start
+    // vertex or it wasn't reached).
+    int predecessor(int index) const;
+
+    // predecessorMap() converts the results of the last run on the given
+    // graph into the std::map<int, int> returned by findShortestPaths(),
+    // keyed by vertex number, where vertices without a predecessor map
+    // to themselves.
+    template <typename Graph>
+    std::map<int, int> predecessorMap(const Graph& graph) const;
+
+    // pathTo() follows the predecessors of the last run on the given
+    // graph back from the vertex with the given index, returning the
+    // shortest path to it.
+    template <typename EdgeInfo, typename Graph>
+    ShortestPath<EdgeInfo> pathTo(const Graph& graph, int targetIndex) const;
+
+private:
+    SearchWorkspace ownWorkspace_;
+    SearchWorkspace* workspace_;
+    int settledCount_;
+};
+
+
+
+inline ShortestPathSearch::ShortestPathSearch()
+    : workspace_{&ownWorkspace_}, settledCount_{0}
+{
+}
+
+
+inline ShortestPathSearch::ShortestPathSearch(SearchWorkspace& workspace)
+    : workspace_{&workspace}, settledCount_{0}
+{
+}
+
+
+
+template <typename Graph, typename WeightFunc>
+void ShortestPathSearch::run(
+    const Graph& graph, int startIndex, WeightFunc&& weightFunc,
+    int targetIndex)
+{
+    runUntil(
+        graph, startIndex, weightFunc,
+        [targetIndex](int settled)
+        {
+            return settled == targetIndex;
+        });
+}
+
+
+template <typename Graph, typename WeightFunc, typename StopFunc>
+void ShortestPathSearch::runUntil(
+    const Graph& graph, int startIndex, WeightFunc&& weightFunc,
+    StopFunc&& shouldStop)
+{
+    SearchWorkspace& workspace = *workspace_;
+    IndexedDaryHeap<4>& heap = workspace.heap();
+
+    workspace.reset(graph.vertexCount());
+    settledCount_ = 0;
+
+    workspace.setEntry(startIndex, 0.0, -1);
+    heap.push(startIndex, 0.0);
+
+    while (!heap.empty())
+    {
+        double base = heap.topKey();
+        int v = heap.pop();
+        ++settledCount_;
+
+        if (shouldStop(v))
+        {
+            break;
+        }
+
+        graph.forEachOutEdge(
+            v,
+            [&](int w, const auto& einfo)
+            {
+                double candidate = base + weightFunc(einfo);
+
+                if (candidate < workspace.distance(w))
+                {
+                    workspace.setEntry(w, candidate, v);
+                    heap.pushOrDecrease(w, candidate);
+                }
+            });
+    }
+}
+
+
+template <typename Graph, typename WeightFunc, typename Heuristic>
+void ShortestPathSearch::runToward(
+    const Graph& graph, int startIndex, int targetIndex,
+    WeightFunc&& weightFunc, Heuristic&& heuristic)
+{
+    SearchWorkspace& workspace = *workspace_;
+    IndexedDaryHeap<4>& heap = workspace.heap();
+
+    workspace.reset(graph.vertexCount());
+    settledCount_ = 0;
+
+    // The heap is keyed by distance plus bound, so the distance of each
+    // vertex comes from the workspace rather than from its key.
+
+    workspace.setEntry(startIndex, 0.0, -1);
+    heap.push(startIndex, heuristic(startIndex));
+
+    while (!heap.empty())
+    {
+        int v = heap.pop();
+        ++settledCount_;
+
+        if (v == targetIndex)
+        {
+            break;
+        }
+
+        double base = workspace.distance(v);
+
+        graph.forEachOutEdge(
+            v,
+            [&](int w, const auto& einfo)
+            {
+                double candidate = base + weightFunc(einfo);
+
+                if (candidate < workspace.distance(w))
+                {
+                    workspace.setEntry(w, candidate, v);
+                    heap.pushOrDecrease(w, candidate + heuristic(w));
+                }
+            });
+    }
+}
+
+
+inline int ShortestPathSearch::settledCount() const
+{
+    return settledCount_;
+}
+
+
+inline bool ShortestPathSearch::reached(int index) const
+{
+    return workspace_->distance(index) < std::numeric_limits<double>::infinity();
+}
+
+
+inline double ShortestPathSearch::distance(int index) const
+{
+    return workspace_->distance(index);
+}
+
+
+inline int ShortestPathSearch::predecessor(int index) const
+{
+    return workspace_->predecessor(index);
+}
+
+
+template <typename Graph>
+std::map<int, int> ShortestPathSearch::predecessorMap(const Graph& graph) const
+{
+    std::map<int, int> result;
+
+    for (int i = 0; i < workspace_->vertexCount(); ++i)
+    {
+        int p = predecessor(i) >= 0 ? predecessor(i) : i;
+        result.emplace(graph.toVertexNumber(i), graph.toVertexNumber(p));
+    }
+
+    return result;
+}
+
+
+template <typename EdgeInfo, typename Graph>
+ShortestPath<EdgeInfo> ShortestPathSearch::pathTo(const Graph& graph, int targetIndex) const
+{
+    ShortestPath<EdgeInfo> path{{}, {}, distance(targetIndex)};
+
+    if (!reached(targetIndex))
+    {
+        return path;
+    }
+
+    // Walking the predecessors gives the path backward; each edge's
+    // EdgeInfo is found among its "from" vertex's outgoing edges, which
+    // is unambiguous because there is at most one edge between any two
+    // vertices.
+
+    for (int v = targetIndex; v >= 0; v = predecessor(v))
+    {
+        path.vertices.push_back(graph.toVertexNumber(v));
+
+        int p = predecessor(v);
+
+        if (p >= 0)
+        {
+            graph.forEachOutEdge(
+                p,
+                [&](int w, const EdgeInfo& einfo)
+                {
+                    if (w == v)
+                    {
+                        path.edges.push_back(einfo);
+                    }
+                });
+        }
+    }
+
+    std::reverse(path.vertices.begin(), path.vertices.end());
+    std::reverse(path.edges.begin(), path.edges.end());
+
+    return path;
+}
+
+
+
+#endif // SHORTESTPATHSEARCH_HPP
+
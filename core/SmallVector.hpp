@@ -0,0 +1,434 @@
+// SmallVector.hpp
+//
+// ICS 46 Spring 2016
+// Project #4: Rock and Roll Stops the Traffic
+//
+// A SmallVector is a sequence of elements, like a std::vector, except that
+// its first InlineCapacity elements are stored inside the SmallVector
+// itself, so it allocates nothing until it grows beyond them.  It's what a
+// Digraph uses to store each vertex's outgoing edges: most intersections in
+// a road map have only a handful of them, so nearly every vertex keeps its
+// edges inline, and only the rare high-degree vertex (a freeway interchange,
+// say) spills them into a separately allocated array.
+//
+// Erasing an element shifts the ones after it back, so the remaining
+// elements keep their order.  As with a std::vector, iterators (which are
+// plain pointers) are invalidated by any insertion or erasure, and also
+// whenever the SmallVector itself is moved, since inline elements move
+// along with it.
+//
+// A spilled array is allocated by the given Allocator, which a Digraph
+// passes along from its own.  Moving a SmallVector (by construction or
+// assignment) moves its allocator along with its elements; copying one
+// doesn't.
+
+#ifndef SMALLVECTOR_HPP
+#define SMALLVECTOR_HPP
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+
+
+
+template <typename T, int InlineCapacity, typename Allocator = std::allocator<T>>
+class SmallVector : private Allocator
+{
+    static_assert(InlineCapacity >= 1, "a SmallVector needs room for at least one element");
+
+public:
+    using iterator = T*;
+    using const_iterator = const T*;
+
+public:
+    // The default constructor initializes an empty SmallVector, which
+    // uses its inline storage.
+    SmallVector();
+
+    // This constructor initializes an empty SmallVector that allocates
+    // with the given allocator if it ever spills.
+    explicit SmallVector(const Allocator& allocator);
+
+    // The copy constructor initializes a new SmallVector holding copies
+    // of the elements of another one.
+    SmallVector(const SmallVector& v);
+
+    // The move constructor takes the elements of another SmallVector,
+    // leaving it empty.  A spilled array changes hands without copying;
+    // inline elements are moved one at a time.
+    SmallVector(SmallVector&& v) noexcept;
+
+    // The destructor destroys the elements and releases any spilled array.
+    ~SmallVector();
+
+    SmallVector& operator=(const SmallVector& v);
+    SmallVector& operator=(SmallVector&& v) noexcept;
+
+    // size() returns the number of elements, and empty() returns true if
+    // there are none.
+    std::size_t size() const;
+    bool empty() const;
+
+    // capacity() returns the number of elements that fit before the
+    // SmallVector has to allocate, and isInline() returns true if the
+    // elements are still stored inside the SmallVector itself.
+    std::size_t capacity() const;
+    bool isInline() const;
+
+    // reserve() makes room for the given number of elements.
+    void reserve(std::size_t count);
+
+    // get_allocator() returns a copy of the SmallVector's allocator.
+    Allocator get_allocator() const;
+
+    iterator begin();
+    iterator end();
+    const_iterator begin() const;
+    const_iterator end() const;
+
+    T& operator[](std::size_t position);
+    const T& operator[](std::size_t position) const;
+
+    // push_back() adds a copy of the given element at the end, and
+    // emplace_back() constructs one there from the given arguments.
+    void push_back(const T& element);
+    void push_back(T&& element);
+
+    template <typename... Args>
+    T& emplace_back(Args&&... args);
+
+    // erase() removes the element at the given position, shifting the
+    // later elements back one, and returns an iterator to the element
+    // that followed the erased one.
+    iterator erase(const_iterator position);
+
+    // clear() destroys every element, keeping any spilled array.
+    void clear();
+
+private:
+    using Traits = std::allocator_traits<Allocator>;
+
+    Allocator& allocator();
+    T* inlineElements();
+    void grow(std::size_t capacity);
+    void release();
+
+    // takeFrom() moves the elements of another SmallVector into this
+    // empty one, leaving the other empty and inline.
+    void takeFrom(SmallVector& v) noexcept;
+
+private:
+    T* elements_;
+    std::size_t size_;
+    std::size_t capacity_;
+    alignas(T) unsigned char inline_[sizeof(T) * InlineCapacity];
+};
+
+
+
+template <typename T, int InlineCapacity, typename Allocator>
+SmallVector<T, InlineCapacity, Allocator>::SmallVector()
+    : SmallVector{Allocator{}}
+{
+}
+
+
+template <typename T, int InlineCapacity, typename Allocator>
+SmallVector<T, InlineCapacity, Allocator>::SmallVector(const Allocator& allocator)
+    : Allocator{allocator}, elements_{inlineElements()}, size_{0}, capacity_{InlineCapacity}
+{
+}
+
+
+template <typename T, int InlineCapacity, typename Allocator>
+SmallVector<T, InlineCapacity, Allocator>::SmallVector(const SmallVector& v)
+    : SmallVector{Traits::select_on_container_copy_construction(v.get_allocator())}
+{
+    reserve(v.size_);
+
+    for (const T& element : v)
+    {
+        push_back(element);
+    }
+}
+
+
+template <typename T, int InlineCapacity, typename Allocator>
+SmallVector<T, InlineCapacity, Allocator>::SmallVector(SmallVector&& v) noexcept
+    : SmallVector{v.get_allocator()}
+{
+    takeFrom(v);
+}
+
+
+template <typename T, int InlineCapacity, typename Allocator>
+SmallVector<T, InlineCapacity, Allocator>::~SmallVector()
+{
+    release();
+}
+
+
+template <typename T, int InlineCapacity, typename Allocator>
+SmallVector<T, InlineCapacity, Allocator>& SmallVector<T, InlineCapacity, Allocator>::operator=(const SmallVector& v)
+{
+    if (this != &v)
+    {
+        clear();
+        reserve(v.size_);
+
+        for (const T& element : v)
+        {
+            push_back(element);
+        }
+    }
+
+    return *this;
+}
+
+
+template <typename T, int InlineCapacity, typename Allocator>
+SmallVector<T, InlineCapacity, Allocator>& SmallVector<T, InlineCapacity, Allocator>::operator=(SmallVector&& v) noexcept
+{
+    if (this != &v)
+    {
+        release();
+        allocator() = v.allocator();
+        takeFrom(v);
+    }
+
+    return *this;
+}
+
+
+template <typename T, int InlineCapacity, typename Allocator>
+std::size_t SmallVector<T, InlineCapacity, Allocator>::size() const
+{
+    return size_;
+}
+
+
+template <typename T, int InlineCapacity, typename Allocator>
+bool SmallVector<T, InlineCapacity, Allocator>::empty() const
+{
+    return size_ == 0;
+}
+
+
+template <typename T, int InlineCapacity, typename Allocator>
+std::size_t SmallVector<T, InlineCapacity, Allocator>::capacity() const
+{
+    return capacity_;
+}
+
+
+template <typename T, int InlineCapacity, typename Allocator>
+bool SmallVector<T, InlineCapacity, Allocator>::isInline() const
+{
+    return elements_ == reinterpret_cast<const T*>(inline_);
+}
+
+
+template <typename T, int InlineCapacity, typename Allocator>
+void SmallVector<T, InlineCapacity, Allocator>::reserve(std::size_t count)
+{
+    if (count > capacity_)
+    {
+        grow(count);
+    }
+}
+
+
+template <typename T, int InlineCapacity, typename Allocator>
+Allocator SmallVector<T, InlineCapacity, Allocator>::get_allocator() const
+{
+    return *this;
+}
+
+
+template <typename T, int InlineCapacity, typename Allocator>
+typename SmallVector<T, InlineCapacity, Allocator>::iterator SmallVector<T, InlineCapacity, Allocator>::begin()
+{
+    return elements_;
+}
+
+
+template <typename T, int InlineCapacity, typename Allocator>
+typename SmallVector<T, InlineCapacity, Allocator>::iterator SmallVector<T, InlineCapacity, Allocator>::end()
+{
+    return elements_ + size_;
+}
+
+
+template <typename T, int InlineCapacity, typename Allocator>
+typename SmallVector<T, InlineCapacity, Allocator>::const_iterator SmallVector<T, InlineCapacity, Allocator>::begin() const
+{
+    return elements_;
+}
+
+
+template <typename T, int InlineCapacity, typename Allocator>
+typename SmallVector<T, InlineCapacity, Allocator>::const_iterator SmallVector<T, InlineCapacity, Allocator>::end() const
+{
+    return elements_ + size_;
+}
+
+
+template <typename T, int InlineCapacity, typename Allocator>
+T& SmallVector<T, InlineCapacity, Allocator>::operator[](std::size_t position)
+{
+    return elements_[position];
+}
+
+
+template <typename T, int InlineCapacity, typename Allocator>
+const T& SmallVector<T, InlineCapacity, Allocator>::operator[](std::size_t position) const
+{
+    return elements_[position];
+}
+
+
+template <typename T, int InlineCapacity, typename Allocator>
+void SmallVector<T, InlineCapacity, Allocator>::push_back(const T& element)
+{
+    emplace_back(element);
+}
+
+
+template <typename T, int InlineCapacity, typename Allocator>
+void SmallVector<T, InlineCapacity, Allocator>::push_back(T&& element)
+{
+    emplace_back(std::move(element));
+}
+
+
+template <typename T, int InlineCapacity, typename Allocator>
+template <typename... Args>
+T& SmallVector<T, InlineCapacity, Allocator>::emplace_back(Args&&... args)
+{
+    if (size_ == capacity_)
+    {
+        // The new element is constructed before the old ones move, since
+        // the arguments may refer to one of them.
+        T element(std::forward<Args>(args)...);
+        grow(capacity_ * 2);
+        new (elements_ + size_) T(std::move(element));
+    }
+    else
+    {
+        new (elements_ + size_) T(std::forward<Args>(args)...);
+    }
+
+    return elements_[size_++];
+}
+
+
+template <typename T, int InlineCapacity, typename Allocator>
+typename SmallVector<T, InlineCapacity, Allocator>::iterator SmallVector<T, InlineCapacity, Allocator>::erase(
+    const_iterator position)
+{
+    iterator hole = elements_ + (position - elements_);
+
+    for (iterator next = hole + 1; next != end(); ++next)
+    {
+        *(next - 1) = std::move(*next);
+    }
+
+    --size_;
+    elements_[size_].~T();
+
+    return hole;
+}
+
+
+template <typename T, int InlineCapacity, typename Allocator>
+void SmallVector<T, InlineCapacity, Allocator>::clear()
+{
+    for (std::size_t i = 0; i < size_; ++i)
+    {
+        elements_[i].~T();
+    }
+
+    size_ = 0;
+}
+
+
+template <typename T, int InlineCapacity, typename Allocator>
+Allocator& SmallVector<T, InlineCapacity, Allocator>::allocator()
+{
+    return *this;
+}
+
+
+template <typename T, int InlineCapacity, typename Allocator>
+T* SmallVector<T, InlineCapacity, Allocator>::inlineElements()
+{
+    return reinterpret_cast<T*>(inline_);
+}
+
+
+template <typename T, int InlineCapacity, typename Allocator>
+void SmallVector<T, InlineCapacity, Allocator>::grow(std::size_t capacity)
+{
+    T* elements = Traits::allocate(allocator(), capacity);
+
+    for (std::size_t i = 0; i < size_; ++i)
+    {
+        new (elements + i) T(std::move(elements_[i]));
+        elements_[i].~T();
+    }
+
+    if (!isInline())
+    {
+        Traits::deallocate(allocator(), elements_, capacity_);
+    }
+
+    elements_ = elements;
+    capacity_ = capacity;
+}
+
+
+template <typename T, int InlineCapacity, typename Allocator>
+void SmallVector<T, InlineCapacity, Allocator>::release()
+{
+    clear();
+
+    if (!isInline())
+    {
+        Traits::deallocate(allocator(), elements_, capacity_);
+    }
+
+    elements_ = inlineElements();
+    capacity_ = InlineCapacity;
+}
+
+
+template <typename T, int InlineCapacity, typename Allocator>
+void SmallVector<T, InlineCapacity, Allocator>::takeFrom(SmallVector& v) noexcept
+{
+    if (v.isInline())
+    {
+        for (std::size_t i = 0; i < v.size_; ++i)
+        {
+            new (elements_ + i) T(std::move(v.elements_[i]));
+        }
+
+        size_ = v.size_;
+        v.clear();
+    }
+    else
+    {
+        elements_ = v.elements_;
+        size_ = v.size_;
+        capacity_ = v.capacity_;
+
+        v.elements_ = v.inlineElements();
+        v.size_ = 0;
+        v.capacity_ = InlineCapacity;
+    }
+}
+
+
+
+#endif // SMALLVECTOR_HPP
+
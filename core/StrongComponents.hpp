@@ -0,0 +1,180 @@
+// StrongComponents.hpp
+//
+// ICS 46 Spring 2016
+// Project #4: Rock and Roll Stops the Traffic
+//
+// findStrongComponents() divides a graph into its strongly connected
+// components (the largest sets of vertices that can each be reached from
+// every other vertex in the set) using Tarjan's algorithm, in time
+// proportional to the number of vertices plus the number of edges.  A road
+// map with more than one component has places that can be driven into but
+// not back out of, such as a one-way street leading into a dead end.
+//
+// The depth-first search is iterative, keeping its own stack of frames
+// rather than recursing, so it can't overflow the call stack no matter how
+// deep the search goes.  Since a graph only offers its edges one vertex at
+// a time through forEachOutEdge(), the search copies a vertex's successors
+// onto a shared "pending" stack when it first visits the vertex, and each
+// frame remembers which part of the pending stack holds its successors.
+//
+// The graph can be of any type that provides these member functions (as
+// Digraph and CompactDigraph do):
+//
+// * int vertexCount() const, returning the number of dense indexes
+// * forEachOutEdge(int index, Visit visit) const, calling visit(toIndex,
+//   einfo) for each edge outgoing from the vertex with the given index
+
+#ifndef STRONGCOMPONENTS_HPP
+#define STRONGCOMPONENTS_HPP
+
+#include <algorithm>
+#include <vector>
+
+
+
+// StrongComponents describes how a graph divides into strongly connected
+// components.  Components are numbered from 0 to componentCount - 1, and
+// componentOf holds the component number of each vertex, by dense index.
+// Tarjan's algorithm finishes a component only after every component
+// reachable from it, so the numbering is a reverse topological order: an
+// edge between two components always leads from a higher number to a
+// lower one.  largestComponent is the number of a component with the most
+// vertices, and largestSize is how many it has; in a graph with no
+// vertices, they're -1 and 0.
+
+struct StrongComponents
+{
+    std::vector<int> componentOf;
+    int componentCount;
+    int largestComponent;
+    int largestSize;
+};
+
+
+
+// findStrongComponents() returns the strongly connected components of the
+// given graph.
+template <typename Graph>
+StrongComponents findStrongComponents(const Graph& graph);
+
+
+
+template <typename Graph>
+StrongComponents findStrongComponents(const Graph& graph)
+{
+    int count = graph.vertexCount();
+
+    StrongComponents result{std::vector<int>(count, -1), 0, -1, 0};
+
+    // order holds the order in which each vertex was first visited (or -1
+    // if it hasn't been yet), and lowest holds the smallest order of any
+    // vertex known to be reachable from it that is still on the open
+    // stack, i.e., not yet assigned to a component.
+
+    struct Frame
+    {
+        int vertex;
+        int pendingBegin;
+        int next;
+        int pendingEnd;
+    };
+
+    std::vector<int> order(count, -1);
+    std::vector<int> lowest(count, 0);
+    std::vector<int> open;
+    std::vector<int> pending;
+    std::vector<Frame> frames;
+    int visitedCount = 0;
+
+    auto enter =
+        [&](int v)
+        {
+            order[v] = lowest[v] = visitedCount++;
+            open.push_back(v);
+
+            int begin = static_cast<int>(pending.size());
+
+            graph.forEachOutEdge(
+                v,
+                [&](int w, const auto&)
+                {
+                    pending.push_back(w);
+                });
+
+            frames.push_back(Frame{v, begin, begin, static_cast<int>(pending.size())});
+        };
+
+    for (int root = 0; root < count; ++root)
+    {
+        if (order[root] >= 0)
+        {
+            continue;
+        }
+
+        enter(root);
+
+        while (!frames.empty())
+        {
+            Frame& frame = frames.back();
+            int v = frame.vertex;
+
+            if (frame.next < frame.pendingEnd)
+            {
+                int w = pending[frame.next++];
+
+                if (order[w] < 0)
+                {
+                    enter(w);
+                }
+                else if (result.componentOf[w] < 0)
+                {
+                    lowest[v] = std::min(lowest[v], order[w]);
+                }
+
+                continue;
+            }
+
+            // Every successor of v has been explored.  If nothing reachable
+            // from v leads back above it, v is the first vertex visited in
+            // its component, and the component is everything opened since.
+
+            if (lowest[v] == order[v])
+            {
+                int component = result.componentCount++;
+                int size = 0;
+                int w;
+
+                do
+                {
+                    w = open.back();
+                    open.pop_back();
+                    result.componentOf[w] = component;
+                    ++size;
+                }
+                while (w != v);
+
+                if (size > result.largestSize)
+                {
+                    result.largestComponent = component;
+                    result.largestSize = size;
+                }
+            }
+
+            pending.resize(frame.pendingBegin);
+            frames.pop_back();
+
+            if (!frames.empty())
+            {
+                int parent = frames.back().vertex;
+                lowest[parent] = std::min(lowest[parent], lowest[v]);
+            }
+        }
+    }
+
+    return result;
+}
+
+
+
+#endif // STRONGCOMPONENTS_HPP
+
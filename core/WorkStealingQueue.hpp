@@ -0,0 +1,88 @@
+// WorkStealingQueue.hpp
+//
+// ICS 46 Spring 2016
+// Project #4: Rock and Roll Stops the Traffic
+//
+// A WorkStealingQueue is a double-ended queue of tasks belonging to one
+// worker thread in a pool.  The owning worker pushes and pops tasks at the
+// back, while other workers that have run out of their own tasks steal
+// from the front, so an idle thread takes the work its owner would have
+// gotten to last.  Every operation locks the queue briefly, which is cheap
+// next to the work a task represents here (a whole shortest path search).
+
+#ifndef WORKSTEALINGQUEUE_HPP
+#define WORKSTEALINGQUEUE_HPP
+
+#include <deque>
+#include <mutex>
+#include <utility>
+
+
+
+template <typename Task>
+class WorkStealingQueue
+{
+public:
+    // push() adds a task at the back of the queue.
+    void push(Task task);
+
+    // pop() removes the task at the back of the queue and stores it in
+    // task, returning true, or returns false if the queue is empty.  It
+    // is meant to be called by the queue's owner.
+    bool pop(Task& task);
+
+    // steal() removes the task at the front of the queue and stores it
+    // in task, returning true, or returns false if the queue is empty.
+    // It is meant to be called by workers other than the queue's owner.
+    bool steal(Task& task);
+
+private:
+    std::mutex mutex_;
+    std::deque<Task> tasks_;
+};
+
+
+
+template <typename Task>
+void WorkStealingQueue<Task>::push(Task task)
+{
+    std::lock_guard<std::mutex> lock{mutex_};
+    tasks_.push_back(std::move(task));
+}
+
+
+template <typename Task>
+bool WorkStealingQueue<Task>::pop(Task& task)
+{
+    std::lock_guard<std::mutex> lock{mutex_};
+
+    if (tasks_.empty())
+    {
+        return false;
+    }
+
+    task = std::move(tasks_.back());
+    tasks_.pop_back();
+    return true;
+}
+
+
+template <typename Task>
+bool WorkStealingQueue<Task>::steal(Task& task)
+{
+    std::lock_guard<std::mutex> lock{mutex_};
+
+    if (tasks_.empty())
+    {
+        return false;
+    }
+
+    task = std::move(tasks_.front());
+    tasks_.pop_front();
+    return true;
+}
+
+
+
+#endif // WORKSTEALINGQUEUE_HPP
+
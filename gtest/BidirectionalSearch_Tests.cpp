@@ -0,0 +1,124 @@
+// BidirectionalSearch_Tests.cpp
+//
+// ICS 46 Spring 2016
+// Project #4: Rock and Roll Stops the Traffic
+//
+// Unit tests for BidirectionalSearch, checking its paths against a forward
+// ShortestPathSearch on randomly generated graphs, both directly on a
+// Digraph and on its frozen CompactDigraph.
+
+#include <gtest/gtest.h>
+#include <limits>
+#include <vector>
+#include "BidirectionalSearch.hpp"
+#include "Digraph.hpp"
+#include "RandomGraphs.hpp"
+#include "ShortestPathSearch.hpp"
+
+
+TEST(BidirectionalSearch_Tests, pathsMatchForwardSearch)
+{
+    for (unsigned seed = 1; seed <= 5; ++seed)
+    {
+        Digraph<int, double> d = makeRandomGraph(60, 200, seed);
+        d.indexIncomingEdges();
+
+        CompactDigraph<int, double> c = d.freeze();
+        c.indexIncomingEdges();
+
+        ShortestPathSearch forward;
+        BidirectionalSearch onDigraph;
+        BidirectionalSearch onCompact;
+
+        for (int target = 0; target < d.vertexCount(); ++target)
+        {
+            forward.run(d, d.toIndex(7), identity);
+            ShortestPath<double> expected = forward.pathTo<double>(d, target);
+
+            onDigraph.run(d, d.toIndex(7), target, identity);
+            onCompact.run(c, c.toIndex(7), c.toIndex(d.toVertexNumber(target)), identity);
+
+            ShortestPath<double> fromDigraph = onDigraph.path<double>(d);
+            ShortestPath<double> fromCompact = onCompact.path<double>(c);
+
+            EXPECT_EQ(forward.reached(target), onDigraph.reached());
+            EXPECT_DOUBLE_EQ(expected.totalCost, onDigraph.distance());
+            EXPECT_DOUBLE_EQ(expected.totalCost, onCompact.distance());
+
+            // With random real weights, shortest paths are unique, so the
+            // two searches must find the very same one.
+            EXPECT_EQ(expected.vertices, fromDigraph.vertices);
+            EXPECT_EQ(expected.edges, fromDigraph.edges);
+            EXPECT_EQ(expected.vertices, fromCompact.vertices);
+        }
+    }
+}
+
+
+TEST(BidirectionalSearch_Tests, settlesFewerVerticesThanForwardSearch)
+{
+    // The vertices form a 30-by-30 grid, with roads in both directions
+    // between neighbors, numbered row * 100 + column.
+    Digraph<int, double> d;
+
+    for (int row = 0; row < 30; ++row)
+    {
+        for (int column = 0; column < 30; ++column)
+        {
+            d.addVertex(row * 100 + column, 0);
+
+            if (column > 0)
+            {
+                d.addEdge(row * 100 + column, row * 100 + column - 1, 1.0);
+                d.addEdge(row * 100 + column - 1, row * 100 + column, 1.0);
+            }
+
+            if (row > 0)
+            {
+                d.addEdge(row * 100 + column, (row - 1) * 100 + column, 1.0);
+                d.addEdge((row - 1) * 100 + column, row * 100 + column, 1.0);
+            }
+        }
+    }
+
+    d.indexIncomingEdges();
+
+    ShortestPathSearch forward;
+    forward.run(d, d.toIndex(1505), identity, d.toIndex(1525));
+
+    BidirectionalSearch search;
+    search.run(d, d.toIndex(1505), d.toIndex(1525), identity);
+
+    EXPECT_DOUBLE_EQ(20.0, search.distance());
+    EXPECT_EQ(21u, search.path<double>(d).vertices.size());
+    EXPECT_LT(search.settledCount(), forward.settledCount() * 2 / 3);
+}
+
+
+TEST(BidirectionalSearch_Tests, handlesTrivialAndUnreachableTargets)
+{
+    Digraph<int, double> d;
+
+    for (int v = 0; v < 10; ++v)
+    {
+        d.addVertex(v, v);
+    }
+
+    for (int v = 0; v < 9; ++v)
+    {
+        d.addEdge(v, v + 1, 1.0);
+    }
+
+    d.indexIncomingEdges();
+
+    BidirectionalSearch search;
+    search.run(d, d.toIndex(5), d.toIndex(5), identity);
+    EXPECT_DOUBLE_EQ(0.0, search.distance());
+    EXPECT_EQ((std::vector<int>{5}), search.path<double>(d).vertices);
+
+    search.run(d, d.toIndex(7), d.toIndex(2), identity);
+    EXPECT_FALSE(search.reached());
+    EXPECT_EQ(std::numeric_limits<double>::infinity(), search.distance());
+    EXPECT_TRUE(search.path<double>(d).vertices.empty());
+}
+
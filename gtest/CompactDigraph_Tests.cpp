@@ -0,0 +1,157 @@
+// CompactDigraph_Tests.cpp
+//
+// ICS 46 Spring 2016
+// Project #4: Rock and Roll Stops the Traffic
+//
+// Unit tests for CompactDigraph, mostly checking that a frozen Digraph
+// answers the same queries the same way the Digraph it came from does.
+
+#include <gtest/gtest.h>
+#include <string>
+#include "Digraph.hpp"
+
+
+namespace
+{
+    Digraph<std::string, double> makeTriangle()
+    {
+        Digraph<std::string, double> d;
+        d.addVertex(10, "ten");
+        d.addVertex(20, "twenty");
+        d.addVertex(30, "thirty");
+        d.addEdge(10, 20, 1.0);
+        d.addEdge(20, 30, 2.0);
+        d.addEdge(10, 30, 5.0);
+        return d;
+    }
+
+
+    double identity(const double& weight)
+    {
+        return weight;
+    }
+}
+
+
+TEST(CompactDigraph_Tests, frozenGraphHasSameVerticesAndEdges)
+{
+    CompactDigraph<std::string, double> c = makeTriangle().freeze();
+
+    EXPECT_EQ(3, c.vertexCount());
+    EXPECT_EQ(3, c.edgeCount());
+    EXPECT_EQ(2, c.edgeCount(10));
+    EXPECT_EQ(0, c.edgeCount(30));
+    EXPECT_EQ((std::vector<int>{10, 20, 30}), c.vertices());
+    EXPECT_EQ("twenty", c.vertexInfo(20));
+    EXPECT_EQ(5.0, c.edgeInfo(10, 30));
+
+    std::vector<std::pair<int, int>> expected{{10, 20}, {10, 30}, {20, 30}};
+    EXPECT_EQ(expected, c.edges());
+}
+
+
+TEST(CompactDigraph_Tests, missingVerticesAndEdgesThrow)
+{
+    CompactDigraph<std::string, double> c = makeTriangle().freeze();
+
+    EXPECT_THROW(c.vertexInfo(40), DigraphException);
+    EXPECT_THROW(c.edges(40), DigraphException);
+    EXPECT_THROW(c.edgeInfo(30, 10), DigraphException);
+}
+
+
+TEST(CompactDigraph_Tests, findsShortestPaths)
+{
+    CompactDigraph<std::string, double> c = makeTriangle().freeze();
+
+    std::map<int, int> paths = c.findShortestPaths(10, identity);
+
+    EXPECT_EQ(10, paths.at(10));
+    EXPECT_EQ(10, paths.at(20));
+    EXPECT_EQ(20, paths.at(30));
+}
+
+
+TEST(CompactDigraph_Tests, checksStrongConnectedness)
+{
+    Digraph<std::string, double> d = makeTriangle();
+    EXPECT_FALSE(d.freeze().isStronglyConnected());
+
+    d.addEdge(30, 10, 1.0);
+    EXPECT_TRUE(d.freeze().isStronglyConnected());
+}
+
+
+TEST(CompactDigraph_Tests, edgePositionsAreDenseAndStable)
+{
+    CompactDigraph<std::string, double> c = makeTriangle().freeze();
+
+    int index = c.toIndex(10);
+    EXPECT_EQ(0, c.edgeBegin(index));
+    EXPECT_EQ(2, c.edgeEnd(index));
+
+    int position = c.edgePosition(20, 30);
+    EXPECT_EQ(c.toIndex(30), c.edgeTarget(position));
+    EXPECT_EQ(2.0, c.edgeInfoAt(position));
+
+    c.setEdgeInfo(20, 30, 7.5);
+    EXPECT_EQ(position, c.edgePosition(20, 30));
+    EXPECT_EQ(7.5, c.edgeInfo(20, 30));
+    EXPECT_THROW(c.setEdgeInfo(30, 20, 1.0), DigraphException);
+}
+
+
+TEST(CompactDigraph_Tests, incomingEdgesCanBeHandedBack)
+{
+    CompactDigraph<std::string, double> indexed = makeTriangle().freeze();
+    indexed.indexIncomingEdges();
+
+    std::vector<int> offsets;
+    std::vector<int> sources;
+    std::vector<int> positions;
+
+    for (int i = 0; i < indexed.vertexCount(); ++i)
+    {
+        offsets.push_back(indexed.inEdgeBegin(i));
+
+        for (int slot = indexed.inEdgeBegin(i); slot < indexed.inEdgeEnd(i); ++slot)
+        {
+            sources.push_back(indexed.inEdgeSource(slot));
+            positions.push_back(indexed.inEdgePosition(slot));
+        }
+    }
+
+    offsets.push_back(indexed.edgeCount());
+
+    CompactDigraph<std::string, double> c = makeTriangle().freeze();
+    c.setIncomingEdges(offsets, sources, positions);
+    ASSERT_TRUE(c.incomingEdgesIndexed());
+
+    std::vector<int> from;
+    c.forEachInEdge(c.toIndex(30), [&](int index, double) { from.push_back(c.toVertexNumber(index)); });
+    EXPECT_EQ((std::vector<int>{10, 20}), from);
+
+    std::vector<int> badSources = sources;
+    badSources[0] = 3;
+    EXPECT_THROW(c.setIncomingEdges(offsets, badSources, positions), DigraphException);
+
+    std::vector<int> shortOffsets(offsets.begin(), offsets.end() - 1);
+    EXPECT_THROW(c.setIncomingEdges(shortOffsets, sources, positions), DigraphException);
+
+    // Slots whose sources and positions are in range, but don't match the
+    // edges they name.
+    std::vector<int> wrongSources = sources;
+    std::swap(wrongSources.front(), wrongSources.back());
+    EXPECT_THROW(c.setIncomingEdges(offsets, wrongSources, positions), DigraphException);
+
+    std::vector<int> wrongPositions = positions;
+    std::swap(wrongPositions.front(), wrongPositions.back());
+    EXPECT_THROW(c.setIncomingEdges(offsets, sources, wrongPositions), DigraphException);
+
+    // Both of thirty's slots name the same edge, so the other is missing.
+    std::vector<int> repeatedSources = sources;
+    repeatedSources[2] = repeatedSources[1];
+    std::vector<int> repeatedPositions = positions;
+    repeatedPositions[2] = repeatedPositions[1];
+    EXPECT_THROW(c.setIncomingEdges(offsets, repeatedSources, repeatedPositions), DigraphException);
+}
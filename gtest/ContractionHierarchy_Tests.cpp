@@ -0,0 +1,188 @@
+// ContractionHierarchy_Tests.cpp
+//
+// ICS 46 Spring 2016
+// Project #4: Rock and Roll Stops the Traffic
+//
+// Unit tests for ContractionHierarchy, checking its queries and unpacked
+// paths against a ShortestPathSearch on randomly generated graphs, with
+// one preprocessing thread and with several, and checking that a
+// hierarchy rebuilt from its arrays answers the same way.
+
+#include <gtest/gtest.h>
+#include <vector>
+#include "ContractionHierarchy.hpp"
+#include "Digraph.hpp"
+#include "RandomGraphs.hpp"
+#include "ShortestPathSearch.hpp"
+
+
+namespace
+{
+    void expectSameAsDijkstra(
+        const CompactDigraph<int, double>& c, const ContractionHierarchy& hierarchy)
+    {
+        hierarchy.verify();
+
+        ShortestPathSearch dijkstra;
+        ContractionHierarchyQuery query;
+
+        for (int start = 0; start < c.vertexCount(); start += 7)
+        {
+            dijkstra.run(c, start, identity);
+
+            for (int target = 0; target < c.vertexCount(); ++target)
+            {
+                query.run(hierarchy, start, target);
+
+                ASSERT_EQ(dijkstra.reached(target), query.reached());
+                EXPECT_DOUBLE_EQ(dijkstra.distance(target), query.distance());
+
+                // With random real weights, shortest paths are unique, so
+                // the unpacked path must be Dijkstra's.
+                ShortestPath<double> expected = dijkstra.pathTo<double>(c, target);
+                ShortestPath<double> unpacked = query.path<double>(hierarchy, c);
+
+                EXPECT_EQ(expected.vertices, unpacked.vertices);
+                EXPECT_EQ(expected.edges, unpacked.edges);
+            }
+        }
+    }
+}
+
+
+TEST(ContractionHierarchy_Tests, queriesMatchDijkstra)
+{
+    for (unsigned seed = 1; seed <= 3; ++seed)
+    {
+        CompactDigraph<int, double> c = makeRandomGrid(12, seed);
+
+        expectSameAsDijkstra(c, ContractionHierarchy::build(c, identity, 1));
+        expectSameAsDijkstra(c, ContractionHierarchy::build(c, identity, 4));
+    }
+}
+
+
+TEST(ContractionHierarchy_Tests, queriesSettleFewerVerticesThanDijkstra)
+{
+    CompactDigraph<int, double> c = makeRandomGrid(40, 5);
+    ContractionHierarchy hierarchy = ContractionHierarchy::build(c, identity);
+
+    ShortestPathSearch dijkstra;
+    ContractionHierarchyQuery query;
+
+    int dijkstraSettled = 0;
+    int querySettled = 0;
+
+    for (int i = 0; i < 20; ++i)
+    {
+        int start = i * 37 % c.vertexCount();
+        int target = c.vertexCount() - 1 - i * 53 % c.vertexCount();
+
+        dijkstra.run(c, start, identity, target);
+        query.run(hierarchy, start, target);
+
+        EXPECT_DOUBLE_EQ(dijkstra.distance(target), query.distance());
+
+        dijkstraSettled += dijkstra.settledCount();
+        querySettled += query.settledCount();
+    }
+
+    EXPECT_LT(querySettled * 3, dijkstraSettled);
+}
+
+
+TEST(ContractionHierarchy_Tests, rebuildsFromArraysAndRejectsBadOnes)
+{
+    CompactDigraph<int, double> c = makeRandomGrid(8, 9);
+    ContractionHierarchy hierarchy = ContractionHierarchy::build(c, identity);
+
+    ContractionHierarchy copy{
+        hierarchy.rankArray(),
+        hierarchy.forwardOffsetArray(), hierarchy.forwardArcArray(),
+        hierarchy.backwardOffsetArray(), hierarchy.backwardArcArray()};
+
+    EXPECT_EQ(hierarchy.arcCount(), copy.arcCount());
+    expectSameAsDijkstra(c, copy);
+
+    // Swapping the ranks of two vertices that share an arc makes that arc
+    // lead downward.
+    std::vector<int> ranks(hierarchy.rankArray().begin(), hierarchy.rankArray().end());
+    int v = 0;
+
+    while (hierarchy.forwardArcs(v).begin() == hierarchy.forwardArcs(v).end())
+    {
+        ++v;
+    }
+
+    std::swap(ranks[v], ranks[hierarchy.forwardArcs(v).begin()->vertex]);
+
+    // The arrays' sizes still agree, so only verify() notices.
+    ContractionHierarchy downward{
+        ranks,
+        hierarchy.forwardOffsetArray(), hierarchy.forwardArcArray(),
+        hierarchy.backwardOffsetArray(), hierarchy.backwardArcArray()};
+
+    EXPECT_THROW(downward.verify(), DigraphException);
+
+    // Making an arc a shortcut through the lowest-ranked vertex, which
+    // has no arc to or from the arc's lower end, passes every rank check,
+    // but the shortcut can't be unpacked.
+    std::vector<int> order = hierarchy.order();
+    int lowest = order.back();
+
+    auto linked =
+        [&](int w)
+        {
+            for (const HierarchyArc& arc : hierarchy.forwardArcs(lowest))
+            {
+                if (arc.vertex == w)
+                {
+                    return true;
+                }
+            }
+
+            for (const HierarchyArc& arc : hierarchy.backwardArcs(lowest))
+            {
+                if (arc.vertex == w)
+                {
+                    return true;
+                }
+            }
+
+            return false;
+        };
+
+    std::vector<HierarchyArc> arcs(
+        hierarchy.forwardArcArray().begin(), hierarchy.forwardArcArray().end());
+    int owner = 0;
+
+    while (owner == lowest || linked(owner)
+           || hierarchy.forwardArcs(owner).begin() == hierarchy.forwardArcs(owner).end())
+    {
+        ++owner;
+    }
+
+    arcs[hierarchy.forwardOffsetArray()[owner]].middle = lowest;
+
+    ContractionHierarchy unpackable{
+        hierarchy.rankArray(),
+        hierarchy.forwardOffsetArray(), arcs,
+        hierarchy.backwardOffsetArray(), hierarchy.backwardArcArray()};
+
+    EXPECT_THROW(unpackable.verify(), DigraphException);
+
+    EXPECT_THROW(
+        (ContractionHierarchy{
+            hierarchy.rankArray(),
+            hierarchy.backwardOffsetArray(), hierarchy.forwardArcArray(),
+            hierarchy.backwardOffsetArray(), hierarchy.backwardArcArray()}),
+        DigraphException);
+
+    EXPECT_THROW(
+        (ContractionHierarchy{
+            std::vector<int>(ranks.begin(), ranks.end() - 1),
+            hierarchy.forwardOffsetArray(), hierarchy.forwardArcArray(),
+            hierarchy.backwardOffsetArray(), hierarchy.backwardArcArray()}),
+        DigraphException);
+}
+
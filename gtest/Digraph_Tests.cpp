@@ -0,0 +1,492 @@
+// Digraph_Tests.cpp
+//
+// ICS 46 Spring 2016
+// Project #4: Rock and Roll Stops the Traffic
+//
+// Unit tests for the behavior of Digraph, as opposed to the sanity checks,
+// which only make sure the member functions have the right signatures.
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include "Digraph.hpp"
+
+
+TEST(Digraph_Tests, vertexNumbersNeedNotBeSequential)
+{
+    Digraph<std::string, int> d;
+    d.addVertex(100, "a");
+    d.addVertex(-7, "b");
+    d.addVertex(42, "c");
+
+    EXPECT_EQ(3, d.vertexCount());
+    EXPECT_EQ(0, d.toIndex(100));
+    EXPECT_EQ(1, d.toIndex(-7));
+    EXPECT_EQ(2, d.toIndex(42));
+    EXPECT_EQ(-7, d.toVertexNumber(1));
+    EXPECT_EQ("c", d.vertexInfo(42));
+}
+
+
+TEST(Digraph_Tests, missingVerticesAndDuplicatesThrow)
+{
+    Digraph<std::string, int> d;
+    d.addVertex(1, "a");
+    d.addVertex(2, "b");
+    d.addEdge(1, 2, 5);
+
+    EXPECT_THROW(d.addVertex(1, "again"), DigraphException);
+    EXPECT_THROW(d.addEdge(1, 2, 6), DigraphException);
+    EXPECT_THROW(d.addEdge(1, 3, 6), DigraphException);
+    EXPECT_THROW(d.vertexInfo(3), DigraphException);
+    EXPECT_THROW(d.edgeInfo(2, 1), DigraphException);
+    EXPECT_THROW(d.removeEdge(2, 1), DigraphException);
+    EXPECT_THROW(d.removeVertex(3), DigraphException);
+    EXPECT_THROW(d.toVertexNumber(2), DigraphException);
+}
+
+
+TEST(Digraph_Tests, removingVertexRemovesIncomingAndOutgoingEdges)
+{
+    Digraph<std::string, int> d;
+    d.addVertex(1, "a");
+    d.addVertex(2, "b");
+    d.addVertex(3, "c");
+    d.addEdge(1, 2, 12);
+    d.addEdge(2, 3, 23);
+    d.addEdge(3, 1, 31);
+    d.addEdge(3, 2, 32);
+
+    d.removeVertex(2);
+
+    EXPECT_EQ(2, d.vertexCount());
+    EXPECT_EQ(1, d.edgeCount());
+    EXPECT_EQ(0, d.edgeCount(1));
+    EXPECT_EQ(31, d.edgeInfo(3, 1));
+
+    // The last vertex moved into the removed vertex's index, and edges
+    // pointing to it have to follow it there.
+    EXPECT_EQ(1, d.toIndex(3));
+    d.addEdge(1, 3, 13);
+    EXPECT_EQ(13, d.edgeInfo(1, 3));
+    EXPECT_TRUE(d.isStronglyConnected());
+}
+
+
+TEST(Digraph_Tests, copiesAndAssignmentsAreDeep)
+{
+    Digraph<std::string, int> d1;
+    d1.addVertex(1, "a");
+
+    Digraph<std::string, int> d2{d1};
+    Digraph<std::string, int> d3;
+    d3 = d1;
+
+    d1.addVertex(2, "b");
+
+    EXPECT_EQ(2, d1.vertexCount());
+    EXPECT_EQ(1, d2.vertexCount());
+    EXPECT_EQ(1, d3.vertexCount());
+    EXPECT_EQ("a", d3.vertexInfo(1));
+}
+
+
+TEST(Digraph_Tests, findsShortestPaths)
+{
+    Digraph<std::string, double> d;
+    d.addVertex(5, "a");
+    d.addVertex(3, "b");
+    d.addVertex(9, "c");
+    d.addVertex(1, "unreachable");
+    d.addEdge(5, 3, 1.0);
+    d.addEdge(3, 9, 1.0);
+    d.addEdge(5, 9, 3.0);
+
+    std::map<int, int> paths = d.findShortestPaths(
+        5, [](const double& w) { return w; });
+
+    EXPECT_EQ(5, paths.at(5));
+    EXPECT_EQ(5, paths.at(3));
+    EXPECT_EQ(3, paths.at(9));
+    EXPECT_EQ(1, paths.at(1));
+}
+
+
+TEST(Digraph_Tests, findsOneShortestPathWithItsEdges)
+{
+    Digraph<std::string, double> d;
+    d.addVertex(5, "a");
+    d.addVertex(3, "b");
+    d.addVertex(9, "c");
+    d.addVertex(1, "unreachable");
+    d.addEdge(5, 3, 1.0);
+    d.addEdge(3, 9, 1.5);
+    d.addEdge(5, 9, 3.0);
+
+    ShortestPath<double> path = d.findShortestPath(
+        5, 9, [](const double& w) { return w; });
+
+    EXPECT_EQ((std::vector<int>{5, 3, 9}), path.vertices);
+    EXPECT_EQ((std::vector<double>{1.0, 1.5}), path.edges);
+    EXPECT_DOUBLE_EQ(2.5, path.totalCost);
+
+    ShortestPath<double> none = d.findShortestPath(
+        5, 1, [](const double& w) { return w; });
+
+    EXPECT_TRUE(none.vertices.empty());
+    EXPECT_TRUE(none.edges.empty());
+}
+
+
+namespace
+{
+    struct DoubledWeight
+    {
+        double operator()(const double& w) const
+        {
+            return w * 2.0;
+        }
+    };
+}
+
+
+TEST(Digraph_Tests, acceptsFunctionObjectsAsWeights)
+{
+    Digraph<std::string, double> d;
+    d.addVertex(1, "a");
+    d.addVertex(2, "b");
+    d.addVertex(3, "c");
+    d.addEdge(1, 2, 1.0);
+    d.addEdge(2, 3, 1.0);
+    d.addEdge(1, 3, 3.0);
+
+    std::map<int, int> paths = d.findShortestPaths(1, DoubledWeight{});
+    EXPECT_EQ(2, paths.at(3));
+
+    ShortestPath<double> path = d.findShortestPath(1, 3, DoubledWeight{});
+    EXPECT_DOUBLE_EQ(4.0, path.totalCost);
+
+    std::function<double(const double&)> erased = DoubledWeight{};
+    EXPECT_EQ(paths, d.findShortestPaths(1, erased));
+}
+
+
+TEST(Digraph_Tests, bulkAdditionsMatchOneAtATimeAdditions)
+{
+    Digraph<std::string, int> one;
+    one.addVertex(3, "c");
+    one.addVertex(1, "a");
+    one.addVertex(2, "b");
+    one.addEdge(3, 1, 31);
+    one.addEdge(1, 2, 12);
+    one.addEdge(3, 2, 32);
+
+    Digraph<std::string, int> bulk;
+    bulk.reserve(3);
+    bulk.addVertices(std::vector<std::pair<int, std::string>>{{3, "c"}, {1, "a"}, {2, "b"}});
+    bulk.addEdges(std::vector<std::tuple<int, int, int>>{{3, 1, 31}, {1, 2, 12}, {3, 2, 32}});
+
+    EXPECT_EQ(one.vertices(), bulk.vertices());
+    EXPECT_EQ(one.edges(), bulk.edges());
+    EXPECT_EQ(3, bulk.edgeCount());
+    EXPECT_EQ(32, bulk.edgeInfo(3, 2));
+}
+
+
+TEST(Digraph_Tests, bulkAdditionsReportEveryProblemAndAddNothing)
+{
+    Digraph<std::string, int> d;
+    d.addVertex(1, "a");
+    d.addVertex(2, "b");
+    d.addEdge(1, 2, 12);
+
+    try
+    {
+        d.addVertices(std::vector<std::pair<int, std::string>>{{5, "e"}, {2, "b"}, {5, "e"}, {5, "e"}});
+        FAIL() << "expected a DigraphException";
+    }
+    catch (DigraphException& e)
+    {
+        EXPECT_EQ("vertices already exist: 2, 5", e.reason());
+    }
+
+    EXPECT_EQ(2, d.vertexCount());
+
+    try
+    {
+        d.addEdges(std::vector<std::tuple<int, int, int>>{{2, 1, 21}, {1, 2, 12}, {2, 1, 21}});
+        FAIL() << "expected a DigraphException";
+    }
+    catch (DigraphException& e)
+    {
+        EXPECT_EQ("edges already exist: 1->2, 2->1", e.reason());
+    }
+
+    try
+    {
+        d.addEdges(std::vector<std::tuple<int, int, int>>{{2, 1, 21}, {1, 9, 19}});
+        FAIL() << "expected a DigraphException";
+    }
+    catch (DigraphException& e)
+    {
+        EXPECT_EQ("vertex does not exist: 9", e.reason());
+    }
+
+    EXPECT_EQ(1, d.edgeCount());
+}
+
+
+TEST(Digraph_Tests, indexedIncomingEdgesFollowRemovals)
+{
+    Digraph<std::string, int> d;
+    d.addVertex(1, "a");
+    d.addVertex(2, "b");
+    d.addVertex(3, "c");
+    d.addEdge(1, 2, 12);
+    d.addEdge(3, 2, 32);
+    d.addEdge(3, 3, 33);
+    d.addEdge(2, 3, 23);
+    d.indexIncomingEdges();
+
+    std::vector<std::pair<int, int>> incoming = d.incomingEdges(2);
+    std::sort(incoming.begin(), incoming.end());
+    EXPECT_EQ((std::vector<std::pair<int, int>>{{1, 2}, {3, 2}}), incoming);
+
+    d.removeVertex(1);
+
+    EXPECT_EQ(3, d.edgeCount());
+    EXPECT_EQ(0, d.toIndex(3));
+    EXPECT_EQ((std::vector<std::pair<int, int>>{{3, 2}}), d.incomingEdges(2));
+
+    incoming = d.incomingEdges(3);
+    std::sort(incoming.begin(), incoming.end());
+    EXPECT_EQ((std::vector<std::pair<int, int>>{{2, 3}, {3, 3}}), incoming);
+
+    d.removeEdge(3, 2);
+    EXPECT_TRUE(d.incomingEdges(2).empty());
+    EXPECT_EQ(33, d.edgeInfo(3, 3));
+}
+
+
+TEST(Digraph_Tests, indexedAndUnindexedRemovalsAgree)
+{
+    Digraph<std::string, int> plain;
+    std::mt19937 random{46};
+
+    for (int v = 0; v < 60; ++v)
+    {
+        plain.addVertex(v * 7, "v");
+    }
+
+    std::set<std::pair<int, int>> added;
+
+    for (int e = 0; e < 400; ++e)
+    {
+        int from = static_cast<int>(random() % 60) * 7;
+        int to = static_cast<int>(random() % 60) * 7;
+
+        if (added.emplace(from, to).second)
+        {
+            plain.addEdge(from, to, e);
+        }
+    }
+
+    Digraph<std::string, int> indexed{plain};
+    indexed.indexIncomingEdges();
+
+    while (plain.vertexCount() > 0)
+    {
+        int vertex = plain.vertices()[random() % plain.vertexCount()];
+        plain.removeVertex(vertex);
+        indexed.removeVertex(vertex);
+
+        ASSERT_EQ(plain.edges(), indexed.edges());
+        ASSERT_EQ(plain.edgeCount(), indexed.edgeCount());
+        ASSERT_EQ(static_cast<int>(plain.edges().size()), indexed.edgeCount());
+
+        for (int v : plain.vertices())
+        {
+            std::vector<std::pair<int, int>> expected = plain.incomingEdges(v);
+            std::vector<std::pair<int, int>> actual = indexed.incomingEdges(v);
+            std::sort(expected.begin(), expected.end());
+            std::sort(actual.begin(), actual.end());
+            ASSERT_EQ(expected, actual);
+        }
+    }
+}
+
+
+namespace
+{
+    // A CountedInfo counts how many times any CountedInfo has been copied.
+    struct CountedInfo
+    {
+        static int copies;
+
+        explicit CountedInfo(std::string name)
+            : name{std::move(name)}
+        {
+        }
+
+        CountedInfo(const CountedInfo& c)
+            : name{c.name}
+        {
+            ++copies;
+        }
+
+        CountedInfo(CountedInfo&& c) = default;
+
+        std::string name;
+    };
+
+    int CountedInfo::copies = 0;
+}
+
+
+TEST(Digraph_Tests, movesAndEmplacementsDontCopyInfo)
+{
+    CountedInfo::copies = 0;
+
+    Digraph<CountedInfo, CountedInfo> d;
+    d.emplaceVertex(1, "a");
+    d.addVertex(2, CountedInfo{"b"});
+    d.addVertices(std::vector<std::pair<int, CountedInfo>>{{3, CountedInfo{"c"}}});
+    d.emplaceEdge(1, 2, "1->2");
+    d.addEdge(2, 3, CountedInfo{"2->3"});
+
+    std::vector<std::tuple<int, int, CountedInfo>> edges;
+    edges.emplace_back(3, 1, CountedInfo{"3->1"});
+    d.addEdges(std::move(edges));
+
+    // The initializer list behind the vector of vertices is copied from;
+    // nothing else should be.
+    EXPECT_EQ(1, CountedInfo::copies);
+
+    Digraph<CountedInfo, CountedInfo> moved{std::move(d)};
+    Digraph<CountedInfo, CountedInfo> assigned;
+    assigned = std::move(moved);
+
+    EXPECT_EQ(1, CountedInfo::copies);
+    EXPECT_EQ(0, d.vertexCount());
+    EXPECT_EQ(0, moved.edgeCount());
+    EXPECT_EQ(3, assigned.edgeCount());
+    EXPECT_EQ("c", assigned.vertexInfo(3).name);
+    EXPECT_EQ("2->3", assigned.edgeInfo(2, 3).name);
+    EXPECT_TRUE(assigned.isStronglyConnected());
+
+    d.addVertex(1, CountedInfo{"reused"});
+    EXPECT_EQ(1, d.vertexCount());
+}
+
+
+TEST(Digraph_Tests, edgeViewsMatchEdgeVectors)
+{
+    Digraph<std::string, int> d;
+    d.addVertex(1, "a");
+    d.addVertex(2, "b");
+    d.addVertex(3, "c");
+    d.addVertex(4, "d");
+    d.addEdge(2, 1, 21);
+    d.addEdge(2, 4, 24);
+    d.addEdge(4, 4, 44);
+
+    std::vector<std::pair<int, int>> viewed;
+
+    for (const DigraphEdge<int>& edge : d.allEdges())
+    {
+        viewed.emplace_back(edge.fromVertex, edge.toVertex);
+        EXPECT_EQ(&d.edgeInfo(edge.fromVertex, edge.toVertex), &edge.einfo);
+    }
+
+    EXPECT_EQ(d.edges(), viewed);
+    EXPECT_EQ(3, d.allEdges().size());
+
+    DigraphEdgeRange<int> out = d.outEdges(2);
+    ASSERT_EQ(2, out.size());
+    EXPECT_EQ(21, out.begin()->einfo);
+    EXPECT_EQ(4, (out.begin() + 1)->toVertex);
+    EXPECT_TRUE(d.outEdges(3).empty());
+    EXPECT_THROW(d.outEdges(5), DigraphException);
+
+    EXPECT_EQ(&d.vertexInfo(3), &d.vertexInfo(3));
+
+    Digraph<std::string, int> empty;
+    EXPECT_TRUE(empty.allEdges().begin() == empty.allEdges().end());
+}
+
+
+namespace
+{
+    // A PickyInfo refuses to be constructed from a negative value.
+    struct PickyInfo
+    {
+        explicit PickyInfo(int value)
+            : value{value}
+        {
+            if (value < 0)
+            {
+                throw std::invalid_argument{"negative value"};
+            }
+        }
+
+        int value;
+    };
+}
+
+
+TEST(Digraph_Tests, failedVertexConstructionLeavesNoTrace)
+{
+    Digraph<PickyInfo, int> d;
+    d.emplaceVertex(10, 1);
+
+    EXPECT_THROW(d.emplaceVertex(20, -1), std::invalid_argument);
+    EXPECT_EQ(1, d.vertexCount());
+    EXPECT_THROW(d.vertexInfo(20), DigraphException);
+
+    // The vertex that failed must not share a slot with the next one.
+    d.emplaceVertex(30, 3);
+    d.emplaceVertex(20, 2);
+
+    EXPECT_EQ(3, d.vertexCount());
+    EXPECT_EQ(1, d.vertexInfo(10).value);
+    EXPECT_EQ(2, d.vertexInfo(20).value);
+    EXPECT_EQ(3, d.vertexInfo(30).value);
+
+    d.addEdge(20, 30, 23);
+    EXPECT_EQ(23, d.edgeInfo(20, 30));
+    EXPECT_EQ((std::vector<std::pair<int, int>>{{20, 30}}), d.edges());
+}
+
+
+TEST(Digraph_Tests, failedBulkVertexConstructionAddsNothing)
+{
+    Digraph<PickyInfo, int> d;
+    d.emplaceVertex(10, 1);
+
+    std::vector<std::pair<int, int>> vertices{{20, 2}, {30, 3}, {40, -4}, {50, 5}};
+
+    EXPECT_THROW(d.addVertices(vertices), std::invalid_argument);
+    EXPECT_EQ(1, d.vertexCount());
+    EXPECT_EQ(std::vector<int>{10}, d.vertices());
+
+    for (int vertex : {20, 30, 40, 50})
+    {
+        EXPECT_THROW(d.vertexInfo(vertex), DigraphException);
+    }
+
+    vertices[2].second = 4;
+    d.addVertices(vertices);
+
+    EXPECT_EQ(5, d.vertexCount());
+
+    for (int vertex : {10, 20, 30, 40, 50})
+    {
+        EXPECT_EQ(vertex / 10, d.vertexInfo(vertex).value);
+    }
+}
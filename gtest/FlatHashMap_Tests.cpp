@@ -0,0 +1,83 @@
+// FlatHashMap_Tests.cpp
+//
+// ICS 46 Spring 2016
+// Project #4: Rock and Roll Stops the Traffic
+//
+// Unit tests for FlatHashMap, including a long run of random insertions and
+// erasures checked against std::unordered_map, which exercises the shifting
+// of entries back into the holes erasures leave.
+
+#include <gtest/gtest.h>
+#include <random>
+#include <unordered_map>
+#include "FlatHashMap.hpp"
+
+
+TEST(FlatHashMap_Tests, insertsFindsAndErases)
+{
+    FlatHashMap<int, int> m;
+    EXPECT_TRUE(m.empty());
+    EXPECT_EQ(nullptr, m.find(3));
+    EXPECT_FALSE(m.erase(3));
+
+    EXPECT_TRUE(m.insert(3, 30));
+    EXPECT_TRUE(m.insert(-7, 70));
+    EXPECT_FALSE(m.insert(3, 31));
+
+    EXPECT_EQ(2u, m.size());
+    ASSERT_NE(nullptr, m.find(3));
+    EXPECT_EQ(30, *m.find(3));
+
+    *m.find(-7) = 71;
+    EXPECT_EQ(71, *m.find(-7));
+
+    EXPECT_TRUE(m.erase(3));
+    EXPECT_FALSE(m.contains(3));
+    EXPECT_TRUE(m.contains(-7));
+
+    m.clear();
+    EXPECT_TRUE(m.empty());
+    EXPECT_FALSE(m.contains(-7));
+}
+
+
+TEST(FlatHashMap_Tests, agreesWithUnorderedMapUnderChurn)
+{
+    std::mt19937 random{46};
+    std::uniform_int_distribution<int> keys{-500, 500};
+
+    FlatHashMap<int, int> m;
+    std::unordered_map<int, int> expected;
+
+    for (int step = 0; step < 100000; ++step)
+    {
+        int key = keys(random);
+
+        if (random() % 2 == 0)
+        {
+            EXPECT_EQ(expected.emplace(key, step).second, m.insert(key, step));
+        }
+        else
+        {
+            EXPECT_EQ(expected.erase(key) > 0, m.erase(key));
+        }
+    }
+
+    EXPECT_EQ(expected.size(), m.size());
+
+    for (int key = -500; key <= 500; ++key)
+    {
+        auto found = expected.find(key);
+
+        if (found == expected.end())
+        {
+            EXPECT_EQ(nullptr, m.find(key));
+        }
+        else
+        {
+            ASSERT_NE(nullptr, m.find(key));
+            EXPECT_EQ(found->second, *m.find(key));
+        }
+    }
+}
+
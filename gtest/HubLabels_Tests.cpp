@@ -0,0 +1,122 @@
+// HubLabels_Tests.cpp
+//
+// ICS 46 Spring 2016
+// Project #4: Rock and Roll Stops the Traffic
+//
+// Unit tests for HubLabels, checking their distances against a
+// ShortestPathSearch on randomly generated graphs, with an arbitrary
+// vertex order and with the order of a ContractionHierarchy, and checking
+// that labels rebuilt from their arrays answer the same way.
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+#include "ContractionHierarchy.hpp"
+#include "Digraph.hpp"
+#include "HubLabels.hpp"
+#include "RandomGraphs.hpp"
+#include "ShortestPathSearch.hpp"
+
+
+namespace
+{
+    void expectSameAsDijkstra(const CompactDigraph<int, double>& c, const HubLabels& labels)
+    {
+        labels.verify();
+
+        ShortestPathSearch dijkstra;
+
+        for (int start = 0; start < c.vertexCount(); ++start)
+        {
+            dijkstra.run(c, start, identity);
+
+            for (int end = 0; end < c.vertexCount(); ++end)
+            {
+                EXPECT_DOUBLE_EQ(dijkstra.distance(end), labels.distance(start, end));
+            }
+        }
+    }
+}
+
+
+TEST(HubLabels_Tests, distancesMatchDijkstra)
+{
+    for (unsigned seed = 1; seed <= 3; ++seed)
+    {
+        CompactDigraph<int, double> c = makeRandomGrid(9, seed, 0.15);
+
+        std::vector<int> shuffled(c.vertexCount());
+
+        for (int v = 0; v < c.vertexCount(); ++v)
+        {
+            shuffled[v] = v;
+        }
+
+        std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937{seed});
+
+        expectSameAsDijkstra(c, HubLabels::build(c, identity, shuffled));
+        std::vector<int> ranked = ContractionHierarchy::build(c, identity, 1).order();
+        expectSameAsDijkstra(c, HubLabels::build(c, identity, ranked));
+    }
+}
+
+
+TEST(HubLabels_Tests, hierarchyOrderGivesShortLabels)
+{
+    CompactDigraph<int, double> c = makeRandomGrid(30, 5, 0.15);
+
+    std::vector<int> byIndex(c.vertexCount());
+
+    for (int v = 0; v < c.vertexCount(); ++v)
+    {
+        byIndex[v] = v;
+    }
+
+    HubLabels plain = HubLabels::build(c, identity, byIndex);
+    HubLabels ranked = HubLabels::build(
+        c, identity, ContractionHierarchy::build(c, identity).order());
+
+    EXPECT_LT(ranked.entryCount() * 2, plain.entryCount());
+
+    // Most hubs take a single byte.
+    EXPECT_LT(ranked.forwardArrays().hubBytes.size(), ranked.forwardArrays().distances.size() * 3 / 2);
+}
+
+
+TEST(HubLabels_Tests, rebuildsFromArraysAndRejectsBadOnes)
+{
+    CompactDigraph<int, double> c = makeRandomGrid(6, 9, 0.15);
+    std::vector<int> order = ContractionHierarchy::build(c, identity).order();
+    HubLabels labels = HubLabels::build(c, identity, order);
+
+    HubLabels copy{labels.forwardArrays(), labels.backwardArrays()};
+    EXPECT_EQ(labels.entryCount(), copy.entryCount());
+    expectSameAsDijkstra(c, copy);
+
+    // A hub byte whose continuation bit is set runs into the next hub.
+    // Corrupt labels whose arrays' sizes still agree are loaded, and only
+    // verify() notices.
+    HubLabelArrays corrupt = labels.forwardArrays();
+    corrupt.hubBytes.mutableAt(0) |= 0x80;
+    EXPECT_THROW((HubLabels{corrupt, labels.backwardArrays()}.verify()), DigraphException);
+
+    corrupt = labels.forwardArrays();
+    corrupt.distances.mutableAt(0) = -1.0;
+    EXPECT_THROW((HubLabels{corrupt, labels.backwardArrays()}.verify()), DigraphException);
+
+    // A label whose offsets lie outside the arrays is noticed by a query
+    // that reads it, too.
+    corrupt = labels.forwardArrays();
+    corrupt.labelOffsets.mutableAt(1) = corrupt.distances.size() + 1;
+    HubLabels outside{corrupt, labels.backwardArrays()};
+    EXPECT_THROW(outside.verify(), DigraphException);
+    EXPECT_THROW(outside.distance(0, 1), DigraphException);
+    EXPECT_EQ(labels.distance(2, 0), outside.distance(2, 0));
+
+    EXPECT_THROW((HubLabels{labels.forwardArrays(), HubLabelArrays{}}), DigraphException);
+
+    order.back() = order.front();
+    EXPECT_THROW(HubLabels::build(c, identity, order), DigraphException);
+}
+
@@ -0,0 +1,104 @@
+// IndexedDaryHeap_Tests.cpp
+//
+// ICS 46 Spring 2016
+// Project #4: Rock and Roll Stops the Traffic
+//
+// Unit tests for IndexedDaryHeap.
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+#include "IndexedDaryHeap.hpp"
+
+
+TEST(IndexedDaryHeap_Tests, popsItemsInKeyOrder)
+{
+    IndexedDaryHeap<4> heap;
+    heap.reserveItems(6);
+    heap.push(3, 3.0);
+    heap.push(0, 5.0);
+    heap.push(5, 1.0);
+    heap.push(1, 4.0);
+
+    EXPECT_EQ(4, heap.size());
+    EXPECT_EQ(5, heap.pop());
+    EXPECT_EQ(3, heap.pop());
+    EXPECT_EQ(1, heap.pop());
+    EXPECT_EQ(0, heap.pop());
+    EXPECT_TRUE(heap.empty());
+}
+
+
+TEST(IndexedDaryHeap_Tests, decreasingAKeyMovesTheItemUp)
+{
+    IndexedDaryHeap<4> heap;
+    heap.reserveItems(3);
+    heap.push(0, 10.0);
+    heap.push(1, 20.0);
+    heap.push(2, 30.0);
+
+    EXPECT_TRUE(heap.pushOrDecrease(2, 5.0));
+    EXPECT_FALSE(heap.pushOrDecrease(1, 25.0));
+    EXPECT_EQ(2, heap.top());
+    EXPECT_EQ(5.0, heap.topKey());
+    EXPECT_EQ(3, heap.size());
+}
+
+
+TEST(IndexedDaryHeap_Tests, clearForgetsAllItems)
+{
+    IndexedDaryHeap<4> heap;
+    heap.reserveItems(2);
+    heap.push(0, 1.0);
+    heap.push(1, 2.0);
+    heap.clear();
+
+    EXPECT_TRUE(heap.empty());
+    EXPECT_FALSE(heap.contains(0));
+    EXPECT_FALSE(heap.contains(1));
+}
+
+
+TEST(IndexedDaryHeap_Tests, agreesWithSortingOnRandomOperations)
+{
+    std::mt19937 random{46};
+    std::uniform_real_distribution<double> keys{0.0, 1000.0};
+
+    IndexedDaryHeap<4> heap;
+    heap.reserveItems(500);
+    std::vector<double> current(500, -1.0);
+
+    for (int i = 0; i < 2000; ++i)
+    {
+        int item = random() % 500;
+        double key = keys(random);
+
+        if (current[item] < 0.0 || key < current[item])
+        {
+            current[item] = key;
+        }
+
+        heap.pushOrDecrease(item, key);
+    }
+
+    std::vector<double> expected;
+
+    for (double key : current)
+    {
+        if (key >= 0.0)
+        {
+            expected.push_back(key);
+        }
+    }
+
+    std::sort(expected.begin(), expected.end());
+
+    for (double key : expected)
+    {
+        ASSERT_EQ(key, heap.topKey());
+        heap.pop();
+    }
+
+    EXPECT_TRUE(heap.empty());
+}
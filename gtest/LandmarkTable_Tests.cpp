@@ -0,0 +1,123 @@
+// LandmarkTable_Tests.cpp
+//
+// ICS 46 Spring 2016
+// Project #4: Rock and Roll Stops the Traffic
+//
+// Unit tests for LandmarkTable, checking that its bounds never exceed the
+// true distances and never break consistency, that an A* search guided by
+// them finds the same paths as Dijkstra's algorithm while settling fewer
+// vertices, and that a table rebuilt from its arrays bounds the same way.
+
+#include <gtest/gtest.h>
+#include <vector>
+#include "Digraph.hpp"
+#include "LandmarkTable.hpp"
+#include "RandomGraphs.hpp"
+#include "ShortestPathSearch.hpp"
+
+
+TEST(LandmarkTable_Tests, boundsAreConsistentLowerBounds)
+{
+    CompactDigraph<int, double> c = makeRandomGrid(12, 3);
+
+    for (LandmarkSelection selection : {LandmarkSelection::Farthest, LandmarkSelection::Avoid})
+    {
+        LandmarkTable table = LandmarkTable::build(c, identity, 6, selection);
+        ASSERT_EQ(6, table.landmarkCount());
+        table.verify();
+
+        ShortestPathSearch search;
+
+        for (int target = 0; target < c.vertexCount(); target += 5)
+        {
+            search.run(c, target, identity);
+
+            for (int v = 0; v < c.vertexCount(); ++v)
+            {
+                // The bound from the target to any vertex can't exceed
+                // the distance between them.
+                EXPECT_LE(table.lowerBound(target, v), search.distance(v) + 1e-9);
+
+                c.forEachOutEdge(
+                    v,
+                    [&](int w, double weight)
+                    {
+                        EXPECT_LE(
+                            table.lowerBound(v, target),
+                            weight + table.lowerBound(w, target) + 1e-9);
+                    });
+            }
+        }
+    }
+}
+
+
+TEST(LandmarkTable_Tests, guidedSearchesMatchDijkstraAndSettleFewerVertices)
+{
+    CompactDigraph<int, double> c = makeRandomGrid(30, 7);
+    LandmarkTable table = LandmarkTable::build(c, identity, 8);
+
+    ShortestPathSearch dijkstra;
+    ShortestPathSearch guided;
+
+    int dijkstraSettled = 0;
+    int guidedSettled = 0;
+
+    for (int i = 0; i < 20; ++i)
+    {
+        int start = i * 41 % c.vertexCount();
+        int target = c.vertexCount() - 1 - i * 67 % c.vertexCount();
+
+        dijkstra.run(c, start, identity, target);
+        guided.runToward(c, start, target, identity, LandmarkTable::Bound{table, target});
+
+        EXPECT_DOUBLE_EQ(dijkstra.distance(target), guided.distance(target));
+        EXPECT_EQ(
+            dijkstra.pathTo<double>(c, target).vertices,
+            guided.pathTo<double>(c, target).vertices);
+
+        dijkstraSettled += dijkstra.settledCount();
+        guidedSettled += guided.settledCount();
+    }
+
+    EXPECT_LT(guidedSettled * 3, dijkstraSettled);
+}
+
+
+TEST(LandmarkTable_Tests, rebuildsFromArraysAndRejectsBadOnes)
+{
+    CompactDigraph<int, double> c = makeRandomGrid(8, 11);
+    LandmarkTable table = LandmarkTable::build(c, identity, 4, LandmarkSelection::Farthest);
+
+    LandmarkTable copy{
+        table.vertexCount(), table.landmarkArray(),
+        table.fromLandmarkArray(), table.toLandmarkArray()};
+
+    copy.verify();
+
+    for (int v = 0; v < c.vertexCount(); ++v)
+    {
+        EXPECT_EQ(table.lowerBound(v, 0), copy.lowerBound(v, 0));
+        EXPECT_EQ(table.lowerBound(v, 0) / 2, (LandmarkTable::Bound{copy, 0, 0.5}(v)));
+    }
+
+    std::vector<double> negative(table.fromLandmarkArray().begin(), table.fromLandmarkArray().end());
+    negative[5] = -1.0;
+
+    // The arrays' sizes still agree, so only verify() notices.
+    LandmarkTable broken{table.vertexCount(), table.landmarkArray(), negative, table.toLandmarkArray()};
+    EXPECT_THROW(broken.verify(), DigraphException);
+
+    EXPECT_THROW(
+        (LandmarkTable{
+            table.vertexCount() + 1, table.landmarkArray(),
+            table.fromLandmarkArray(), table.toLandmarkArray()}),
+        DigraphException);
+
+    EXPECT_THROW(
+        (LandmarkTable{
+            table.vertexCount(), std::vector<int>{0, 1, 2, table.vertexCount()},
+            table.fromLandmarkArray(), table.toLandmarkArray()}),
+        DigraphException);
+}
+
@@ -0,0 +1,70 @@
+// MonotonicArena_Tests.cpp
+//
+// ICS 46 Spring 2016
+// Project #4: Rock and Roll Stops the Traffic
+//
+// Unit tests for MonotonicArena and ArenaAllocator, including a Digraph
+// built entirely in an arena.
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <string>
+#include "Digraph.hpp"
+#include "MonotonicArena.hpp"
+
+
+TEST(MonotonicArena_Tests, allocationsAreAlignedAndReleasedTogether)
+{
+    MonotonicArena arena{256};
+
+    void* a = arena.allocate(3, 1);
+    void* b = arena.allocate(8, 8);
+    void* large = arena.allocate(1000, 16);
+
+    EXPECT_NE(a, b);
+    EXPECT_EQ(0u, reinterpret_cast<std::uintptr_t>(b) % 8);
+    EXPECT_EQ(0u, reinterpret_cast<std::uintptr_t>(large) % 16);
+    EXPECT_GE(arena.bytesAllocated(), 1256u);
+
+    arena.release();
+    EXPECT_EQ(0u, arena.bytesAllocated());
+
+    arena.allocate(8, 8);
+    EXPECT_EQ(256u, arena.bytesAllocated());
+}
+
+
+TEST(MonotonicArena_Tests, digraphCanBeBuiltInAnArena)
+{
+    MonotonicArena arena;
+    ArenaAllocator<char> allocator{arena};
+
+    {
+        Digraph<std::string, double, ArenaAllocator<char>> d{allocator};
+
+        for (int v = 0; v < 100; ++v)
+        {
+            d.addVertex(v, "vertex " + std::to_string(v));
+        }
+
+        for (int v = 1; v < 100; ++v)
+        {
+            d.addEdge(0, v, v * 1.5);
+            d.addEdge(v, 0, v * 2.0);
+        }
+
+        EXPECT_GT(arena.bytesAllocated(), 0u);
+
+        Digraph<std::string, double, ArenaAllocator<char>> copy{d};
+        d.removeVertex(0);
+
+        EXPECT_EQ(198, copy.edgeCount());
+        EXPECT_EQ(0, d.edgeCount());
+        EXPECT_EQ(148.5, copy.edgeInfo(0, 99));
+        EXPECT_EQ("vertex 99", d.vertexInfo(99));
+        EXPECT_TRUE(copy.isStronglyConnected());
+    }
+
+    arena.release();
+    EXPECT_EQ(0u, arena.bytesAllocated());
+}
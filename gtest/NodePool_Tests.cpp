@@ -0,0 +1,66 @@
+// NodePool_Tests.cpp
+//
+// ICS 46 Spring 2016
+// Project #4: Rock and Roll Stops the Traffic
+//
+// Unit tests for NodePool and PoolAllocator, including a Digraph whose
+// edges are added and removed over and over in a pool.
+
+#include <gtest/gtest.h>
+#include <string>
+#include "Digraph.hpp"
+#include "NodePool.hpp"
+
+
+TEST(NodePool_Tests, freedNodesAreReused)
+{
+    NodePool pool{20, 4};
+    EXPECT_EQ(0u, pool.nodeSize() % alignof(std::max_align_t));
+    EXPECT_GE(pool.nodeSize(), 20u);
+
+    void* a = pool.allocate();
+    void* b = pool.allocate();
+    EXPECT_NE(a, b);
+
+    pool.deallocate(a);
+    EXPECT_EQ(a, pool.allocate());
+
+    PoolAllocator<int> allocator{pool};
+    int* small = allocator.allocate(2);
+    int* large = allocator.allocate(100);
+    allocator.deallocate(small, 2);
+    allocator.deallocate(large, 100);
+    EXPECT_EQ(small, allocator.allocate(1));
+}
+
+
+TEST(NodePool_Tests, digraphCanChurnInAPool)
+{
+    NodePool pool{256};
+    Digraph<std::string, int, PoolAllocator<char>> d{PoolAllocator<char>{pool}};
+    d.indexIncomingEdges();
+
+    for (int v = 0; v < 20; ++v)
+    {
+        d.addVertex(v, "v");
+    }
+
+    for (int round = 0; round < 50; ++round)
+    {
+        for (int v = 1; v < 20; ++v)
+        {
+            d.addEdge(0, v, round);
+        }
+
+        EXPECT_EQ(19, d.edgeCount(0));
+        EXPECT_EQ(round, d.edgeInfo(0, 19));
+
+        for (int v = 1; v < 20; ++v)
+        {
+            d.removeEdge(0, v);
+        }
+    }
+
+    EXPECT_EQ(0, d.edgeCount());
+    EXPECT_TRUE(d.incomingEdges(19).empty());
+}
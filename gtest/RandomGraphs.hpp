@@ -0,0 +1,126 @@
+// RandomGraphs.hpp
+//
+// ICS 46 Spring 2016
+// Project #4: Rock and Roll Stops the Traffic
+//
+// The randomly generated graphs that the unit tests check the search
+// algorithms on, along with the weight function they're searched with.
+// Each graph's edge infos are its weights, and each vertex's info is its
+// index, while its vertex number is not, so that a test confusing the two
+// fails.
+
+#ifndef RANDOMGRAPHS_HPP
+#define RANDOMGRAPHS_HPP
+
+#include <random>
+#include "CompactDigraph.hpp"
+#include "Digraph.hpp"
+#include "DigraphException.hpp"
+
+
+
+// makeRandomGraph() builds a graph with the given number of vertices and
+// about the given number of edges, each between two random vertices, so
+// some vertices may not be reachable from others.
+
+inline Digraph<int, double> makeRandomGraph(int vertexCount, int edgeCount, unsigned seed)
+{
+    std::mt19937 random{seed};
+    std::uniform_real_distribution<double> weights{0.0, 10.0};
+
+    Digraph<int, double> d;
+
+    for (int v = 0; v < vertexCount; ++v)
+    {
+        d.addVertex(v * 3 + 7, v);
+    }
+
+    for (int e = 0; e < edgeCount; ++e)
+    {
+        int from = (random() % vertexCount) * 3 + 7;
+        int to = (random() % vertexCount) * 3 + 7;
+
+        try
+        {
+            d.addEdge(from, to, weights(random));
+        }
+        catch (DigraphException&)
+        {
+            // duplicate edges are simply skipped
+        }
+    }
+
+    return d;
+}
+
+
+// makeRandomGrid() builds a grid with roads between neighbors, some of
+// them missing, which resembles a road map more than a graph with random
+// edges does.  Each road present runs in both directions, except that it
+// runs in only one with the given probability.  The incoming edges of
+// the grid are indexed.
+
+inline CompactDigraph<int, double> makeRandomGrid(
+    int size, unsigned seed, double oneWayProbability = 0.0)
+{
+    std::mt19937 random{seed};
+    std::uniform_real_distribution<double> weights{1.0, 10.0};
+    std::bernoulli_distribution missing{0.1};
+    std::bernoulli_distribution oneWay{oneWayProbability};
+
+    Digraph<int, double> d;
+
+    for (int v = 0; v < size * size; ++v)
+    {
+        d.addVertex(v * 2 + 1, v);
+    }
+
+    auto addRoad =
+        [&](int v, int w)
+        {
+            if (missing(random))
+            {
+                return;
+            }
+
+            d.addEdge(v, w, weights(random));
+
+            if (!oneWay(random))
+            {
+                d.addEdge(w, v, weights(random));
+            }
+        };
+
+    for (int row = 0; row < size; ++row)
+    {
+        for (int column = 0; column < size; ++column)
+        {
+            int v = (row * size + column) * 2 + 1;
+
+            if (column + 1 < size)
+            {
+                addRoad(v, v + 2);
+            }
+
+            if (row + 1 < size)
+            {
+                addRoad(v + size * 2, v);
+            }
+        }
+    }
+
+    CompactDigraph<int, double> c = d.freeze();
+    c.indexIncomingEdges();
+    return c;
+}
+
+
+inline double identity(const double& weight)
+{
+    return weight;
+}
+
+
+
+#endif // RANDOMGRAPHS_HPP
+
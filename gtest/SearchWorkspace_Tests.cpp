@@ -0,0 +1,82 @@
+// SearchWorkspace_Tests.cpp
+//
+// ICS 46 Spring 2016
+// Project #4: Rock and Roll Stops the Traffic
+//
+// Unit tests for SearchWorkspace, checking that reset() forgets earlier
+// searches without rewriting their entries, and that searches sharing one
+// workspace get the same answers as searches that each have their own.
+
+#include <gtest/gtest.h>
+#include <limits>
+#include <string>
+#include "Digraph.hpp"
+#include "SearchWorkspace.hpp"
+
+
+TEST(SearchWorkspace_Tests, resetForgetsEveryEntry)
+{
+    SearchWorkspace w;
+    w.reset(4);
+
+    EXPECT_FALSE(w.touched(2));
+    EXPECT_EQ(std::numeric_limits<double>::infinity(), w.distance(2));
+    EXPECT_EQ(-1, w.predecessor(2));
+
+    w.setEntry(2, 1.5, 0);
+    EXPECT_TRUE(w.touched(2));
+    EXPECT_EQ(1.5, w.distance(2));
+    EXPECT_EQ(0, w.predecessor(2));
+
+    w.heap().push(2, 1.5);
+    w.reset(3);
+
+    EXPECT_EQ(3, w.vertexCount());
+    EXPECT_FALSE(w.touched(2));
+    EXPECT_EQ(-1, w.predecessor(2));
+    EXPECT_TRUE(w.heap().empty());
+
+    w.reset(10);
+    w.setEntry(9, 2.0, 8);
+    EXPECT_EQ(2.0, w.distance(9));
+}
+
+
+TEST(SearchWorkspace_Tests, sharedWorkspaceGivesSameAnswersAsFreshOnes)
+{
+    Digraph<std::string, double> d;
+
+    for (int v = 1; v <= 6; ++v)
+    {
+        d.addVertex(v, std::to_string(v));
+    }
+
+    d.addEdge(1, 2, 1.0);
+    d.addEdge(2, 3, 1.0);
+    d.addEdge(1, 3, 3.0);
+    d.addEdge(3, 4, 2.0);
+    d.addEdge(4, 5, 1.0);
+    d.addEdge(2, 5, 9.0);
+
+    auto identity = [](const double& w) { return w; };
+
+    SearchWorkspace shared;
+
+    for (int start = 1; start <= 6; ++start)
+    {
+        for (int end = 1; end <= 6; ++end)
+        {
+            ShortestPath<double> fresh = d.findShortestPath(start, end, identity);
+            ShortestPath<double> reused = d.findShortestPath(start, end, identity, shared);
+
+            EXPECT_EQ(fresh.vertices, reused.vertices);
+            EXPECT_EQ(fresh.edges, reused.edges);
+            EXPECT_EQ(fresh.totalCost, reused.totalCost);
+        }
+    }
+
+    ShortestPathSearch search{shared};
+    search.run(d, d.toIndex(1), identity);
+    EXPECT_EQ(d.findShortestPaths(1, identity), search.predecessorMap(d));
+}
+
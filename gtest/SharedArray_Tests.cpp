@@ -0,0 +1,92 @@
+// SharedArray_Tests.cpp
+//
+// ICS 46 Spring 2016
+// Project #4: Rock and Roll Stops the Traffic
+//
+// Unit tests for SharedArray, and for CompactDigraphs built on borrowed
+// arrays, which is how binary road maps are loaded.
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "CompactDigraph.hpp"
+#include "SharedArray.hpp"
+
+
+TEST(SharedArray_Tests, ownedArraysCopyTheirElements)
+{
+    SharedArray<int> a{std::vector<int>{1, 2, 3}};
+    SharedArray<int> b{a};
+
+    b.mutableAt(0) = 10;
+
+    EXPECT_FALSE(a.borrowed());
+    EXPECT_EQ(1, a[0]);
+    EXPECT_EQ(10, b[0]);
+    EXPECT_EQ(3u, b.size());
+    EXPECT_NE(a.data(), b.data());
+}
+
+
+TEST(SharedArray_Tests, borrowedArraysKeepTheirOwnerAliveAndCopyOnWrite)
+{
+    std::shared_ptr<std::vector<int>> memory =
+        std::make_shared<std::vector<int>>(std::vector<int>{4, 5, 6});
+
+    SharedArray<int> a{memory->data(), memory->size(), memory};
+    std::weak_ptr<std::vector<int>> watch = memory;
+    memory.reset();
+
+    EXPECT_FALSE(watch.expired());
+    EXPECT_TRUE(a.borrowed());
+    EXPECT_EQ(5, a[1]);
+
+    SharedArray<int> b = a;
+    EXPECT_EQ(a.data(), b.data());
+
+    b.mutableAt(1) = 50;
+    EXPECT_FALSE(b.borrowed());
+    EXPECT_EQ(5, a[1]);
+    EXPECT_EQ(50, b[1]);
+
+    a = SharedArray<int>{};
+    EXPECT_TRUE(watch.expired());
+    EXPECT_EQ(6, b.back());
+}
+
+
+TEST(SharedArray_Tests, compactDigraphCanBorrowItsArrays)
+{
+    // 10 -> 20 -> 30, laid out the way a file would hold it
+
+    std::shared_ptr<std::vector<int>> memory =
+        std::make_shared<std::vector<int>>(std::vector<int>{10, 20, 30, 0, 1, 2, 2, 1, 2});
+
+    const int* data = memory->data();
+
+    CompactDigraph<std::string, int> c{
+        SharedArray<int>{data, 3, memory},
+        std::vector<std::string>{"ten", "twenty", "thirty"},
+        SharedArray<int>{data + 3, 4, memory},
+        SharedArray<int>{data + 7, 2, memory},
+        std::vector<int>{12, 23}};
+
+    EXPECT_EQ(2, c.edgeCount());
+    EXPECT_EQ(23, c.edgeInfo(20, 30));
+    EXPECT_EQ(
+        (std::vector<int>{10, 20, 30}),
+        c.findShortestPath(10, 30, [](int w) { return w; }).vertices);
+
+    SharedArray<int> badOffsets{std::vector<int>{0, 2, 1, 2}};
+
+    EXPECT_THROW(
+        (CompactDigraph<std::string, int>{
+            SharedArray<int>{data, 3, memory},
+            std::vector<std::string>{"ten", "twenty", "thirty"},
+            badOffsets,
+            SharedArray<int>{data + 7, 2, memory},
+            std::vector<int>{12, 23}}),
+        DigraphException);
+}
+
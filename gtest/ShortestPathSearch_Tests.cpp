@@ -0,0 +1,211 @@
+// ShortestPathSearch_Tests.cpp
+//
+// ICS 46 Spring 2016
+// Project #4: Rock and Roll Stops the Traffic
+//
+// Unit tests for ShortestPathSearch, checking its distances against a
+// brute-force Bellman-Ford on randomly generated graphs, both directly on
+// a Digraph and on its frozen CompactDigraph, and checking that an A*
+// search with a consistent heuristic agrees with them.
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+#include <random>
+#include <vector>
+#include "Digraph.hpp"
+#include "RandomGraphs.hpp"
+#include "ShortestPathSearch.hpp"
+
+
+namespace
+{
+    std::vector<double> bellmanFord(const Digraph<int, double>& d, int startVertex)
+    {
+        std::vector<double> distance(
+            d.vertexCount(), std::numeric_limits<double>::infinity());
+
+        distance[d.toIndex(startVertex)] = 0.0;
+
+        for (int round = 0; round < d.vertexCount(); ++round)
+        {
+            for (const std::pair<int, int>& edge : d.edges())
+            {
+                int from = d.toIndex(edge.first);
+                int to = d.toIndex(edge.second);
+                double candidate = distance[from] + d.edgeInfo(edge.first, edge.second);
+
+                if (candidate < distance[to])
+                {
+                    distance[to] = candidate;
+                }
+            }
+        }
+
+        return distance;
+    }
+}
+
+
+TEST(ShortestPathSearch_Tests, distancesMatchBellmanFord)
+{
+    for (unsigned seed = 1; seed <= 10; ++seed)
+    {
+        Digraph<int, double> d = makeRandomGraph(60, 240, seed);
+        CompactDigraph<int, double> c = d.freeze();
+        std::vector<double> expected = bellmanFord(d, 7);
+
+        ShortestPathSearch onDigraph;
+        onDigraph.run(d, d.toIndex(7), identity);
+
+        ShortestPathSearch onCompact;
+        onCompact.run(c, c.toIndex(7), identity);
+
+        for (int i = 0; i < d.vertexCount(); ++i)
+        {
+            EXPECT_DOUBLE_EQ(expected[i], onDigraph.distance(i));
+            EXPECT_DOUBLE_EQ(expected[i], onCompact.distance(i));
+            EXPECT_EQ(expected[i] < std::numeric_limits<double>::infinity(), onDigraph.reached(i));
+        }
+    }
+}
+
+
+TEST(ShortestPathSearch_Tests, predecessorsFormShortestPaths)
+{
+    Digraph<int, double> d = makeRandomGraph(40, 160, 99);
+    std::vector<double> expected = bellmanFord(d, 7);
+    std::map<int, int> paths = d.findShortestPaths(7, identity);
+
+    for (const auto& path : paths)
+    {
+        int index = d.toIndex(path.first);
+
+        if (path.first == path.second)
+        {
+            EXPECT_TRUE(path.first == 7
+                || expected[index] == std::numeric_limits<double>::infinity());
+        }
+        else
+        {
+            double viaPredecessor =
+                expected[d.toIndex(path.second)] + d.edgeInfo(path.second, path.first);
+
+            EXPECT_DOUBLE_EQ(expected[index], viaPredecessor);
+        }
+    }
+}
+
+
+TEST(ShortestPathSearch_Tests, stoppingAtTargetSettlesFewerVertices)
+{
+    Digraph<int, double> d;
+
+    for (int v = 0; v < 100; ++v)
+    {
+        d.addVertex(v, v);
+    }
+
+    for (int v = 0; v < 99; ++v)
+    {
+        d.addEdge(v, v + 1, 1.0);
+    }
+
+    ShortestPathSearch search;
+    search.run(d, d.toIndex(0), identity, d.toIndex(3));
+
+    EXPECT_EQ(4, search.settledCount());
+    EXPECT_DOUBLE_EQ(3.0, search.distance(d.toIndex(3)));
+
+    ShortestPath<double> path = search.pathTo<double>(d, d.toIndex(3));
+    EXPECT_EQ((std::vector<int>{0, 1, 2, 3}), path.vertices);
+}
+
+
+TEST(ShortestPathSearch_Tests, runUntilStopsWhenAskedTo)
+{
+    Digraph<int, double> d = makeRandomGraph(60, 240, 5);
+    std::vector<double> expected = bellmanFord(d, 7);
+
+    std::vector<int> targets{d.toIndex(10), d.toIndex(40), d.toIndex(91)};
+    int remaining = static_cast<int>(targets.size());
+
+    ShortestPathSearch search;
+    search.runUntil(
+        d, d.toIndex(7), identity,
+        [&](int settled)
+        {
+            if (std::find(targets.begin(), targets.end(), settled) != targets.end())
+            {
+                --remaining;
+            }
+
+            return remaining == 0;
+        });
+
+    for (int target : targets)
+    {
+        EXPECT_DOUBLE_EQ(expected[target], search.distance(target));
+    }
+
+    EXPECT_LE(search.settledCount(), d.vertexCount());
+}
+
+
+TEST(ShortestPathSearch_Tests, runTowardAgreesWithRunAndSettlesFewerVertices)
+{
+    // The vertices form a 30-by-30 grid, with roads in both directions
+    // between neighbors, numbered row * 100 + column; every road is at
+    // least as long as the distance between its ends, so that distance
+    // is a consistent heuristic.
+    std::mt19937 random{17};
+    std::uniform_real_distribution<double> detours{1.0, 2.0};
+
+    Digraph<int, double> d;
+
+    for (int row = 0; row < 30; ++row)
+    {
+        for (int column = 0; column < 30; ++column)
+        {
+            d.addVertex(row * 100 + column, 0);
+
+            if (column > 0)
+            {
+                d.addEdge(row * 100 + column, row * 100 + column - 1, detours(random));
+                d.addEdge(row * 100 + column - 1, row * 100 + column, detours(random));
+            }
+
+            if (row > 0)
+            {
+                d.addEdge(row * 100 + column, (row - 1) * 100 + column, detours(random));
+                d.addEdge((row - 1) * 100 + column, row * 100 + column, detours(random));
+            }
+        }
+    }
+
+    int target = d.toIndex(2826);
+
+    auto manhattan =
+        [&](int index)
+        {
+            int vertex = d.toVertexNumber(index);
+            return std::abs(vertex / 100 - 28) + std::abs(vertex % 100 - 26) + 0.0;
+        };
+
+    ShortestPathSearch dijkstra;
+    dijkstra.run(d, d.toIndex(303), identity, target);
+
+    ShortestPathSearch aStar;
+    aStar.runToward(d, d.toIndex(303), target, identity, manhattan);
+
+    EXPECT_DOUBLE_EQ(dijkstra.distance(target), aStar.distance(target));
+    EXPECT_EQ(
+        dijkstra.pathTo<double>(d, target).vertices,
+        aStar.pathTo<double>(d, target).vertices);
+    EXPECT_LT(aStar.settledCount(), dijkstra.settledCount());
+
+    aStar.runToward(d, d.toIndex(303), target, identity, [](int) { return 0.0; });
+    EXPECT_EQ(dijkstra.settledCount(), aStar.settledCount());
+}
+
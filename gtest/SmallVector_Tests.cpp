@@ -0,0 +1,82 @@
+// SmallVector_Tests.cpp
+//
+// ICS 46 Spring 2016
+// Project #4: Rock and Roll Stops the Traffic
+//
+// Unit tests for SmallVector, checking that elements survive the move from
+// inline storage to a spilled array, and that copies and moves of both
+// kinds are independent of the original.
+
+#include <gtest/gtest.h>
+#include <string>
+#include <utility>
+#include <vector>
+#include "SmallVector.hpp"
+
+
+namespace
+{
+    std::vector<std::string> contents(const SmallVector<std::string, 2>& v)
+    {
+        return std::vector<std::string>(v.begin(), v.end());
+    }
+}
+
+
+TEST(SmallVector_Tests, spillsPastInlineCapacityAndErasesInOrder)
+{
+    SmallVector<std::string, 2> v;
+    v.push_back("a");
+    v.push_back("b");
+    EXPECT_TRUE(v.isInline());
+
+    v.emplace_back(3, 'c');
+    v.push_back(v[0]);
+    EXPECT_FALSE(v.isInline());
+    EXPECT_EQ((std::vector<std::string>{"a", "b", "ccc", "a"}), contents(v));
+
+    auto next = v.erase(v.begin() + 1);
+    EXPECT_EQ("ccc", *next);
+    v.erase(v.end() - 1);
+    EXPECT_EQ((std::vector<std::string>{"a", "ccc"}), contents(v));
+
+    v.clear();
+    EXPECT_TRUE(v.empty());
+}
+
+
+TEST(SmallVector_Tests, copiesAndMovesAreIndependent)
+{
+    SmallVector<std::string, 2> small;
+    small.push_back("x");
+
+    SmallVector<std::string, 2> large;
+
+    for (int i = 0; i < 5; ++i)
+    {
+        large.push_back(std::to_string(i));
+    }
+
+    SmallVector<std::string, 2> smallCopy{small};
+    SmallVector<std::string, 2> largeCopy;
+    largeCopy = large;
+    small.push_back("y");
+    large.erase(large.begin());
+
+    EXPECT_EQ((std::vector<std::string>{"x"}), contents(smallCopy));
+    EXPECT_EQ((std::vector<std::string>{"0", "1", "2", "3", "4"}), contents(largeCopy));
+
+    SmallVector<std::string, 2> smallMoved{std::move(small)};
+    SmallVector<std::string, 2> largeMoved;
+    largeMoved = std::move(large);
+
+    EXPECT_TRUE(small.empty());
+    EXPECT_TRUE(large.empty());
+    EXPECT_TRUE(smallMoved.isInline());
+    EXPECT_EQ((std::vector<std::string>{"x", "y"}), contents(smallMoved));
+    EXPECT_EQ((std::vector<std::string>{"1", "2", "3", "4"}), contents(largeMoved));
+
+    large.push_back("again");
+    EXPECT_EQ((std::vector<std::string>{"again"}), contents(large));
+}
+
@@ -0,0 +1,196 @@
+// StrongComponents_Tests.cpp
+//
+// ICS 46 Spring 2016
+// Project #4: Rock and Roll Stops the Traffic
+//
+// Unit tests for findStrongComponents(), including a check against
+// brute-force reachability on random graphs and a path long enough that a
+// recursive depth-first search would be in danger of overflowing.
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+#include "Digraph.hpp"
+#include "StrongComponents.hpp"
+
+
+namespace
+{
+    std::vector<bool> reachableFrom(const Digraph<int, int>& d, int startIndex)
+    {
+        std::vector<bool> reached(d.vertexCount(), false);
+        std::vector<int> stack{startIndex};
+        reached[startIndex] = true;
+
+        while (!stack.empty())
+        {
+            int v = stack.back();
+            stack.pop_back();
+
+            d.forEachOutEdge(
+                v,
+                [&](int w, const int&)
+                {
+                    if (!reached[w])
+                    {
+                        reached[w] = true;
+                        stack.push_back(w);
+                    }
+                });
+        }
+
+        return reached;
+    }
+}
+
+
+TEST(StrongComponents_Tests, findsComponentsInReverseTopologicalOrder)
+{
+    // 1 <-> 2 -> 3 <-> 4 -> 5, and 6 on its own
+
+    Digraph<std::string, int> d;
+
+    for (int v = 1; v <= 6; ++v)
+    {
+        d.addVertex(v, std::to_string(v));
+    }
+
+    d.addEdge(1, 2, 0);
+    d.addEdge(2, 1, 0);
+    d.addEdge(2, 3, 0);
+    d.addEdge(3, 4, 0);
+    d.addEdge(4, 3, 0);
+    d.addEdge(4, 5, 0);
+
+    StrongComponents sc = d.strongComponents();
+
+    EXPECT_EQ(4, sc.componentCount);
+    EXPECT_EQ(2, sc.largestSize);
+
+    auto component =
+        [&](int v)
+        {
+            return sc.componentOf[d.toIndex(v)];
+        };
+
+    EXPECT_EQ(component(1), component(2));
+    EXPECT_EQ(component(3), component(4));
+    EXPECT_NE(component(2), component(3));
+    EXPECT_GT(component(2), component(3));
+    EXPECT_GT(component(4), component(5));
+
+    EXPECT_FALSE(d.isStronglyConnected());
+    EXPECT_FALSE(d.freeze().isStronglyConnected());
+    EXPECT_EQ(sc.componentOf, d.freeze().strongComponents().componentOf);
+}
+
+
+TEST(StrongComponents_Tests, emptyGraphHasNoComponents)
+{
+    Digraph<std::string, int> d;
+    StrongComponents sc = d.strongComponents();
+
+    EXPECT_EQ(0, sc.componentCount);
+    EXPECT_EQ(-1, sc.largestComponent);
+    EXPECT_EQ(0, sc.largestSize);
+    EXPECT_FALSE(d.isStronglyConnected());
+}
+
+
+TEST(StrongComponents_Tests, agreesWithBruteForceReachability)
+{
+    for (unsigned seed = 1; seed <= 20; ++seed)
+    {
+        std::mt19937 random{seed};
+        Digraph<int, int> d;
+
+        for (int v = 0; v < 40; ++v)
+        {
+            d.addVertex(v, v);
+        }
+
+        for (int e = 0; e < 60; ++e)
+        {
+            int from = random() % 40;
+            int to = random() % 40;
+
+            if (from != to)
+            {
+                try
+                {
+                    d.addEdge(from, to, 0);
+                }
+                catch (DigraphException&)
+                {
+                    // duplicate edges are simply skipped
+                }
+            }
+        }
+
+        StrongComponents sc = d.strongComponents();
+
+        std::vector<std::vector<bool>> reach;
+
+        for (int v = 0; v < d.vertexCount(); ++v)
+        {
+            reach.push_back(reachableFrom(d, v));
+        }
+
+        int largest = 0;
+
+        for (int v = 0; v < d.vertexCount(); ++v)
+        {
+            int size = 0;
+
+            for (int w = 0; w < d.vertexCount(); ++w)
+            {
+                bool together = reach[v][w] && reach[w][v];
+                EXPECT_EQ(together, sc.componentOf[v] == sc.componentOf[w]);
+
+                if (together)
+                {
+                    ++size;
+                }
+            }
+
+            largest = std::max(largest, size);
+        }
+
+        EXPECT_EQ(largest, sc.largestSize);
+    }
+}
+
+
+TEST(StrongComponents_Tests, handlesVeryLongPathsWithoutRecursion)
+{
+    const int count = 200000;
+
+    std::vector<int> numbers(count);
+    std::vector<int> infos(count, 0);
+    std::vector<int> offsets(count + 1);
+    std::vector<int> targets;
+    std::vector<int> einfos;
+
+    // A path 0 -> 1 -> ... -> count - 1, with one edge back to 0, makes
+    // one component whose depth-first search goes count vertices deep.
+
+    for (int v = 0; v < count; ++v)
+    {
+        numbers[v] = v;
+        offsets[v] = v;
+        targets.push_back((v + 1) % count);
+        einfos.push_back(0);
+    }
+
+    offsets[count] = count;
+
+    CompactDigraph<int, int> c{numbers, infos, offsets, targets, einfos};
+
+    StrongComponents sc = c.strongComponents();
+    EXPECT_EQ(1, sc.componentCount);
+    EXPECT_EQ(count, sc.largestSize);
+    EXPECT_TRUE(c.isStronglyConnected());
+}
+
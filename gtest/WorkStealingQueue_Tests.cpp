@@ -0,0 +1,80 @@
+// WorkStealingQueue_Tests.cpp
+//
+// ICS 46 Spring 2016
+// Project #4: Rock and Roll Stops the Traffic
+//
+// Unit tests for WorkStealingQueue, including one where several threads
+// drain the same queue at once.
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "WorkStealingQueue.hpp"
+
+
+TEST(WorkStealingQueue_Tests, ownerPopsBackAndThievesStealFront)
+{
+    WorkStealingQueue<int> q;
+    q.push(1);
+    q.push(2);
+    q.push(3);
+
+    int task;
+
+    ASSERT_TRUE(q.pop(task));
+    EXPECT_EQ(3, task);
+    ASSERT_TRUE(q.steal(task));
+    EXPECT_EQ(1, task);
+    ASSERT_TRUE(q.pop(task));
+    EXPECT_EQ(2, task);
+
+    EXPECT_FALSE(q.pop(task));
+    EXPECT_FALSE(q.steal(task));
+}
+
+
+TEST(WorkStealingQueue_Tests, everyTaskIsTakenExactlyOnceAcrossThreads)
+{
+    const int taskCount = 10000;
+
+    WorkStealingQueue<int> q;
+
+    for (int i = 0; i < taskCount; ++i)
+    {
+        q.push(i);
+    }
+
+    std::vector<std::atomic<int>> taken(taskCount);
+
+    auto drain =
+        [&](bool owner)
+        {
+            int task;
+
+            while (owner ? q.pop(task) : q.steal(task))
+            {
+                ++taken[task];
+            }
+        };
+
+    std::vector<std::thread> thieves;
+
+    for (int i = 0; i < 3; ++i)
+    {
+        thieves.emplace_back(drain, false);
+    }
+
+    drain(true);
+
+    for (std::thread& thief : thieves)
+    {
+        thief.join();
+    }
+
+    for (int i = 0; i < taskCount; ++i)
+    {
+        EXPECT_EQ(1, taken[i].load());
+    }
+}
+